@@ -19,6 +19,7 @@
 
 #include <stdlib.h> 
 #include <memory.h>
+#include <string.h>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // CFFGLPluginManager constructor and destructor
@@ -31,34 +32,19 @@ CFFGLPluginManager::CFFGLPluginManager()
   m_timeSupported = 0;
 
 	m_NParams = 0;
-	m_pFirst = NULL;
-	m_pLast = NULL;
 }
 
 CFFGLPluginManager::~CFFGLPluginManager()
 {
-	if (m_pFirst != NULL)
-  {
-		ParamInfo* pCurr = m_pFirst;
-		ParamInfo* pNext = m_pFirst;
-
-		while (pCurr != NULL)
-    {
-			pNext = pCurr->pNext;
-
-			if ( (pCurr->dwType == FF_TYPE_TEXT) &&
-				 (pCurr->StrDefaultValue != NULL) )
-			{
-				free(pCurr->StrDefaultValue);
-			}
-
-			delete pCurr;
-			pCurr = pNext;
+	for (size_t i = 0; i < m_Params.size(); ++i)
+	{
+		if (m_Params[i].StrDefaultValue != NULL)
+		{
+			free(m_Params[i].StrDefaultValue);
 		}
 	}
 
-	m_pFirst = NULL;
-	m_pLast = NULL;
+	m_Params.clear();
 }
 
 
@@ -75,9 +61,29 @@ void CFFGLPluginManager::SetMaxInputs(unsigned int iMaxInputs)
 	m_iMaxInputs = iMaxInputs;
 }
 
-void CFFGLPluginManager::SetParamInfo(unsigned int pIndex, const char* pchName, unsigned int pType, float fDefaultValue)
+// Returns the slot for parameter pIndex, growing the table if needed, with the
+// common fields filled in. Registering the same index twice replaces the
+// previous definition.
+CFFGLPluginManager::ParamInfo* CFFGLPluginManager::AddParamInfo(unsigned int pIndex, const char* pchName, unsigned int pType)
 {
-	ParamInfo* pInfo = new ParamInfo;
+	if (pIndex >= m_Params.size())
+	{
+		ParamInfo empty;
+		memset(&empty, 0, sizeof(empty));
+		m_Params.resize(pIndex + 1, empty);
+	}
+
+	ParamInfo* pInfo = &m_Params[pIndex];
+
+	if (pInfo->bDefined)
+	{
+		if (pInfo->StrDefaultValue != NULL) free(pInfo->StrDefaultValue);
+	}
+	else
+	{
+		m_NParams++;
+	}
+
 	pInfo->ID = pIndex;
 
 #ifdef FFGL_EXT
@@ -92,116 +98,61 @@ void CFFGLPluginManager::SetParamInfo(unsigned int pIndex, const char* pchName,
 	}
 	
 	pInfo->dwType = pType;
+	pInfo->DefaultValue = 0.0f;
+	pInfo->StrDefaultValue = NULL;
+	pInfo->bDefined = true;
+
+	return pInfo;
+}
+
+const CFFGLPluginManager::ParamInfo* CFFGLPluginManager::FindParamInfo(unsigned int dwIndex) const
+{
+	if (dwIndex < m_Params.size() && m_Params[dwIndex].bDefined) return &m_Params[dwIndex];
+	return NULL;
+}
+
+void CFFGLPluginManager::SetParamInfo(unsigned int pIndex, const char* pchName, unsigned int pType, float fDefaultValue)
+{
+	ParamInfo* pInfo = AddParamInfo(pIndex, pchName, pType);
+
 	if (fDefaultValue > 1.0) fDefaultValue = 1.0;
 	if (fDefaultValue < 0.0) fDefaultValue = 0.0;
 	pInfo->DefaultValue = fDefaultValue;
-	pInfo->StrDefaultValue = NULL;
-	pInfo->pNext = NULL;
-	if (m_pFirst == NULL) m_pFirst = pInfo; 
-	if (m_pLast != NULL) m_pLast->pNext = pInfo;
-	m_pLast = pInfo;
-	m_NParams++;
 }
 
 #ifdef FFGL_EXT
 void CFFGLPluginManager::SetBufferParamInfo(unsigned int pIndex, const char* pchName,  unsigned int numElements, unsigned int usage )
 {
-	ParamInfo* pInfo = new ParamInfo;
-	pInfo->ID = pIndex;
+	ParamInfo* pInfo = AddParamInfo(pIndex, pchName, FF_TYPE_BUFFER);
 	
 	pInfo->numElements = numElements;
 	pInfo->usage = usage;
-
-	bool bEndFound = false;
-	for (int i = 0; i < 16; ++i) {
-		if (pchName[i] == 0) bEndFound = true;
-		pInfo->Name[i] = (bEndFound) ?  0 : pchName[i];
-	}
-	
-	pInfo->dwType = FF_TYPE_BUFFER;
-
-	pInfo->DefaultValue = 0.0f;
-	pInfo->StrDefaultValue = NULL;
-	pInfo->pNext = NULL;
-	if (m_pFirst == NULL) m_pFirst = pInfo; 
-	if (m_pLast != NULL) m_pLast->pNext = pInfo;
-	m_pLast = pInfo;
-	m_NParams++;
 }
 
 void CFFGLPluginManager::SetOptionParamInfo(unsigned int pIndex, const char* pchName,  unsigned int numElements, int defaultValue)
 {
-	ParamInfo* pInfo = new ParamInfo;
-	pInfo->ID = pIndex;
+	ParamInfo* pInfo = AddParamInfo(pIndex, pchName, FF_TYPE_OPTION);
 	
   pInfo->numElements = numElements;
   pInfo->usage = FF_USAGE_STANDARD;
   
-	bool bEndFound = false;
-	for (int i = 0; i < 16; ++i) {
-		if (pchName[i] == 0) bEndFound = true;
-		pInfo->Name[i] = (bEndFound) ?  0 : pchName[i];
-	}
-	
-	pInfo->dwType = FF_TYPE_OPTION;
-  
 	pInfo->DefaultValue = defaultValue;
-	pInfo->StrDefaultValue = NULL;
-	pInfo->pNext = NULL;
-	if (m_pFirst == NULL) m_pFirst = pInfo; 
-	if (m_pLast != NULL) m_pLast->pNext = pInfo;
-	m_pLast = pInfo;
-	m_NParams++;
-
 }
 #endif
 
 
 void CFFGLPluginManager::SetParamInfo(unsigned int pIndex, const char* pchName, unsigned int pType, bool bDefaultValue)
 {
-	ParamInfo* pInfo = new ParamInfo;
-	pInfo->ID = pIndex;
-	
-	bool bEndFound = false;
-	for (int i = 0; i < 16; ++i) {
-		if (pchName[i] == 0) bEndFound = true;
-		pInfo->Name[i] = (bEndFound) ?  0 : pchName[i];
-	}
+	ParamInfo* pInfo = AddParamInfo(pIndex, pchName, pType);
 	
-	pInfo->dwType = pType;
 	pInfo->DefaultValue = bDefaultValue ? 1.0f : 0.0f;
-	pInfo->StrDefaultValue = NULL;
-	pInfo->pNext = NULL;
-	if (m_pFirst == NULL) m_pFirst = pInfo; 
-	if (m_pLast != NULL) m_pLast->pNext = pInfo;
-	m_pLast = pInfo;
-	m_NParams++;
 }
 
 void CFFGLPluginManager::SetParamInfo(unsigned int dwIndex, const char* pchName, unsigned int dwType, const char* pchDefaultValue)
 {
-	ParamInfo* pInfo = new ParamInfo;
-	pInfo->ID = dwIndex;
+	ParamInfo* pInfo = AddParamInfo(dwIndex, pchName, dwType);
 
-#ifdef FFGL_EXT
-	pInfo->numElements = 1;
-    pInfo->usage = 0;
-#endif
-	
-	bool bEndFound = false;
-	for (int i = 0; i < 16; ++i) {
-		if (pchName[i] == 0) bEndFound = true;
-		pInfo->Name[i] = (bEndFound) ?  0 : pchName[i];
-	}
-
-	pInfo->dwType = dwType;
-	pInfo->DefaultValue = 0;
 	pInfo->StrDefaultValue = strdup(pchDefaultValue);
-	pInfo->pNext = NULL;
-	if (m_pFirst == NULL) m_pFirst = pInfo; 
-	if (m_pLast != NULL) m_pLast->pNext = pInfo;
-	m_pLast = pInfo;
-	m_NParams++;
 }
 
 void CFFGLPluginManager::SetTimeSupported(bool supported)
@@ -211,62 +162,30 @@ void CFFGLPluginManager::SetTimeSupported(bool supported)
 
 char* CFFGLPluginManager::GetParamName(unsigned int dwIndex) const
 {
-	ParamInfo* pCurr = m_pFirst;
-	bool bFound = false;
-	while (pCurr != NULL) {
-		if (pCurr->ID == dwIndex) {
-			bFound = true;
-			break;
-		}
-		pCurr = pCurr->pNext;
-	}
-	if (bFound) return pCurr->Name;
+	const ParamInfo* pInfo = FindParamInfo(dwIndex);
+	if (pInfo != NULL) return (char*)pInfo->Name;
 	return NULL;
 }
 	
 unsigned int CFFGLPluginManager::GetParamType(unsigned int dwIndex) const
 {
-	ParamInfo* pCurr = m_pFirst;
-	bool bFound = false;
-	while (pCurr != NULL) {
-		if (pCurr->ID == dwIndex) {
-			bFound = true;
-			break;
-		}
-		pCurr = pCurr->pNext;
-	}
-	if (bFound) return pCurr->dwType;
+	const ParamInfo* pInfo = FindParamInfo(dwIndex);
+	if (pInfo != NULL) return pInfo->dwType;
 	return FF_FAIL;
 }
 
 #ifdef FFGL_EXT
 unsigned int CFFGLPluginManager::GetNumParamElements(unsigned int dwIndex) const
 {
-	ParamInfo* pCurr = m_pFirst;
-	bool bFound = false;
-	while (pCurr != NULL) {
-		if (pCurr->ID == dwIndex) {
-			bFound = true;
-			break;
-		}
-		pCurr = pCurr->pNext;
-	}
-	if (bFound) return pCurr->numElements;
+	const ParamInfo* pInfo = FindParamInfo(dwIndex);
+	if (pInfo != NULL) return pInfo->numElements;
 	return FF_FAIL;
 }
 
 unsigned int CFFGLPluginManager::GetParamUsage(unsigned int dwIndex) const
 {
-	ParamInfo* pCurr = m_pFirst;
-	bool bFound = false;
-	while (pCurr != NULL) {
-		if (pCurr->ID == dwIndex) {
-			bFound = true;
-			break;
-		}
-		pCurr = pCurr->pNext;
-	}
-	if (bFound) return pCurr->usage;
+	const ParamInfo* pInfo = FindParamInfo(dwIndex);
+	if (pInfo != NULL) return pInfo->usage;
 	return FF_FAIL;
 }
 
@@ -276,20 +195,12 @@ unsigned int CFFGLPluginManager::GetParamUsage(unsigned int dwIndex) const
 FFMixed CFFGLPluginManager::GetParamDefault(unsigned int dwIndex) const
 {
   FFMixed result;
-	ParamInfo* pCurr = m_pFirst;
-	bool bFound = false;
-	while (pCurr != NULL) {
-		if (pCurr->ID == dwIndex) {
-			bFound = true;
-			break;
-		}
-		pCurr = pCurr->pNext;
-	}
-	if (bFound) {
-		if (GetParamType(dwIndex) == FF_TYPE_TEXT)
-			result.PointerValue = (void*)pCurr->StrDefaultValue;
+	const ParamInfo* pInfo = FindParamInfo(dwIndex);
+	if (pInfo != NULL) {
+		if (pInfo->dwType == FF_TYPE_TEXT)
+			result.PointerValue = (void*)pInfo->StrDefaultValue;
 		else
-			result.UIntValue = *(unsigned int*)&pCurr->DefaultValue;
+			result.UIntValue = *(unsigned int*)&pInfo->DefaultValue;
 	} else {
     result.UIntValue = FF_FAIL;
   }
@@ -23,6 +23,8 @@
 
 #include "FFGL.h"
 
+#include <vector>
+
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 /// \class		CFFGLPluginManager
@@ -248,13 +250,16 @@ private:
 
 		float DefaultValue;				
 		char* StrDefaultValue;			
-		ParamInfoStruct* pNext;	
+		bool bDefined;
 	} ParamInfo;
 
-	// Information on paramters and pointers to ParamInfo list
+	// Information on parameters, indexed by parameter ID so that the getters
+	// called by the host every frame don't have to search for the parameter
 	int m_NParams;
-	ParamInfo* m_pFirst;
-	ParamInfo* m_pLast;
+	std::vector<ParamInfo> m_Params;
+
+	ParamInfo* AddParamInfo(unsigned int index, const char* pchName, unsigned int type);
+	const ParamInfo* FindParamInfo(unsigned int index) const;
 	
 	// Inputs
 	int m_iMinInputs;
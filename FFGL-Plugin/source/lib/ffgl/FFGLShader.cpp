@@ -186,3 +186,8 @@ GLuint FFGLShader::FindUniform(const char *name)
 {
 	return glGetUniformLocation(m_glProgram,name);
 }
+
+GLint FFGLShader::FindAttribute(const char *name)
+{
+	return glGetAttribLocation(m_glProgram,name);
+}
@@ -16,6 +16,7 @@ public:
 	int Compile(const std::string& vtxProgram, const std::string& fragProgram);
 
 	GLuint FindUniform(const char *name);
+	GLint FindAttribute(const char *name);
 	int BindShader();
 	int UnbindShader();
 	void FreeGLResources();
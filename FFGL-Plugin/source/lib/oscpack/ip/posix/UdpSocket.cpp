@@ -44,6 +44,7 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <time.h>
 #include <netinet/in.h> // for sockaddr_in
 
 #include <signal.h>
@@ -61,6 +62,24 @@
 #include "ip/TimerListener.h"
 
 
+// On Linux the receive loop uses epoll and recvmmsg() instead of select().
+// Define OSCPACK_NO_EPOLL to fall back to the portable select() loop.
+#if defined(__linux__) && !defined(OSCPACK_NO_EPOLL)
+#define OSCPACK_USE_EPOLL
+#endif
+
+#ifdef OSCPACK_USE_EPOLL
+#include <sys/epoll.h>
+#include <sys/uio.h>
+#include <stdint.h>
+
+// maximum number of datagrams read from a socket by a single recvmmsg() call
+#ifndef OSCPACK_RECVMMSG_BATCH_SIZE
+#define OSCPACK_RECVMMSG_BATCH_SIZE 32
+#endif
+#endif
+
+
 #if defined(__APPLE__) && !defined(_SOCKLEN_T)
 // pre system 10.3 didn't have socklen_t
 typedef ssize_t socklen_t;
@@ -316,10 +335,12 @@ struct AttachedTimerListener{
 };
 
 
+// the timer queue is kept as a binary min-heap on expiry time, so this
+// comparison is reversed: the earliest expiry ends up at the front
 static bool CompareScheduledTimerCalls( 
 		const std::pair< double, AttachedTimerListener > & lhs, const std::pair< double, AttachedTimerListener > & rhs )
 {
-	return lhs.first < rhs.first;
+	return lhs.first > rhs.first;
 }
 
 
@@ -340,13 +361,27 @@ class SocketReceiveMultiplexer::Implementation{
 	volatile bool break_;
 	int breakPipe_[2]; // [0] is the reader descriptor and [1] the writer
 
+	// expired timers popped from the heap during one pass, kept here so that
+	// RunExpiredTimers() doesn't allocate once the queue has warmed up
+	std::vector< std::pair< double, AttachedTimerListener > > expiredTimers_;
+
+	// timers are scheduled against a monotonic clock so that wall clock
+	// adjustments (NTP, daylight saving) can't stall or burst them
 	double GetCurrentTimeMs() const
 	{
+#if defined(CLOCK_MONOTONIC)
+		struct timespec t;
+
+		clock_gettime( CLOCK_MONOTONIC, &t );
+
+		return ((double)t.tv_sec*1000.) + ((double)t.tv_nsec / 1000000.);
+#else
 		struct timeval t;
 
 		gettimeofday( &t, 0 );
 
 		return ((double)t.tv_sec*1000.) + ((double)t.tv_usec / 1000.);
+#endif
 	}
 
 public:
@@ -403,6 +438,192 @@ public:
 	}
 
     void Run()
+	{
+#ifdef OSCPACK_USE_EPOLL
+		RunEpoll();
+#else
+		RunSelect();
+#endif
+	}
+
+private:
+
+    typedef std::vector< std::pair< double, AttachedTimerListener > > TimerQueue;
+
+    // the clock is read once per multiplexer pass, after the wait: the same
+    // time decides which timers expire and how long the next wait is
+    void InitializeTimerQueue( TimerQueue& timerQueue, double currentTimeMs )
+	{
+		for( std::vector< AttachedTimerListener >::iterator i = timerListeners_.begin();
+				i != timerListeners_.end(); ++i )
+			timerQueue.push_back( std::make_pair( currentTimeMs + i->initialDelayMs, *i ) );
+		std::make_heap( timerQueue.begin(), timerQueue.end(), CompareScheduledTimerCalls );
+
+		expiredTimers_.clear();
+		expiredTimers_.reserve( timerQueue.size() );
+	}
+
+    // returns -1 when there is no timer to wait for
+    double MillisecondsUntilNextTimer( const TimerQueue& timerQueue, double currentTimeMs ) const
+	{
+		if( timerQueue.empty() )
+			return -1.;
+
+		double timeoutMs = timerQueue.front().first - currentTimeMs;
+		return (timeoutMs < 0) ? 0. : timeoutMs;
+	}
+
+    // pops every timer due at the current time, calls it and pushes it back
+    // with its next expiry. Each timer fires at most once per pass, like the
+    // original sorted vector implementation, so a zero period can't spin here.
+    void RunExpiredTimers( TimerQueue& timerQueue, double currentTimeMs )
+	{
+		while( !timerQueue.empty() && timerQueue.front().first <= currentTimeMs ){
+			std::pop_heap( timerQueue.begin(), timerQueue.end(), CompareScheduledTimerCalls );
+			expiredTimers_.push_back( timerQueue.back() );
+			timerQueue.pop_back();
+		}
+
+		for( TimerQueue::iterator i = expiredTimers_.begin(); i != expiredTimers_.end(); ++i ){
+			if( !break_ )
+				i->second.listener->TimerExpired();
+
+			i->first += i->second.periodMs;
+			timerQueue.push_back( *i );
+			std::push_heap( timerQueue.begin(), timerQueue.end(), CompareScheduledTimerCalls );
+		}
+
+		expiredTimers_.clear();
+	}
+
+    void ClearBreakPipe()
+	{
+		// clear pending data from the asynchronous break pipe
+		char c;
+		read( breakPipe_[0], &c, 1 );
+	}
+
+#ifdef OSCPACK_USE_EPOLL
+
+    // Linux implementation: epoll reports which sockets are readable, then
+    // recvmmsg() reads up to OSCPACK_RECVMMSG_BATCH_SIZE datagrams per system
+    // call into a pool of buffers allocated once per Run(). epoll is level
+    // triggered, so a socket that still has queued datagrams after one batch
+    // is reported again on the next wakeup, after the other sockets and the
+    // timers have had their turn.
+    void RunEpoll()
+	{
+		break_ = false;
+
+		const int MAX_BUFFER_SIZE = 4098;
+		const int BATCH_SIZE = OSCPACK_RECVMMSG_BATCH_SIZE;
+		const uint32_t BREAK_PIPE_TAG = 0xFFFFFFFFu;
+
+		int epollFd = epoll_create1( EPOLL_CLOEXEC );
+		if( epollFd < 0 )
+			throw std::runtime_error( "epoll_create1 failed\n" );
+
+		try{
+			// register the asynchronous break pipe and the inbound sockets,
+			// tagging each socket with its index in socketListeners_
+			struct epoll_event event;
+			std::memset( &event, 0, sizeof(event) );
+			event.events = EPOLLIN;
+			event.data.u32 = BREAK_PIPE_TAG;
+			if( epoll_ctl( epollFd, EPOLL_CTL_ADD, breakPipe_[0], &event ) < 0 )
+				throw std::runtime_error( "epoll_ctl failed\n" );
+
+			for( std::size_t i = 0; i < socketListeners_.size(); ++i ){
+				event.data.u32 = (uint32_t)i;
+				if( epoll_ctl( epollFd, EPOLL_CTL_ADD, socketListeners_[i].second->impl_->Socket(), &event ) < 0 )
+					throw std::runtime_error( "epoll_ctl failed\n" );
+			}
+
+			// preallocated receive buffers and message headers for recvmmsg()
+			std::vector< char > bufferPool( (std::size_t)MAX_BUFFER_SIZE * BATCH_SIZE );
+			std::vector< struct iovec > iovecs( BATCH_SIZE );
+			std::vector< struct sockaddr_in > fromAddrs( BATCH_SIZE );
+			std::vector< struct mmsghdr > messages( BATCH_SIZE );
+			for( int k = 0; k < BATCH_SIZE; ++k ){
+				iovecs[k].iov_base = &bufferPool[ (std::size_t)k * MAX_BUFFER_SIZE ];
+				iovecs[k].iov_len = MAX_BUFFER_SIZE;
+
+				std::memset( &messages[k], 0, sizeof(messages[k]) );
+				messages[k].msg_hdr.msg_iov = &iovecs[k];
+				messages[k].msg_hdr.msg_iovlen = 1;
+				messages[k].msg_hdr.msg_name = &fromAddrs[k];
+			}
+
+			std::vector< struct epoll_event > readyEvents( socketListeners_.size() + 1 );
+
+			double currentTimeMs = GetCurrentTimeMs();
+			TimerQueue timerQueue;
+			InitializeTimerQueue( timerQueue, currentTimeMs );
+
+			IpEndpointName remoteEndpoint;
+
+			while( !break_ ){
+				double timeoutMs = MillisecondsUntilNextTimer( timerQueue, currentTimeMs );
+
+				int readyCount = epoll_wait( epollFd, &readyEvents[0], (int)readyEvents.size(),
+						(timeoutMs < 0) ? -1 : (int)ceil( timeoutMs ) );
+				if( readyCount < 0 ){
+					if( break_ ){
+						break;
+					}else if( errno == EINTR ){
+						currentTimeMs = GetCurrentTimeMs();
+						continue;
+					}else{
+						throw std::runtime_error( "epoll_wait failed\n" );
+					}
+				}
+
+				for( int e = 0; e < readyCount && !break_; ++e ){
+					uint32_t tag = readyEvents[e].data.u32;
+					if( tag == BREAK_PIPE_TAG ){
+						ClearBreakPipe();
+						continue;
+					}
+
+					PacketListener *listener = socketListeners_[tag].first;
+					int socket = socketListeners_[tag].second->impl_->Socket();
+
+					for( int k = 0; k < BATCH_SIZE; ++k )
+						messages[k].msg_hdr.msg_namelen = sizeof(fromAddrs[k]);
+
+					int received = recvmmsg( socket, &messages[0], BATCH_SIZE, MSG_DONTWAIT, 0 );
+
+					for( int k = 0; k < received; ++k ){
+						if( messages[k].msg_len == 0 )
+							continue;
+
+						remoteEndpoint.address = ntohl( fromAddrs[k].sin_addr.s_addr );
+						remoteEndpoint.port = ntohs( fromAddrs[k].sin_port );
+
+						listener->ProcessPacket( (const char*)iovecs[k].iov_base, (int)messages[k].msg_len, remoteEndpoint );
+						if( break_ )
+							break;
+					}
+				}
+
+				if( break_ )
+					break;
+
+				// execute any expired timers
+				currentTimeMs = GetCurrentTimeMs();
+				RunExpiredTimers( timerQueue, currentTimeMs );
+			}
+
+			close( epollFd );
+		}catch(...){
+			close( epollFd );
+			throw;
+		}
+	}
+
+#endif /* OSCPACK_USE_EPOLL */
+
+    void RunSelect()
 	{
 		break_ = false;
         char *data = 0;
@@ -432,13 +653,8 @@ public:
 
             // configure the timer queue
             double currentTimeMs = GetCurrentTimeMs();
-
-            // expiry time ms, listener
-            std::vector< std::pair< double, AttachedTimerListener > > timerQueue_;
-            for( std::vector< AttachedTimerListener >::iterator i = timerListeners_.begin();
-                    i != timerListeners_.end(); ++i )
-                timerQueue_.push_back( std::make_pair( currentTimeMs + i->initialDelayMs, *i ) );
-            std::sort( timerQueue_.begin(), timerQueue_.end(), CompareScheduledTimerCalls );
+            TimerQueue timerQueue;
+            InitializeTimerQueue( timerQueue, currentTimeMs );
 
             const int MAX_BUFFER_SIZE = 4098;
             data = new char[ MAX_BUFFER_SIZE ];
@@ -450,11 +666,8 @@ public:
                 tempfds = masterfds;
 
                 struct timeval *timeoutPtr = 0;
-                if( !timerQueue_.empty() ){
-                    double timeoutMs = timerQueue_.front().first - GetCurrentTimeMs();
-                    if( timeoutMs < 0 )
-                        timeoutMs = 0;
-                
+                double timeoutMs = MillisecondsUntilNextTimer( timerQueue, currentTimeMs );
+                if( timeoutMs >= 0 ){
                     long timoutSecondsPart = (long)(timeoutMs * .001);
                     timeout.tv_sec = (time_t)timoutSecondsPart;
                     // 1000000 microseconds in a second
@@ -470,6 +683,7 @@ public:
                         // so tempfds would remain all set, which would cause read( breakPipe_[0]...
                         // below to block indefinitely. therefore if select returns EINTR we restart
                         // the while() loop instead of continuing on to below.
+                        currentTimeMs = GetCurrentTimeMs();
                         continue;
                     }else{
                         throw std::runtime_error("select failed\n");
@@ -477,9 +691,7 @@ public:
                 }
 
                 if( FD_ISSET( breakPipe_[0], &tempfds ) ){
-                    // clear pending data from the asynchronous break pipe
-                    char c;
-                    read( breakPipe_[0], &c, 1 );
+                    ClearBreakPipe();
                 }
                 
                 if( break_ )
@@ -501,19 +713,7 @@ public:
 
                 // execute any expired timers
                 currentTimeMs = GetCurrentTimeMs();
-                bool resort = false;
-                for( std::vector< std::pair< double, AttachedTimerListener > >::iterator i = timerQueue_.begin();
-                        i != timerQueue_.end() && i->first <= currentTimeMs; ++i ){
-
-                    i->second.listener->TimerExpired();
-                    if( break_ )
-                        break;
-
-                    i->first += i->second.periodMs;
-                    resort = true;
-                }
-                if( resort )
-                    std::sort( timerQueue_.begin(), timerQueue_.end(), CompareScheduledTimerCalls );
+                RunExpiredTimers( timerQueue, currentTimeMs );
             }
 
             delete [] data;
@@ -524,6 +724,8 @@ public:
         }
 	}
 
+public:
+
     void Break()
 	{
 		break_ = true;
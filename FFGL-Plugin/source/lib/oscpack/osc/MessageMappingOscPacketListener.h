@@ -37,42 +37,64 @@
 #ifndef INCLUDED_OSCPACK_MESSAGEMAPPINGOSCPACKETLISTENER_H
 #define INCLUDED_OSCPACK_MESSAGEMAPPINGOSCPACKETLISTENER_H
 
-#include <cstring>
-#include <map>
+#include <vector>
 
 #include "OscPacketListener.h"
+#include "OscAddressSpace.h"
 
 
 
 namespace osc{
 
+// Dispatches incoming messages to member functions of T by OSC address.
+// Registered addresses are compiled into an AddressSpace, so incoming
+// address patterns may use the OSC 1.0 wildcards and every matching
+// method is called. T must derive from MessageMappingOscPacketListener<T>.
+
 template< class T >
 class MessageMappingOscPacketListener : public OscPacketListener{
 public:
     typedef void (T::*function_type)(const osc::ReceivedMessage&, const IpEndpointName&);
 
 protected:
+    // registering the same address twice keeps the first function
     void RegisterMessageFunction( const char *addressPattern, function_type f )
     {
-        functions_.insert( std::make_pair( addressPattern, f ) );
+        std::size_t methodId = addressSpace_.AddMethod( addressPattern );
+        if( methodId == functions_.size() )
+            functions_.push_back( f );
     }
 
     virtual void ProcessMessage( const osc::ReceivedMessage& m,
 		const IpEndpointName& remoteEndpoint )
     {
-        typename function_map_type::iterator i = functions_.find( m.AddressPattern() );
-        if( i != functions_.end() )
-            (dynamic_cast<T*>(this)->*(i->second))( m, remoteEndpoint );
+        if( functions_.empty() )
+            return;
+
+        Dispatcher dispatcher( static_cast<T*>(this), &functions_[0], m, remoteEndpoint );
+        addressSpace_.Match( m.AddressPattern(), dispatcher );
     }
     
 private:
-    struct cstr_compare{
-        bool operator()( const char *lhs, const char *rhs ) const
-            { return std::strcmp( lhs, rhs ) < 0; }
+    struct Dispatcher{
+        Dispatcher( T *target, const function_type *functions,
+                const osc::ReceivedMessage& m, const IpEndpointName& remoteEndpoint )
+            : target_( target )
+            , functions_( functions )
+            , m_( m )
+            , remoteEndpoint_( remoteEndpoint ) {}
+
+        void operator()( std::size_t methodId ) const
+            { (target_->*functions_[methodId])( m_, remoteEndpoint_ ); }
+
+        T *target_;
+        const function_type *functions_;
+        const osc::ReceivedMessage& m_;
+        const IpEndpointName& remoteEndpoint_;
     };
 
-    typedef std::map<const char*, function_type, cstr_compare> function_map_type;
-    function_map_type functions_;
+    AddressSpace addressSpace_;
+    std::vector< function_type > functions_; // indexed by method id
 };
 
 } // namespace osc
@@ -0,0 +1,290 @@
+/*
+	oscpack -- Open Sound Control (OSC) packet manipulation library
+    http://www.rossbencina.com/code/oscpack
+
+    Copyright (c) 2004-2013 Ross Bencina <rossb@audiomulch.com>
+
+	Permission is hereby granted, free of charge, to any person obtaining
+	a copy of this software and associated documentation files
+	(the "Software"), to deal in the Software without restriction,
+	including without limitation the rights to use, copy, modify, merge,
+	publish, distribute, sublicense, and/or sell copies of the Software,
+	and to permit persons to whom the Software is furnished to do so,
+	subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+	MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+	IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR
+	ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+	CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+	WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+	The text above constitutes the entire oscpack license; however, 
+	the oscpack developer(s) also make the following non-binding requests:
+
+	Any person wishing to distribute modifications to the Software is
+	requested to send the modifications to the original developer so that
+	they can be incorporated into the canonical version. It is also 
+	requested that these non-binding requests be included whenever the
+	above license is reproduced.
+*/
+#include "OscAddressSpace.h"
+
+#include <cstring>
+
+
+namespace osc{
+
+bool AddressPartMatches( const char *pattern, const char *patternEnd,
+        const char *part, const char *partEnd )
+{
+    while( pattern != patternEnd ){
+        switch( *pattern ){
+
+            case '*':
+                {
+                    // collapse runs of '*' then try every possible tail
+                    while( pattern != patternEnd && *pattern == '*' )
+                        ++pattern;
+                    if( pattern == patternEnd )
+                        return true;
+
+                    for( const char *tail = part; tail <= partEnd; ++tail ){
+                        if( AddressPartMatches( pattern, patternEnd, tail, partEnd ) )
+                            return true;
+                    }
+                    return false;
+                }
+
+            case '?':
+                if( part == partEnd )
+                    return false;
+                ++pattern;
+                ++part;
+                break;
+
+            case '[':
+                {
+                    if( part == partEnd )
+                        return false;
+
+                    ++pattern;
+                    bool negate = false;
+                    if( pattern != patternEnd && *pattern == '!' ){
+                        negate = true;
+                        ++pattern;
+                    }
+
+                    bool matched = false;
+                    while( pattern != patternEnd && *pattern != ']' ){
+                        if( patternEnd - pattern > 2 && pattern[1] == '-' && pattern[2] != ']' ){
+                            if( pattern[0] <= *part && *part <= pattern[2] )
+                                matched = true;
+                            pattern += 3;
+                        }else{
+                            if( *pattern == *part )
+                                matched = true;
+                            ++pattern;
+                        }
+                    }
+
+                    if( pattern == patternEnd ) // unterminated '['
+                        return false;
+                    ++pattern;
+
+                    if( matched == negate )
+                        return false;
+                    ++part;
+                }
+                break;
+
+            case '{':
+                {
+                    const char *close = pattern + 1;
+                    while( close != patternEnd && *close != '}' )
+                        ++close;
+                    if( close == patternEnd ) // unterminated '{'
+                        return false;
+
+                    const char *alternative = pattern + 1;
+                    for(;;){
+                        const char *alternativeEnd = alternative;
+                        while( alternativeEnd != close && *alternativeEnd != ',' )
+                            ++alternativeEnd;
+
+                        std::size_t length = (std::size_t)(alternativeEnd - alternative);
+                        if( (std::size_t)(partEnd - part) >= length
+                                && std::memcmp( alternative, part, length ) == 0
+                                && AddressPartMatches( close + 1, patternEnd, part + length, partEnd ) )
+                            return true;
+
+                        if( alternativeEnd == close )
+                            return false;
+                        alternative = alternativeEnd + 1;
+                    }
+                }
+
+            default:
+                if( part == partEnd || *pattern != *part )
+                    return false;
+                ++pattern;
+                ++part;
+                break;
+        }
+    }
+
+    return part == partEnd;
+}
+
+
+AddressSpace::AddressSpace()
+    : partTable_( 64, -1 )
+    , methodCount_( 0 )
+{
+    nodes_.push_back( Node() ); // root
+}
+
+
+std::size_t AddressSpace::AddMethod( const char *address )
+{
+    if( address == 0 || address[0] != '/' )
+        throw MalformedAddressException( "OSC address must start with '/'" );
+
+    int node = 0;
+    const char *part = address + 1;
+    for(;;){
+        const char *end = part;
+        while( *end != '\0' && *end != '/' )
+            ++end;
+
+        int partId = InternPart( part, end );
+        int child = FindChild( node, partId );
+        if( child < 0 )
+            child = AddChild( node, partId );
+        node = child;
+
+        if( *end == '\0' )
+            break;
+        part = end + 1;
+    }
+
+    if( nodes_[node].methodId < 0 )
+        nodes_[node].methodId = (int)methodCount_++;
+
+    return (std::size_t)nodes_[node].methodId;
+}
+
+
+// FNV-1a
+std::size_t AddressSpace::HashPart( const char *begin, const char *end )
+{
+    std::size_t hash = 2166136261u;
+    for( const char *c = begin; c != end; ++c ){
+        hash ^= (unsigned char)*c;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+
+int AddressSpace::FindPart( const char *begin, const char *end ) const
+{
+    std::size_t length = (std::size_t)(end - begin);
+    std::size_t mask = partTable_.size() - 1;
+
+    for( std::size_t slot = HashPart( begin, end ) & mask; ; slot = (slot + 1) & mask ){
+        int partId = partTable_[slot];
+        if( partId < 0 )
+            return -1;
+
+        const std::string& candidate = parts_[partId];
+        if( candidate.size() == length && std::memcmp( candidate.data(), begin, length ) == 0 )
+            return partId;
+    }
+}
+
+
+int AddressSpace::InternPart( const char *begin, const char *end )
+{
+    int partId = FindPart( begin, end );
+    if( partId >= 0 )
+        return partId;
+
+    // keep the table at most half full so probe sequences stay short
+    if( (parts_.size() + 1) * 2 > partTable_.size() )
+        GrowPartTable();
+
+    partId = (int)parts_.size();
+    parts_.push_back( std::string( begin, end ) );
+
+    std::size_t mask = partTable_.size() - 1;
+    std::size_t slot = HashPart( begin, end ) & mask;
+    while( partTable_[slot] >= 0 )
+        slot = (slot + 1) & mask;
+    partTable_[slot] = partId;
+
+    return partId;
+}
+
+
+void AddressSpace::GrowPartTable()
+{
+    std::vector< int > table( partTable_.size() * 2, -1 );
+    std::size_t mask = table.size() - 1;
+
+    for( std::size_t i = 0; i < parts_.size(); ++i ){
+        const std::string& part = parts_[i];
+        std::size_t slot = HashPart( part.data(), part.data() + part.size() ) & mask;
+        while( table[slot] >= 0 )
+            slot = (slot + 1) & mask;
+        table[slot] = (int)i;
+    }
+
+    partTable_.swap( table );
+}
+
+
+int AddressSpace::FindChild( int node, int partId ) const
+{
+    const std::vector< Edge >& children = nodes_[node].children;
+
+    std::size_t low = 0, high = children.size();
+    while( low < high ){
+        std::size_t middle = (low + high) / 2;
+        if( children[middle].partId < partId )
+            low = middle + 1;
+        else
+            high = middle;
+    }
+
+    if( low < children.size() && children[low].partId == partId )
+        return children[low].node;
+    return -1;
+}
+
+
+int AddressSpace::AddChild( int node, int partId )
+{
+    int child = (int)nodes_.size();
+    nodes_.push_back( Node() );
+
+    std::vector< Edge >& children = nodes_[node].children;
+    std::vector< Edge >::iterator i = children.begin();
+    while( i != children.end() && i->partId < partId )
+        ++i;
+
+    Edge edge;
+    edge.partId = partId;
+    edge.node = child;
+    children.insert( i, edge );
+
+    return child;
+}
+
+} // namespace osc
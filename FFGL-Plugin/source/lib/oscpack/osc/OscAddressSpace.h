@@ -0,0 +1,164 @@
+/*
+	oscpack -- Open Sound Control (OSC) packet manipulation library
+    http://www.rossbencina.com/code/oscpack
+
+    Copyright (c) 2004-2013 Ross Bencina <rossb@audiomulch.com>
+
+	Permission is hereby granted, free of charge, to any person obtaining
+	a copy of this software and associated documentation files
+	(the "Software"), to deal in the Software without restriction,
+	including without limitation the rights to use, copy, modify, merge,
+	publish, distribute, sublicense, and/or sell copies of the Software,
+	and to permit persons to whom the Software is furnished to do so,
+	subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+	MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+	IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR
+	ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+	CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+	WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+	The text above constitutes the entire oscpack license; however, 
+	the oscpack developer(s) also make the following non-binding requests:
+
+	Any person wishing to distribute modifications to the Software is
+	requested to send the modifications to the original developer so that
+	they can be incorporated into the canonical version. It is also 
+	requested that these non-binding requests be included whenever the
+	above license is reproduced.
+*/
+#ifndef INCLUDED_OSCPACK_OSCADDRESSSPACE_H
+#define INCLUDED_OSCPACK_OSCADDRESSSPACE_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "OscException.h"
+
+
+namespace osc{
+
+class MalformedAddressException : public Exception{
+public:
+    MalformedAddressException( const char *w="malformed OSC address" )
+        : Exception( w ) {}
+};
+
+
+// Returns true if a single address part (the text between two '/') matches
+// an OSC 1.0 address pattern part. Supports '?', '*', '[abc]', '[a-z]',
+// '[!abc]' and '{foo,bar}'. Neither range includes a '/'.
+bool AddressPartMatches( const char *pattern, const char *patternEnd,
+        const char *part, const char *partEnd );
+
+
+// The set of OSC methods a receiver understands, compiled into a trie of
+// address parts. Each distinct part string is interned once and edges are
+// keyed by the interned id, so matching a literal address is a hash probe
+// and a binary search per part, with no string copies and no allocation.
+// Parts containing wildcards are matched against the children of the
+// current node with AddressPartMatches().
+//
+// Methods are identified by the index returned from AddMethod(), which is
+// also the registration order.
+
+class AddressSpace{
+public:
+    AddressSpace();
+
+    // Adds a method address such as "/bridge/param/3" and returns its id.
+    // Registering the same address again returns the existing id.
+    // Throws MalformedAddressException if the address doesn't start with '/'.
+    std::size_t AddMethod( const char *address );
+
+    std::size_t MethodCount() const { return methodCount_; }
+
+    // Calls f( methodId ) for every registered method matched by
+    // addressPattern. f can be a function or any object with a suitable
+    // operator(), it is called in trie order rather than registration order.
+    template< class F >
+    void Match( const char *addressPattern, F& f ) const
+    {
+        if( addressPattern[0] == '/' )
+            MatchFrom( 0, addressPattern + 1, f );
+    }
+
+private:
+    struct Edge{
+        int partId;
+        int node;
+    };
+
+    struct Node{
+        Node() : methodId( -1 ) {}
+        std::vector< Edge > children; // sorted by partId
+        int methodId;
+    };
+
+    std::vector< Node > nodes_;
+    std::vector< std::string > parts_;
+    std::vector< int > partTable_; // open addressing hash table of part ids, -1 is empty
+    std::size_t methodCount_;
+
+    static std::size_t HashPart( const char *begin, const char *end );
+
+    int FindPart( const char *begin, const char *end ) const;
+    int InternPart( const char *begin, const char *end );
+    void GrowPartTable();
+
+    int FindChild( int node, int partId ) const;
+    int AddChild( int node, int partId );
+
+    template< class F >
+    void MatchFrom( int node, const char *part, F& f ) const
+    {
+        const char *end = part;
+        bool isLiteral = true;
+        while( *end != '\0' && *end != '/' ){
+            char c = *end;
+            if( c == '*' || c == '?' || c == '[' || c == '{' )
+                isLiteral = false;
+            ++end;
+        }
+
+        if( isLiteral ){
+            int partId = FindPart( part, end );
+            if( partId < 0 )
+                return;
+
+            int child = FindChild( node, partId );
+            if( child >= 0 )
+                MatchChild( child, end, f );
+        }else{
+            const std::vector< Edge >& children = nodes_[node].children;
+            for( std::size_t i = 0; i < children.size(); ++i ){
+                const std::string& candidate = parts_[ children[i].partId ];
+                if( AddressPartMatches( part, end, candidate.data(), candidate.data() + candidate.size() ) )
+                    MatchChild( children[i].node, end, f );
+            }
+        }
+    }
+
+    template< class F >
+    void MatchChild( int child, const char *partEnd, F& f ) const
+    {
+        if( *partEnd == '\0' ){
+            if( nodes_[child].methodId >= 0 )
+                f( (std::size_t)nodes_[child].methodId );
+        }else{
+            MatchFrom( child, partEnd + 1, f );
+        }
+    }
+};
+
+} // namespace osc
+
+#endif /* INCLUDED_OSCPACK_OSCADDRESSSPACE_H */
@@ -0,0 +1,83 @@
+/*
+	oscpack -- Open Sound Control (OSC) packet manipulation library
+    http://www.rossbencina.com/code/oscpack
+
+    Copyright (c) 2004-2013 Ross Bencina <rossb@audiomulch.com>
+
+	Permission is hereby granted, free of charge, to any person obtaining
+	a copy of this software and associated documentation files
+	(the "Software"), to deal in the Software without restriction,
+	including without limitation the rights to use, copy, modify, merge,
+	publish, distribute, sublicense, and/or sell copies of the Software,
+	and to permit persons to whom the Software is furnished to do so,
+	subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+	MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+	IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR
+	ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+	CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+	WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+	The text above constitutes the entire oscpack license; however, 
+	the oscpack developer(s) also make the following non-binding requests:
+
+	Any person wishing to distribute modifications to the Software is
+	requested to send the modifications to the original developer so that
+	they can be incorporated into the canonical version. It is also 
+	requested that these non-binding requests be included whenever the
+	above license is reproduced.
+*/
+#include "OscByteOrder.h"
+
+#include "OscHostEndianness.h"
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OSC_BYTEORDER_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+
+namespace osc{
+
+void SwapBigEndian32( const void *source, void *dest, std::size_t count )
+{
+#ifdef OSC_HOST_LITTLE_ENDIAN
+    const char *in = (const char*)source;
+    char *out = (char*)dest;
+    std::size_t i = 0;
+
+#ifdef OSC_BYTEORDER_USE_SSE2
+    // swap four values per iteration: SSE2 has no byte shuffle, so swap
+    // the 16 bit halves of each lane, then the bytes within each half
+    for( ; i + 4 <= count; i += 4 ){
+        __m128i v = _mm_loadu_si128( (const __m128i*)(in + i * 4) );
+        v = _mm_or_si128( _mm_slli_epi32( v, 16 ), _mm_srli_epi32( v, 16 ) );
+        v = _mm_or_si128( _mm_slli_epi16( v, 8 ), _mm_srli_epi16( v, 8 ) );
+        _mm_storeu_si128( (__m128i*)(out + i * 4), v );
+    }
+#endif
+
+    for( ; i < count; ++i ){
+        const char *p = in + i * 4;
+        char *q = out + i * 4;
+        char c0 = p[0], c1 = p[1];
+        q[0] = p[3];
+        q[1] = p[2];
+        q[2] = c1;
+        q[3] = c0;
+    }
+#else
+    std::memmove( dest, source, count * 4 );
+#endif
+}
+
+} // namespace osc
@@ -0,0 +1,137 @@
+/*
+	oscpack -- Open Sound Control (OSC) packet manipulation library
+    http://www.rossbencina.com/code/oscpack
+
+    Copyright (c) 2004-2013 Ross Bencina <rossb@audiomulch.com>
+
+	Permission is hereby granted, free of charge, to any person obtaining
+	a copy of this software and associated documentation files
+	(the "Software"), to deal in the Software without restriction,
+	including without limitation the rights to use, copy, modify, merge,
+	publish, distribute, sublicense, and/or sell copies of the Software,
+	and to permit persons to whom the Software is furnished to do so,
+	subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+	MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+	IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR
+	ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+	CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+	WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+	The text above constitutes the entire oscpack license; however, 
+	the oscpack developer(s) also make the following non-binding requests:
+
+	Any person wishing to distribute modifications to the Software is
+	requested to send the modifications to the original developer so that
+	they can be incorporated into the canonical version. It is also 
+	requested that these non-binding requests be included whenever the
+	above license is reproduced.
+*/
+#include "OscMessageTemplate.h"
+
+#include <cstring>
+#include <string>
+
+#include "OscHostEndianness.h"
+
+
+namespace osc{
+
+// round up to the next highest multiple of 4. unless x is already a multiple of 4
+static inline std::size_t RoundUp4( std::size_t x ) 
+{
+    return (x + 3) & ~((std::size_t)0x03);
+}
+
+
+static std::size_t ArgumentSize( char typeTag )
+{
+    switch( typeTag ){
+        case TRUE_TYPE_TAG:
+        case FALSE_TYPE_TAG:
+        case NIL_TYPE_TAG:
+        case INFINITUM_TYPE_TAG:
+            return 0;
+
+        case INT32_TYPE_TAG:
+        case FLOAT_TYPE_TAG:
+        case CHAR_TYPE_TAG:
+        case RGBA_COLOR_TYPE_TAG:
+        case MIDI_MESSAGE_TYPE_TAG:
+            return 4;
+
+        case INT64_TYPE_TAG:
+        case TIME_TAG_TYPE_TAG:
+        case DOUBLE_TYPE_TAG:
+            return 8;
+
+        default:
+            throw UnsupportedTypeTagException();
+    }
+}
+
+
+void MessageTemplate::Init( const char *addressPattern, const char *typeTags )
+{
+    std::size_t typeTagCount = std::strlen( typeTags );
+
+    offsets_.resize( typeTagCount );
+
+    std::size_t argumentsSize = 0;
+    for( std::size_t i = 0; i < typeTagCount; ++i ){
+        offsets_[i] = argumentsSize;
+        argumentsSize += ArgumentSize( typeTags[i] );
+    }
+
+    std::size_t addressSize = RoundUp4( std::strlen( addressPattern ) + 1 );
+    std::size_t typeTagsSize = RoundUp4( typeTagCount + 2 ); // includes ',' and terminator
+    std::size_t headerSize = addressSize + typeTagsSize;
+
+    buffer_.assign( headerSize + argumentsSize, '\0' );
+
+    std::memcpy( &buffer_[0], addressPattern, std::strlen( addressPattern ) );
+
+    typeTagsOffset_ = addressSize + 1;
+    buffer_[ addressSize ] = ',';
+    std::memcpy( &buffer_[ typeTagsOffset_ ], typeTags, typeTagCount );
+
+    for( std::size_t i = 0; i < typeTagCount; ++i )
+        offsets_[i] += headerSize;
+}
+
+
+void MessageTemplate::SetAddressPattern( const char *addressPattern )
+{
+    std::size_t typeTagCount = offsets_.size();
+    std::string typeTags( buffer_.begin() + typeTagsOffset_, buffer_.begin() + typeTagsOffset_ + typeTagCount );
+    std::size_t argumentsOffset = (typeTagCount > 0) ? offsets_[0] : buffer_.size();
+    std::vector< char > arguments( buffer_.begin() + argumentsOffset, buffer_.end() );
+
+    Init( addressPattern, typeTags.c_str() );
+
+    if( !arguments.empty() )
+        std::memcpy( &buffer_[ offsets_[0] ], &arguments[0], arguments.size() );
+}
+
+
+void MessageTemplate::Store64( std::size_t i, const void *value )
+{
+    char *p = &buffer_[ offsets_[i] ];
+    const char *v = (const char*)value;
+
+#ifdef OSC_HOST_LITTLE_ENDIAN
+    for( int b = 0; b < 8; ++b )
+        p[b] = v[7 - b];
+#else
+    std::memcpy( p, v, 8 );
+#endif
+}
+
+} // namespace osc
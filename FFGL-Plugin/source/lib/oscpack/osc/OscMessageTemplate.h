@@ -0,0 +1,154 @@
+/*
+	oscpack -- Open Sound Control (OSC) packet manipulation library
+    http://www.rossbencina.com/code/oscpack
+
+    Copyright (c) 2004-2013 Ross Bencina <rossb@audiomulch.com>
+
+	Permission is hereby granted, free of charge, to any person obtaining
+	a copy of this software and associated documentation files
+	(the "Software"), to deal in the Software without restriction,
+	including without limitation the rights to use, copy, modify, merge,
+	publish, distribute, sublicense, and/or sell copies of the Software,
+	and to permit persons to whom the Software is furnished to do so,
+	subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+	MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+	IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR
+	ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+	CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+	WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+	The text above constitutes the entire oscpack license; however, 
+	the oscpack developer(s) also make the following non-binding requests:
+
+	Any person wishing to distribute modifications to the Software is
+	requested to send the modifications to the original developer so that
+	they can be incorporated into the canonical version. It is also 
+	requested that these non-binding requests be included whenever the
+	above license is reproduced.
+*/
+#ifndef INCLUDED_OSCPACK_OSCMESSAGETEMPLATE_H
+#define INCLUDED_OSCPACK_OSCMESSAGETEMPLATE_H
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+#include "OscTypes.h"
+#include "OscException.h"
+#include "OscByteOrder.h"
+
+
+namespace osc{
+
+class UnsupportedTypeTagException : public Exception{
+public:
+    UnsupportedTypeTagException( const char *w="type tag not supported in a message template" )
+        : Exception( w ) {}
+};
+
+
+// A preformatted OSC message for senders that always send the same shape of
+// message, e.g. one address followed by N floats. The address, type tags
+// and padding are written once by Init(); every argument then lives at a
+// fixed offset, so updating a value is a byte swap and a store, with no
+// space checks and no type tag bookkeeping. Data() and Size() can be passed
+// straight to a socket.
+//
+// Only fixed size argument types are supported: i f c r m h t d T F N I.
+// The setters check argument types with assert() only.
+
+class MessageTemplate{
+public:
+    MessageTemplate() : typeTagsOffset_( 0 ) {}
+    MessageTemplate( const char *addressPattern, const char *typeTags )
+        { Init( addressPattern, typeTags ); }
+
+    // typeTags is the list of argument types without the leading ','
+    // e.g. "fff". All arguments are initialized to zero / false.
+    void Init( const char *addressPattern, const char *typeTags );
+
+    // rewrites the address keeping the current argument types and values
+    void SetAddressPattern( const char *addressPattern );
+
+    const char *Data() const { return buffer_.empty() ? 0 : &buffer_[0]; }
+    std::size_t Size() const { return buffer_.size(); }
+
+    std::size_t ArgumentCount() const { return offsets_.size(); }
+    char TypeTag( std::size_t i ) const { return buffer_[ typeTagsOffset_ + i ]; }
+
+    void SetInt32( std::size_t i, int32 value )
+    {
+        assert( TypeTag(i) == INT32_TYPE_TAG );
+        SwapBigEndian32( &value, &buffer_[ offsets_[i] ], 1 );
+    }
+
+    void SetFloat( std::size_t i, float value )
+    {
+        assert( TypeTag(i) == FLOAT_TYPE_TAG );
+        SwapBigEndian32( &value, &buffer_[ offsets_[i] ], 1 );
+    }
+
+    void SetInt64( std::size_t i, int64 value )
+    {
+        assert( TypeTag(i) == INT64_TYPE_TAG );
+        Store64( i, &value );
+    }
+
+    void SetDouble( std::size_t i, double value )
+    {
+        assert( TypeTag(i) == DOUBLE_TYPE_TAG );
+        Store64( i, &value );
+    }
+
+    // T and F have no payload, a bool is stored by rewriting its type tag
+    void SetBool( std::size_t i, bool value )
+    {
+        assert( TypeTag(i) == TRUE_TYPE_TAG || TypeTag(i) == FALSE_TYPE_TAG );
+        buffer_[ typeTagsOffset_ + i ] = (char)(value ? TRUE_TYPE_TAG : FALSE_TYPE_TAG);
+    }
+
+    // sets count consecutive float arguments starting at argument first,
+    // swapping the whole run at once
+    void SetFloats( std::size_t first, const float *values, std::size_t count )
+    {
+        assert( HasTypeTags( first, count, FLOAT_TYPE_TAG ) );
+        SwapBigEndian32( values, &buffer_[ offsets_[first] ], count );
+    }
+
+    void SetInt32s( std::size_t first, const int32 *values, std::size_t count )
+    {
+        assert( HasTypeTags( first, count, INT32_TYPE_TAG ) );
+        SwapBigEndian32( values, &buffer_[ offsets_[first] ], count );
+    }
+
+private:
+    std::vector< char > buffer_;
+    std::vector< std::size_t > offsets_; // byte offset of each argument in buffer_
+    std::size_t typeTagsOffset_;         // offset of the first type tag, after ','
+
+    void Store64( std::size_t i, const void *value );
+
+    // true if arguments [first, first+count) exist and are all of type tag,
+    // the run is then contiguous 4 byte values
+    bool HasTypeTags( std::size_t first, std::size_t count, char tag ) const
+    {
+        if( first + count > offsets_.size() )
+            return false;
+        for( std::size_t i = first; i < first + count; ++i )
+            if( TypeTag(i) != tag )
+                return false;
+        return true;
+    }
+};
+
+} // namespace osc
+
+#endif /* INCLUDED_OSCPACK_OSCMESSAGETEMPLATE_H */
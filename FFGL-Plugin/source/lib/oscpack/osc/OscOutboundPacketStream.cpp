@@ -35,6 +35,7 @@
 	above license is reproduced.
 */
 #include "OscOutboundPacketStream.h"
+#include "OscMessageTemplate.h"
 
 #if defined(__WIN32__) || defined(WIN32) || defined(_WIN32)
 #include <malloc.h> // for alloca
@@ -678,6 +679,27 @@ OutboundPacketStream& OutboundPacketStream::operator<<( const ArrayTerminator& r
     return *this;
 }
 
+OutboundPacketStream& OutboundPacketStream::operator<<( const MessageTemplate& rhs )
+{
+    if( IsMessageInProgress() )
+        throw MessageInProgressException();
+
+    std::size_t required = Size() + ((ElementSizeSlotRequired())?4:0) + rhs.Size();
+    if( required > Capacity() )
+        throw OutOfBufferMemoryException();
+
+    messageCursor_ = BeginElement( messageCursor_ );
+
+    std::memcpy( messageCursor_, rhs.Data(), rhs.Size() );
+    messageCursor_ += rhs.Size();
+
+    argumentCurrent_ = messageCursor_;
+
+    EndElement( messageCursor_ );
+
+    return *this;
+}
+
 } // namespace osc
 
 
@@ -45,6 +45,8 @@
 
 namespace osc{
 
+class MessageTemplate;
+
 class OutOfBufferMemoryException : public Exception{
 public:
     OutOfBufferMemoryException( const char *w="out of buffer memory" )
@@ -124,6 +126,10 @@ public:
     OutboundPacketStream& operator<<( const ArrayInitiator& rhs );
     OutboundPacketStream& operator<<( const ArrayTerminator& rhs );
 
+    // appends a complete preformatted message, e.g. as a bundle element;
+    // must not be used while a message is in progress
+    OutboundPacketStream& operator<<( const MessageTemplate& rhs );
+
 private:
 
     char *BeginElement( char *beginPtr );
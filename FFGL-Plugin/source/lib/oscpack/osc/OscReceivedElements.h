@@ -213,6 +213,7 @@ public:
 		, argumentPtr_( argumentPtr ) {}
 
     friend class ReceivedMessageArgumentIterator;
+    friend class ReceivedMessageDecoder;
     
 	char TypeTag() const { return *typeTagPtr_; }
 
@@ -473,6 +474,8 @@ public:
 
 class ReceivedMessage{
     void Init( const char *bundle, osc_bundle_element_size_t size );
+
+    friend class ReceivedMessageDecoder;
 public:
     explicit ReceivedMessage( const ReceivedPacket& packet );
     explicit ReceivedMessage( const ReceivedBundleElement& bundleElement );
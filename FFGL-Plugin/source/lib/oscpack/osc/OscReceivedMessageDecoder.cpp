@@ -0,0 +1,127 @@
+/*
+	oscpack -- Open Sound Control (OSC) packet manipulation library
+    http://www.rossbencina.com/code/oscpack
+
+    Copyright (c) 2004-2013 Ross Bencina <rossb@audiomulch.com>
+
+	Permission is hereby granted, free of charge, to any person obtaining
+	a copy of this software and associated documentation files
+	(the "Software"), to deal in the Software without restriction,
+	including without limitation the rights to use, copy, modify, merge,
+	publish, distribute, sublicense, and/or sell copies of the Software,
+	and to permit persons to whom the Software is furnished to do so,
+	subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+	MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+	IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR
+	ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+	CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+	WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+	The text above constitutes the entire oscpack license; however, 
+	the oscpack developer(s) also make the following non-binding requests:
+
+	Any person wishing to distribute modifications to the Software is
+	requested to send the modifications to the original developer so that
+	they can be incorporated into the canonical version. It is also 
+	requested that these non-binding requests be included whenever the
+	above license is reproduced.
+*/
+#include "OscReceivedMessageDecoder.h"
+
+#include <cstring>
+
+
+namespace osc{
+
+
+ReceivedMessageDecoder::ReceivedMessageDecoder( const ReceivedMessage& message )
+    : typeTag_( message.typeTagsBegin_ )
+    , argument_( message.arguments_ )
+{
+}
+
+
+std::size_t ReceivedMessageDecoder::RunLength( char typeTag ) const
+{
+    if( typeTag_ == 0 )
+        return 0;
+
+    const char *p = typeTag_;
+    while( *p == typeTag )
+        ++p;
+
+    return (std::size_t)(p - typeTag_);
+}
+
+
+void ReceivedMessageDecoder::ReadRun32( char typeTag, void *dest, std::size_t count )
+{
+    if( count == 0 )
+        return;
+
+    if( Eos() )
+        throw MissingArgumentException();
+
+    std::size_t available = RunLength( typeTag );
+    if( available < count ){
+        // distinguish a short message from a type mismatch inside the run
+        if( std::strlen( typeTag_ ) < count )
+            throw MissingArgumentException();
+        throw WrongArgumentTypeException();
+    }
+
+    SwapBigEndian32( argument_, dest, count );
+
+    typeTag_ += count;
+    argument_ += count * 4;
+}
+
+
+void ReceivedMessageDecoder::ReadFloats( float *dest, std::size_t count )
+{
+    ReadRun32( FLOAT_TYPE_TAG, dest, count );
+}
+
+
+void ReceivedMessageDecoder::ReadInt32s( int32 *dest, std::size_t count )
+{
+    ReadRun32( INT32_TYPE_TAG, dest, count );
+}
+
+
+void ReceivedMessageDecoder::ReadBlob( Blob& blob )
+{
+    if( Eos() )
+        throw MissingArgumentException();
+
+    ReceivedMessageArgument argument( typeTag_, argument_ );
+    argument.AsBlob( blob.data, blob.size );
+
+    Skip( 1 );
+}
+
+
+void ReceivedMessageDecoder::Skip( std::size_t count )
+{
+    // reuse the iterator so that variable length arguments are stepped
+    // over exactly as ReceivedMessageArgumentIterator does
+    ReceivedMessageArgumentIterator i( typeTag_, argument_ );
+    for( std::size_t n = 0; n < count; ++n ){
+        if( i->typeTagPtr_ == 0 || *i->typeTagPtr_ == '\0' )
+            throw MissingArgumentException();
+        ++i;
+    }
+
+    typeTag_ = i->typeTagPtr_;
+    argument_ = i->argumentPtr_;
+}
+
+} // namespace osc
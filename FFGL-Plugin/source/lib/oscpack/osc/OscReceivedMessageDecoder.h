@@ -0,0 +1,137 @@
+/*
+	oscpack -- Open Sound Control (OSC) packet manipulation library
+    http://www.rossbencina.com/code/oscpack
+
+    Copyright (c) 2004-2013 Ross Bencina <rossb@audiomulch.com>
+
+	Permission is hereby granted, free of charge, to any person obtaining
+	a copy of this software and associated documentation files
+	(the "Software"), to deal in the Software without restriction,
+	including without limitation the rights to use, copy, modify, merge,
+	publish, distribute, sublicense, and/or sell copies of the Software,
+	and to permit persons to whom the Software is furnished to do so,
+	subject to the following conditions:
+
+	The above copyright notice and this permission notice shall be
+	included in all copies or substantial portions of the Software.
+
+	THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,
+	EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF
+	MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.
+	IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR
+	ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF
+	CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION
+	WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+/*
+	The text above constitutes the entire oscpack license; however, 
+	the oscpack developer(s) also make the following non-binding requests:
+
+	Any person wishing to distribute modifications to the Software is
+	requested to send the modifications to the original developer so that
+	they can be incorporated into the canonical version. It is also 
+	requested that these non-binding requests be included whenever the
+	above license is reproduced.
+*/
+#ifndef INCLUDED_OSCPACK_OSCRECEIVEDMESSAGEDECODER_H
+#define INCLUDED_OSCPACK_OSCRECEIVEDMESSAGEDECODER_H
+
+#include <cstddef>
+
+#include "OscReceivedElements.h"
+#include "OscByteOrder.h"
+
+
+namespace osc{
+
+// Read-only view of a blob payload as an array of big-endian 32 bit values
+// (int32, uint32 or float). The view points into the packet, so it is only
+// valid while the packet buffer is.
+template< class T >
+class BlobArrayView{
+public:
+    BlobArrayView( const char *data, std::size_t count )
+        : data_( data )
+        , count_( count ) {}
+
+    std::size_t Size() const { return count_; }
+    const void *Data() const { return data_; }
+
+    T operator[]( std::size_t i ) const
+    {
+        T result;
+        SwapBigEndian32( data_ + i * 4, &result, 1 );
+        return result;
+    }
+
+    void CopyTo( T *dest ) const { SwapBigEndian32( data_, dest, count_ ); }
+
+private:
+    const char *data_;
+    std::size_t count_;
+};
+
+
+// Sequential decoder over the arguments of a ReceivedMessage, for messages
+// that carry long runs of the same type such as parameter arrays.
+// ReceivedMessage has already validated the whole message, so each bulk
+// read only scans the type tags once and then converts the run in one go
+// instead of checking and swapping argument by argument.
+//
+// Throws MissingArgumentException if there are fewer arguments left than
+// requested and WrongArgumentTypeException on a type mismatch; in both
+// cases the decoder position is left unchanged.
+
+class ReceivedMessageDecoder{
+public:
+    explicit ReceivedMessageDecoder( const ReceivedMessage& message );
+
+    // end of arguments
+    bool Eos() const { return typeTag_ == 0 || *typeTag_ == '\0'; }
+
+    // type tag of the next argument, '\0' at the end
+    char NextTypeTag() const { return Eos() ? '\0' : *typeTag_; }
+
+    // number of consecutive arguments with the given type tag from the
+    // current position
+    std::size_t RunLength( char typeTag ) const;
+
+    void ReadFloats( float *dest, std::size_t count );
+    void ReadInt32s( int32 *dest, std::size_t count );
+
+    // reads a blob argument without copying it
+    void ReadBlob( Blob& blob );
+
+    // reads a blob argument holding an array of 32 bit values; if the blob
+    // size is not a multiple of 4 the decoder is left on the blob
+    template< class T >
+    BlobArrayView<T> ReadBlobArray()
+    {
+        const char *typeTag = typeTag_;
+        const char *argument = argument_;
+
+        Blob blob;
+        ReadBlob( blob );
+        if( blob.size % 4 != 0 ){
+            typeTag_ = typeTag;
+            argument_ = argument;
+            throw MalformedMessageException( "blob size is not a multiple of the element size" );
+        }
+
+        return BlobArrayView<T>( (const char*)blob.data, (std::size_t)blob.size / 4 );
+    }
+
+    // skips count arguments of any type
+    void Skip( std::size_t count = 1 );
+
+private:
+    const char *typeTag_;
+    const char *argument_;
+
+    void ReadRun32( char typeTag, void *dest, std::size_t count );
+};
+
+} // namespace osc
+
+#endif /* INCLUDED_OSCPACK_OSCRECEIVEDMESSAGEDECODER_H */
@@ -0,0 +1,151 @@
+/*
+
+	spoutCapture.h
+
+	Binary capture of the traffic of a sharing session, to replay it
+	later without a host : frames, sender events and OSC packets, each
+	with its time in microseconds from the start of the capture.
+
+	Frames are recorded at one of three levels :
+
+	- SPOUT_CAPTURE_HEADERS : size only, the default
+	- SPOUT_CAPTURE_HASHES  : size and a 64 bit FNV-1a hash of the pixels
+	- SPOUT_CAPTURE_PIXELS  : size, hash and the RGBA pixels, hash only for
+	                          frames too large for a record (about 4096x4096)
+
+	File layout, little endian :
+
+		"SPCP", version (uint32), level (uint32)
+		then records : type (uint8), time (uint64), size (uint32), payload
+
+		frame  : width, height (uint32), hash (uint64), pixels (uint8),
+		         width*height*4 bytes of RGBA if pixels is 1
+		sender : event, width, height, name length (uint32), name
+		osc    : the packet as sent
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#pragma once
+
+#ifndef __spoutCapture__
+#define __spoutCapture__
+
+#include "SpoutCommon.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#define SPOUT_CAPTURE_VERSION 1
+
+enum SpoutCaptureLevel {
+	SPOUT_CAPTURE_HEADERS = 0,
+	SPOUT_CAPTURE_HASHES,
+	SPOUT_CAPTURE_PIXELS
+};
+
+enum SpoutCaptureRecordType {
+	SPOUT_CAPTURE_FRAME = 1,
+	SPOUT_CAPTURE_SENDER,
+	SPOUT_CAPTURE_OSC
+};
+
+enum SpoutCaptureSenderEvent {
+	SPOUT_SENDER_CREATED = 1,
+	SPOUT_SENDER_RESIZED,
+	SPOUT_SENDER_RELEASED,
+	SPOUT_RECEIVER_CONNECTED,
+	SPOUT_RECEIVER_RELEASED
+};
+
+struct spoutCaptureRecord {
+	int type;
+	unsigned long long time;         // microseconds from the start
+	unsigned int width, height;      // frame, sender
+	unsigned long long hash;         // frame, 0 at the headers level
+	int event;                       // sender
+	std::string name;                // sender
+	std::vector<unsigned char> data; // frame pixels if recorded, osc packet
+};
+
+class SPOUT_DLLEXP spoutCaptureWriter {
+
+	public:
+
+		spoutCaptureWriter();
+		~spoutCaptureWriter();
+
+		bool Open(const char *path, int level = SPOUT_CAPTURE_HEADERS);
+		void Close();
+		bool IsOpen();
+		int GetLevel();
+
+		// Pixels are RGBA, may be NULL at the headers level
+		void WriteFrame(unsigned int width, unsigned int height, const unsigned char *pixels);
+		void WriteSenderEvent(int event, const char *name, unsigned int width, unsigned int height);
+		void WriteOsc(const char *data, size_t size);
+
+		static unsigned long long Hash(const unsigned char *data, size_t size);
+
+	protected:
+
+		void WriteHeader(int type, unsigned int size);
+
+		FILE *m_file;
+		int m_level;
+		std::chrono::steady_clock::time_point m_start;
+
+};
+
+class SPOUT_DLLEXP spoutCaptureReader {
+
+	public:
+
+		spoutCaptureReader();
+		~spoutCaptureReader();
+
+		bool Open(const char *path);
+		void Close();
+		bool IsOpen();
+		int GetLevel();
+
+		// Next record, false at the end of the file or on a damaged record
+		bool Read(spoutCaptureRecord &record);
+
+		// Back to the first record
+		void Rewind();
+
+	protected:
+
+		FILE *m_file;
+		int m_level;
+		long m_firstRecord;
+
+};
+
+#endif
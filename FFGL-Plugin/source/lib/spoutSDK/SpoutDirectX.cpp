@@ -34,6 +34,9 @@
 //		16.01.17	- Add WriteDX9surface
 //		23.01.17	- pEventQuery->Release() for writeDX9surface
 //		24.04.17	- Added MessageBox error warnings in CreateSharedDX11Texture
+//		19.10.26	- Registry DWORD reads cached while a spoutSharedContext is alive
+//					- CheckAccess wait recorded as a trace event
+//					- access mutex messages through spoutLog instead of printf
 //
 // ====================================================================================
 /*
@@ -63,6 +66,9 @@
 */
 
 #include "spoutDirectX.h"
+#include "SpoutSharedContext.h"
+#include "SpoutTrace.h"
+#include "SpoutLog.h"
 
 spoutDirectX::spoutDirectX() {
 
@@ -566,7 +572,7 @@ bool spoutDirectX::CreateAccessMutex(const char *name, HANDLE &hAccessMutex)
 	else {
 		errnum = GetLastError();
 		if(errnum == ERROR_INVALID_HANDLE) {
-			printf("access mutex [%s] invalid handle\n", szMutexName);
+			SPOUT_LOG_WARNING("access mutex [%s] invalid handle", szMutexName);
 		}
 	}
 
@@ -599,7 +605,10 @@ bool spoutDirectX::CheckAccess(HANDLE hAccessMutex)
 		return true; 
 	}
 
-	dwWaitResult = WaitForSingleObject(hAccessMutex, 67); // 4 frames at 60fps
+	{
+		SPOUT_TRACE("DirectX::CheckAccess");
+		dwWaitResult = WaitForSingleObject(hAccessMutex, 67); // 4 frames at 60fps
+	}
 	if (dwWaitResult == WAIT_OBJECT_0 ) {
 		// The state of the object is signalled.
 		return true;
@@ -607,16 +616,16 @@ bool spoutDirectX::CheckAccess(HANDLE hAccessMutex)
 	else {
 		switch(dwWaitResult) {
 			case WAIT_ABANDONED : // Could return here
-				printf("CheckAccess : WAIT_ABANDONED\n");
+				SPOUT_LOG_WARNING("CheckAccess : WAIT_ABANDONED");
 				break;
 			case WAIT_TIMEOUT : // The time-out interval elapsed, and the object's state is nonsignaled.
-				printf("CheckAccess : WAIT_TIMEOUT\n");
+				SPOUT_LOG_WARNING("CheckAccess : WAIT_TIMEOUT");
 				break;
 			case WAIT_FAILED : // Could use call GetLastError
-				printf("CheckAccess : WAIT_FAILED\n");
+				SPOUT_LOG_WARNING("CheckAccess : WAIT_FAILED");
 				break;
 			default :
-				printf("CheckAccess : unknown error\n");
+				SPOUT_LOG_WARNING("CheckAccess : unknown error");
 				break;
 		}
 	}
@@ -942,6 +951,12 @@ bool spoutDirectX::ReadDwordFromRegistry(DWORD *pValue, const char *subkey, cons
 	HKEY  hRegKey;
 	LONG  regres;
 	DWORD  dwSize, dwKey;  
+	bool  bFound = false;
+
+	// 19.10.26 - use the process wide cache if there is a shared context
+	spoutSharedContext* pContext = spoutSharedContext::Get();
+	if(pContext && pContext->ReadDwordSetting(subkey, valuename, *pValue, bFound))
+		return bFound;
 
 	dwSize = MAX_PATH;
 
@@ -951,12 +966,14 @@ bool spoutDirectX::ReadDwordFromRegistry(DWORD *pValue, const char *subkey, cons
 		// Read the key DWORD value
 		regres = RegQueryValueExA(hRegKey, valuename, NULL, &dwKey, (BYTE*)pValue, &dwSize);
 		RegCloseKey(hRegKey);
-		if(regres == ERROR_SUCCESS)
-			return true;
+		bFound = (regres == ERROR_SUCCESS);
 	}
 
+	if(pContext)
+		pContext->StoreDwordSetting(subkey, valuename, bFound ? *pValue : 0, bFound);
+
 	// Just quit if the key does not exist
-	return false;
+	return bFound;
 
 }
 
@@ -986,8 +1003,13 @@ bool spoutDirectX::WriteDwordToRegistry(DWORD dwValue, const char *subkey, const
 		RegCloseKey(hRegKey); // Done with the key
     }
 
-	if(regres == ERROR_SUCCESS)
+	if(regres == ERROR_SUCCESS) {
+		// Keep the shared cache in step
+		spoutSharedContext* pContext = spoutSharedContext::Get();
+		if(pContext)
+			pContext->StoreDwordSetting(subkey, valuename, dwValue, true);
 		return true;
+	}
 	else
 		return false;
 
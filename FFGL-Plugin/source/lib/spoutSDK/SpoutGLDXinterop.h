@@ -89,12 +89,13 @@ class SPOUT_DLLEXP spoutGLDXinterop {
 		bool UnloadTexturePixels(GLuint TextureID, GLuint TextureTarget, 
 								 unsigned int width, unsigned int height,
 								 unsigned char *data, GLenum glFormat = GL_RGBA,
-								 bool bInvert = false, GLuint HostFBO = 0);
+								 bool bInvert = false, GLuint HostFBO = 0,
+								 GLenum glType = GL_UNSIGNED_BYTE);
 
 		bool LoadTexturePixels(GLuint TextureID, GLuint TextureTarget, 
 							   unsigned int width, unsigned int height,
 							   const unsigned char *data, GLenum glFormat = GL_RGBA, 
-							   bool bInvert = false);
+							   bool bInvert = false, GLenum glType = GL_UNSIGNED_BYTE);
 
 		// DX9
 		bool m_bUseDX9; // Use DX11 (default) or DX9
@@ -110,6 +111,12 @@ class SPOUT_DLLEXP spoutGLDXinterop {
 		bool m_bUseMemory; // Use memoryshare
 		bool SetMemoryShareMode(bool bMem = true);
 		bool GetMemoryShareMode();
+		bool m_bForceMemory; // memoryshare for this object whatever the registry says
+		void ForceMemoryShare(bool bForce = true); // the registry is not written
+
+		// Memoryshare pixels are rgba bytes, or packed 10 bit for an RGB10A2 sender
+		void SetMemoryFormat(DWORD dwFormat); // DXGI format of the sender information
+		DWORD GetMemoryFormat();
 
 		int  GetShareMode(); // 0 - memory, 1 - cpu, 2 - texture
 		bool SetShareMode(int mode);
@@ -168,7 +175,7 @@ class SPOUT_DLLEXP spoutGLDXinterop {
 		void InitTexture(GLuint &texID, GLenum GLformat, unsigned int width, unsigned int height);
 		void CheckOpenGLTexture(GLuint &texID, GLenum GLformat,
 								unsigned int newWidth, unsigned int newHeight,
-								unsigned int &texWidth, unsigned int &texHeight);
+								unsigned int &texWidth, unsigned int &texHeight, GLenum &texFormat);
 		void SaveOpenGLstate(unsigned int width, unsigned int height, bool bFitWindow = true);
 		void RestoreOpenGLstate();
 		GLuint GetGLtextureID(); // Get OpenGL shared texture ID
@@ -204,6 +211,8 @@ protected:
 		GLuint            m_TexID;         // Local texture used for memoryshare and CPU functions
 		unsigned int      m_TexWidth;      // width and height of local texture
 		unsigned int      m_TexHeight;     // height of local texture
+		GLenum            m_TexFormat;     // internal format of local texture
+		DWORD             m_MemoryFormat;  // DXGI format of the memoryshare pixels
 
 		// PBO support
 		GLuint m_pbo[2];
@@ -227,6 +236,7 @@ protected:
 	
 		// Interop
 		HANDLE m_hInteropDevice; // handle to the DX/GL interop device
+		bool   m_bSharedInteropDevice; // the interop device belongs to the spoutSharedContext
 		HANDLE m_hInteropObject; // handle to the DX/GL interop object (the shared texture)
 		HANDLE m_hAccessMutex;   // Texture access mutex lock handle
 
@@ -268,6 +278,7 @@ protected:
 		bool ReadMemoryPixels  (unsigned char *pixels, unsigned int width, unsigned int height, GLenum glFormat = GL_RGBA, bool bInvert = false);
 		bool DrawSharedMemory  (float max_x = 1.0, float max_y = 1.0, float aspect = 1.0, bool bInvert = false);
 		bool DrawToSharedMemory(GLuint TextureID, GLuint TextureTarget, unsigned int width, unsigned int height, float max_x = 1.0, float max_y = 1.0, float aspect = 1.0, bool bInvert = false, GLuint HostFBO = 0);
+		void GetMemoryPixelFormat(GLenum &internalFormat, GLenum &glType);
 
 		// Utility
 		bool OpenDeviceKey(const char* key, int maxsize, char *description, char *version);
@@ -0,0 +1,227 @@
+/*
+
+	spoutGLState.cpp
+
+	Shadow of the OpenGL bindings changed by the interop functions.
+	See spoutGLState.h
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "SpoutGLState.h"
+#include "SpoutGLextensions.h"
+
+// Binding not known, the next bind is always passed on
+#define GLSTATE_UNKNOWN 0xFFFFFFFF
+
+// Texture targets tracked, others are always passed on
+#define GLSTATE_TEXTURE_SLOTS 4
+
+struct spoutGLBindings {
+	int depth; // nested Begin calls
+	unsigned int hostFBO;
+	unsigned int fbo;
+	unsigned int textureTargets[GLSTATE_TEXTURE_SLOTS];
+	unsigned int textures[GLSTATE_TEXTURE_SLOTS];
+	unsigned int packBuffer;
+	unsigned int unpackBuffer;
+	unsigned int issued;
+	unsigned int skipped;
+};
+
+static thread_local spoutGLBindings t_GLBindings = { 0, 0, GLSTATE_UNKNOWN, { 0, 0, 0, 0 }, { 0, 0, 0, 0 }, GLSTATE_UNKNOWN, GLSTATE_UNKNOWN, 0, 0 };
+
+// Shadow entry of a texture target, NULL if all the slots are taken
+static unsigned int* TextureSlot(spoutGLBindings &state, unsigned int target)
+{
+	for(int i = 0; i < GLSTATE_TEXTURE_SLOTS; i++) {
+		if(state.textureTargets[i] == target)
+			return &state.textures[i];
+		if(state.textureTargets[i] == 0) {
+			state.textureTargets[i] = target;
+			state.textures[i] = GLSTATE_UNKNOWN;
+			return &state.textures[i];
+		}
+	}
+	return NULL;
+}
+
+// Pass the bind on unless the shadow already has it, outside a frame
+// scope the shadow is not trusted
+static bool NeedsBind(spoutGLBindings &state, unsigned int *shadow, unsigned int value)
+{
+	if(state.depth > 0 && shadow && *shadow == value) {
+		state.skipped++;
+		return false;
+	}
+	if(shadow)
+		*shadow = state.depth > 0 ? value : GLSTATE_UNKNOWN;
+	state.issued++;
+	return true;
+}
+
+static unsigned int* BufferSlot(spoutGLBindings &state, unsigned int target)
+{
+	if(target == GL_PIXEL_PACK_BUFFER) return &state.packBuffer;
+	if(target == GL_PIXEL_UNPACK_BUFFER) return &state.unpackBuffer;
+	return NULL;
+}
+
+//
+// Frame scope
+//
+
+void spoutGLState::Begin(unsigned int HostFBO)
+{
+	spoutGLBindings &state = t_GLBindings;
+	if(state.depth++ > 0)
+		return;
+
+	// Whatever the host left bound is not known
+	state.hostFBO = HostFBO;
+	Invalidate();
+}
+
+void spoutGLState::End()
+{
+	spoutGLBindings &state = t_GLBindings;
+	if(state.depth == 0)
+		return;
+
+	if(state.depth == 1)
+		Restore();
+
+	if(--state.depth == 0)
+		Invalidate();
+}
+
+bool spoutGLState::InFrame()
+{
+	return t_GLBindings.depth > 0;
+}
+
+void spoutGLState::Restore()
+{
+	spoutGLBindings &state = t_GLBindings;
+	if(state.depth == 0)
+		return;
+
+	// Only what was bound in this frame needs putting back
+	if(state.fbo != GLSTATE_UNKNOWN && state.fbo != state.hostFBO) {
+		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, state.hostFBO);
+		state.issued++;
+		state.fbo = state.hostFBO;
+	}
+
+	for(int i = 0; i < GLSTATE_TEXTURE_SLOTS && state.textureTargets[i] != 0; i++) {
+		if(state.textures[i] != GLSTATE_UNKNOWN && state.textures[i] != 0) {
+			glBindTexture(state.textureTargets[i], 0);
+			state.issued++;
+			state.textures[i] = 0;
+		}
+	}
+
+	if(state.packBuffer != GLSTATE_UNKNOWN && state.packBuffer != 0) {
+		glBindBufferEXT(GL_PIXEL_PACK_BUFFER, 0);
+		state.issued++;
+		state.packBuffer = 0;
+	}
+	if(state.unpackBuffer != GLSTATE_UNKNOWN && state.unpackBuffer != 0) {
+		glBindBufferEXT(GL_PIXEL_UNPACK_BUFFER, 0);
+		state.issued++;
+		state.unpackBuffer = 0;
+	}
+}
+
+void spoutGLState::Invalidate()
+{
+	spoutGLBindings &state = t_GLBindings;
+	state.fbo = GLSTATE_UNKNOWN;
+	for(int i = 0; i < GLSTATE_TEXTURE_SLOTS; i++)
+		state.textures[i] = GLSTATE_UNKNOWN;
+	state.packBuffer = GLSTATE_UNKNOWN;
+	state.unpackBuffer = GLSTATE_UNKNOWN;
+}
+
+//
+// Binds
+//
+
+void spoutGLState::BindFramebuffer(unsigned int fbo)
+{
+	spoutGLBindings &state = t_GLBindings;
+	if(NeedsBind(state, &state.fbo, fbo))
+		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, fbo);
+}
+
+void spoutGLState::RestoreFramebuffer(unsigned int HostFBO)
+{
+	// Restore() binds the host fbo of the frame
+	if(t_GLBindings.depth > 0)
+		return;
+	BindFramebuffer(HostFBO);
+}
+
+void spoutGLState::BindTexture(unsigned int target, unsigned int texture)
+{
+	spoutGLBindings &state = t_GLBindings;
+	if(NeedsBind(state, TextureSlot(state, target), texture))
+		glBindTexture(target, texture);
+}
+
+void spoutGLState::UnbindTexture(unsigned int target)
+{
+	// Left bound until Restore(), the next use binds what it needs
+	if(t_GLBindings.depth > 0)
+		return;
+	BindTexture(target, 0);
+}
+
+void spoutGLState::BindBuffer(unsigned int target, unsigned int buffer)
+{
+	// Not deferred, a pixel buffer left bound changes the meaning of
+	// the pointers passed to glReadPixels and glTexSubImage2D
+	spoutGLBindings &state = t_GLBindings;
+	if(NeedsBind(state, BufferSlot(state, target), buffer))
+		glBindBufferEXT(target, buffer);
+}
+
+//
+// Counts
+//
+
+void spoutGLState::GetCounts(unsigned int &issued, unsigned int &skipped)
+{
+	issued = t_GLBindings.issued;
+	skipped = t_GLBindings.skipped;
+}
+
+void spoutGLState::ResetCounts()
+{
+	t_GLBindings.issued = 0;
+	t_GLBindings.skipped = 0;
+}
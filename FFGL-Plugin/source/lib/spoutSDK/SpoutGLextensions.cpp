@@ -15,6 +15,7 @@
 //			12.08.16	- Removed "isExtensionSupported" (https://github.com/leadedge/Spout2/issues/19)
 //			13.01.17	- Removed try/catch from wglDXRegisterObjectNV calls
 //						- Clean up #ifdefs in all functions - return true if FBO of PBO are defined elsewhere
+//			19.10.26	- USE_MOCK_GL installs the spoutMockGL functions instead of the driver ones
 //
 
 		Copyright (c) 2014-2017, Lynn Jarvis. All rights reserved.
@@ -306,6 +307,11 @@ unsigned int loadGLextensions() {
 
 	// printf("loadGLextensions\n");
 
+#ifdef USE_MOCK_GL
+	// Recording OpenGL in host memory, see spoutMockGL.h
+	caps = spoutMockGL::Install();
+#else
+
 #ifdef USE_GLEW
 	InitializeGlew(); // probably needs failure check
 #endif
@@ -347,6 +353,7 @@ unsigned int loadGLextensions() {
 	if (loadInteropExtensions()) {
 		caps |= GLEXT_SUPPORT_NVINTEROP;
 	}
+#endif
 
 	return caps;
 
@@ -0,0 +1,217 @@
+/*
+
+	spoutLockStats.cpp
+
+	Contention counters for the named shared memory mutexes.
+	See spoutLockStats.h
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "SpoutLockStats.h"
+
+#include <stdio.h>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <mutex>
+
+struct spoutLockEntry {
+	std::atomic<unsigned int> acquires;
+	std::atomic<unsigned int> contended;
+	std::atomic<unsigned int> timeouts;
+	std::atomic<unsigned int> failures;
+	std::atomic<long long> totalWaitUsec;
+	std::atomic<long long> maxWaitUsec;
+	std::atomic<long long> maxHoldUsec;
+	std::atomic<unsigned int> waitHistogram[LOCK_WAIT_BINS];
+};
+
+struct spoutLockEntries {
+	std::mutex mutex;
+	std::map<std::string, spoutLockEntry*> entries;
+	~spoutLockEntries() {
+		for(auto itr = entries.begin(); itr != entries.end(); itr++)
+			delete itr->second;
+	}
+};
+
+static spoutLockEntries g_LockEntries;
+static const unsigned int g_BinLimits[LOCK_WAIT_BINS] = LOCK_WAIT_BIN_LIMITS;
+
+static void ResetEntry(spoutLockEntry *entry)
+{
+	entry->acquires = 0;
+	entry->contended = 0;
+	entry->timeouts = 0;
+	entry->failures = 0;
+	entry->totalWaitUsec = 0;
+	entry->maxWaitUsec = 0;
+	entry->maxHoldUsec = 0;
+	for(int i = 0; i < LOCK_WAIT_BINS; i++)
+		entry->waitHistogram[i] = 0;
+}
+
+static void StoreMax(std::atomic<long long> &value, long long sample)
+{
+	long long current = value.load(std::memory_order_relaxed);
+	while(sample > current && !value.compare_exchange_weak(current, sample, std::memory_order_relaxed));
+}
+
+
+spoutLockEntry* spoutLockStats::Find(const char *name)
+{
+	if(!name) return NULL;
+
+	std::lock_guard<std::mutex> lock(g_LockEntries.mutex);
+
+	spoutLockEntry* &entry = g_LockEntries.entries[name];
+	if(entry == NULL) {
+		entry = new spoutLockEntry;
+		ResetEntry(entry);
+	}
+
+	return entry;
+}
+
+long long spoutLockStats::Now()
+{
+	return std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void spoutLockStats::RecordWait(spoutLockEntry *entry, bool bContended, DWORD dwWaitResult, long long waitUsec)
+{
+	if(!entry) return;
+
+	if(dwWaitResult == WAIT_OBJECT_0)
+		entry->acquires++;
+	else if(dwWaitResult == WAIT_TIMEOUT)
+		entry->timeouts++;
+	else
+		entry->failures++;
+
+	if(bContended)
+		entry->contended++;
+
+	entry->totalWaitUsec += waitUsec;
+	StoreMax(entry->maxWaitUsec, waitUsec);
+
+	int bin = 0;
+	while(bin < LOCK_WAIT_BINS - 1 && waitUsec > (long long)g_BinLimits[bin])
+		bin++;
+	entry->waitHistogram[bin]++;
+}
+
+void spoutLockStats::RecordHold(spoutLockEntry *entry, long long holdUsec)
+{
+	if(!entry) return;
+
+	StoreMax(entry->maxHoldUsec, holdUsec);
+}
+
+void spoutLockStats::GetNames(std::vector<std::string> &names)
+{
+	std::lock_guard<std::mutex> lock(g_LockEntries.mutex);
+
+	names.clear();
+	for(auto itr = g_LockEntries.entries.begin(); itr != g_LockEntries.entries.end(); itr++)
+		names.push_back(itr->first);
+}
+
+bool spoutLockStats::Get(const char *name, spoutLockCounters &counters)
+{
+	if(!name) return false;
+
+	std::lock_guard<std::mutex> lock(g_LockEntries.mutex);
+
+	auto itr = g_LockEntries.entries.find(name);
+	if(itr == g_LockEntries.entries.end())
+		return false;
+
+	const spoutLockEntry *entry = itr->second;
+	counters.acquires = entry->acquires;
+	counters.contended = entry->contended;
+	counters.timeouts = entry->timeouts;
+	counters.failures = entry->failures;
+	counters.totalWaitMsec = (double)entry->totalWaitUsec / 1000.0;
+	counters.maxWaitMsec = (double)entry->maxWaitUsec / 1000.0;
+	counters.maxHoldMsec = (double)entry->maxHoldUsec / 1000.0;
+	for(int i = 0; i < LOCK_WAIT_BINS; i++)
+		counters.waitHistogram[i] = entry->waitHistogram[i];
+
+	return true;
+}
+
+unsigned int spoutLockStats::GetBinLimit(int bin)
+{
+	if(bin < 0 || bin >= LOCK_WAIT_BINS) return 0;
+	return g_BinLimits[bin];
+}
+
+bool spoutLockStats::Write(const char *path)
+{
+	FILE *file = NULL;
+	if(fopen_s(&file, path, "w") != 0 || file == NULL)
+		return false;
+
+	std::vector<std::string> names;
+	GetNames(names);
+
+	for(size_t i = 0; i < names.size(); i++) {
+		spoutLockCounters counters;
+		if(!Get(names[i].c_str(), counters))
+			continue;
+
+		fprintf(file, "[%s]\n", names[i].c_str());
+		fprintf(file, "acquires %u\ncontended %u\ntimeouts %u\nfailures %u\n",
+			counters.acquires, counters.contended, counters.timeouts, counters.failures);
+		fprintf(file, "total wait %.3f ms\nmax wait %.3f ms\nmax hold %.3f ms\n",
+			counters.totalWaitMsec, counters.maxWaitMsec, counters.maxHoldMsec);
+
+		fprintf(file, "wait histogram");
+		for(int bin = 0; bin < LOCK_WAIT_BINS; bin++) {
+			if(g_BinLimits[bin] > 0)
+				fprintf(file, " <=%uus:%u", g_BinLimits[bin], counters.waitHistogram[bin]);
+			else
+				fprintf(file, " more:%u", counters.waitHistogram[bin]);
+		}
+		fprintf(file, "\n\n");
+	}
+
+	fclose(file);
+
+	return true;
+}
+
+void spoutLockStats::Reset()
+{
+	std::lock_guard<std::mutex> lock(g_LockEntries.mutex);
+
+	for(auto itr = g_LockEntries.entries.begin(); itr != g_LockEntries.entries.end(); itr++)
+		ResetEntry(itr->second);
+}
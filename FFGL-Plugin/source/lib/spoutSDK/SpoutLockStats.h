@@ -0,0 +1,103 @@
+/*
+
+	spoutLockStats.h
+
+	Contention counters for the named shared memory mutexes.
+
+	SpoutSharedMemory reports every Lock and Unlock here, counters are
+	kept per mapping name (sender names list, active sender, sender
+	info, memoryshare frames) and summed over all the objects of the
+	process using that name :
+
+	- acquires, and how many of them found the mutex already held
+	- timeouts and other failures to lock
+	- total and maximum wait, and a histogram of wait times
+	- maximum time the mutex was held
+
+	Counting is always on, it costs two clock reads and a few atomic
+	increments per lock. Read the counters with Get or dump them all
+	to a text file with Write.
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#pragma once
+
+#ifndef __spoutLockStats__
+#define __spoutLockStats__
+
+#include "SpoutCommon.h"
+#include <windowsx.h>
+#include <string>
+#include <vector>
+
+// Wait time histogram, upper bounds of the bins in microseconds.
+// The last bin gets everything above, timeouts included.
+#define LOCK_WAIT_BINS 10
+#define LOCK_WAIT_BIN_LIMITS { 10, 50, 100, 500, 1000, 2000, 5000, 10000, 20000, 0 }
+
+struct spoutLockCounters {
+	unsigned int acquires;     // successful locks
+	unsigned int contended;    // locks that had to wait for another holder
+	unsigned int timeouts;     // waits that gave up
+	unsigned int failures;     // abandoned or failed waits
+	double totalWaitMsec;
+	double maxWaitMsec;
+	double maxHoldMsec;
+	unsigned int waitHistogram[LOCK_WAIT_BINS];
+};
+
+struct spoutLockEntry; // counters of one mapping name
+
+class SPOUT_DLLEXP spoutLockStats {
+
+	public:
+
+		// Entry for a mapping name, created on first use and kept
+		// for the life of the process
+		static spoutLockEntry* Find(const char *name);
+
+		// Microseconds, for the times passed to the Record functions
+		static long long Now();
+
+		// Outcome of WaitForSingleObject on the mapping mutex
+		static void RecordWait(spoutLockEntry *entry, bool bContended, DWORD dwWaitResult, long long waitUsec);
+		static void RecordHold(spoutLockEntry *entry, long long holdUsec);
+
+		static void GetNames(std::vector<std::string> &names);
+		static bool Get(const char *name, spoutLockCounters &counters);
+		static unsigned int GetBinLimit(int bin); // 0 for the last bin
+
+		// One block per mapping name, false if the file can't be written
+		static bool Write(const char *path);
+
+		// Zero the counters of all the names
+		static void Reset();
+
+};
+
+#endif
@@ -26,6 +26,8 @@
 //		13.01.17	- Add SetCPUmode, GetCPUmode, SetBufferMode, GetBufferMode
 //					- Add HostFBO arg to DrawSharedTexture
 //		15.01.17	- Add GetShareMode, SetShareMode
+//		19.10.26	- Add GetSenderFormat, GetSenderFormats
+//		19.10.26	- Add ForceMemoryShare
 //
 // ====================================================================================
 /*
@@ -167,6 +169,20 @@ bool SpoutReceiver::GetSenderInfo(const char* sendername, unsigned int &width, u
 }
 
 
+//---------------------------------------------------------
+DWORD SpoutReceiver::GetSenderFormat()
+{
+	return spout.GetSenderFormat();
+}
+
+
+//---------------------------------------------------------
+bool SpoutReceiver::GetSenderFormats(const char* sendername, DWORD &dwFormats)
+{
+	return spout.GetSenderFormats(sendername, dwFormats);
+}
+
+
 //---------------------------------------------------------
 bool SpoutReceiver::SelectSenderPanel(const char* message)
 {
@@ -185,6 +201,12 @@ bool SpoutReceiver::GetMemoryShareMode()
 	return spout.GetMemoryShareMode();
 }
 
+//---------------------------------------------------------
+void SpoutReceiver::ForceMemoryShare(bool bForce)
+{
+	spout.ForceMemoryShare(bForce);
+}
+
 //---------------------------------------------------------
 bool SpoutReceiver::SetCPUmode(bool bCPU)
 {
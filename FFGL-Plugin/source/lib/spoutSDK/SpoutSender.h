@@ -53,7 +53,9 @@ class SPOUT_DLLEXP SpoutSender {
 	bool SetDX9(bool bDX9 = true); // set to use DirectX 9 (default is DirectX 11)
 	bool GetDX9();
 	bool SetMemoryShareMode(bool bMem = true);
+	bool SetSenderFormats(DWORD dwFormats); // formats this sender supports, see spoutFormat.h
 	bool GetMemoryShareMode();
+	void ForceMemoryShare(bool bForce = true); // this sender only, the registry is not written
 	bool SetCPUmode(bool bCPU = true);
 	bool GetCPUmode();
 	int  GetShareMode();
@@ -42,6 +42,9 @@
 	03.07-16 - Use helper functions for conversion of 64bit HANDLE to unsigned __int32
 			   and unsigned __int32 to 64bit HANDLE
 			   https://msdn.microsoft.com/en-us/library/aa384267%28VS.85%29.aspx
+	19.10.26 - CreateSenderSet error through spoutLog instead of printf
+	19.10.26 - SetSenderInfo keeps the fields it does not set
+			 - Added SetSenderFormats and GetSenderFormats, see spoutFormat.h
 
 
 	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -70,6 +73,8 @@
 
 */
 #include "spoutSenderNames.h"
+#include "SpoutLog.h"
+#include "SpoutFormat.h"
 #include <assert.h>
 
 spoutSenderNames::spoutSenderNames() {
@@ -440,6 +445,9 @@ bool spoutSenderNames::SetSenderInfo(const char* sendername, unsigned int width,
 	{
 		return false;
 	}
+
+	// Keep the usage, description and partner id
+	memcpy((void *)&info, (void *)pBuf, sizeof(SharedTextureInfo) );
 	
 	info.width       = (unsigned __int32)width;
 	info.height      = (unsigned __int32)height;
@@ -450,7 +458,6 @@ bool spoutSenderNames::SetSenderInfo(const char* sendername, unsigned int width,
 #endif
 	// info.shareHandle = (unsigned __int32)dxShareHandle; 
 	info.format      = (unsigned __int32)dwFormat;
-	// Usage not used
 
 	memcpy((void *)pBuf, (void *)&info, sizeof(SharedTextureInfo) );
 
@@ -799,7 +806,7 @@ bool spoutSenderNames::CreateSenderSet()
 
 	SpoutCreateResult result = m_senderNames.Create("SpoutSenderNames", m_MaxSenders*SpoutMaxSenderNameLen);
 	if(result == SPOUT_CREATE_FAILED) {
-		printf("spoutSenderNames::CreateSenderSet()\n    SPOUT_CREATE_FAILED\n");
+		SPOUT_LOG_ERROR("spoutSenderNames::CreateSenderSet() : SPOUT_CREATE_FAILED");
 		return false;
 	}
 
@@ -916,6 +923,44 @@ bool spoutSenderNames::getSharedInfo(const char* sharedMemoryName, SharedTexture
 } // end getSharedInfo
 
 
+//
+// Formats a sender can carry, published in the usage field of its information.
+// Only the process that created the sender can set them.
+//
+bool spoutSenderNames::SetSenderFormats(const char* sendername, DWORD dwFormats)
+{
+	auto foundSender = m_senders->find(sendername);
+	if(foundSender == m_senders->end())
+		return false;
+
+	char *pBuf = foundSender->second->Lock();
+	if(!pBuf)
+		return false;
+
+	((SharedTextureInfo *)pBuf)->usage = SPOUT_FORMAT_TAG | (dwFormats & ~SPOUT_FORMAT_TAG_MASK);
+
+	foundSender->second->Unlock();
+
+	return true;
+}
+
+// False if the sender is not there, the legacy formats if it has not published any
+bool spoutSenderNames::GetSenderFormats(const char* sendername, DWORD &dwFormats)
+{
+	SharedTextureInfo info;
+
+	if(!getSharedInfo(sendername, &info))
+		return false;
+
+	if((info.usage & SPOUT_FORMAT_TAG_MASK) == SPOUT_FORMAT_TAG)
+		dwFormats = info.usage & ~SPOUT_FORMAT_TAG_MASK;
+	else
+		dwFormats = SPOUT_FORMAT_LEGACY;
+
+	return true;
+}
+
+
 // 12.06.15 - Added to allow direct modification of a sender's information in shared memory
 bool spoutSenderNames::setSharedInfo(const char* sharedMemoryName, SharedTextureInfo* info) 
 {
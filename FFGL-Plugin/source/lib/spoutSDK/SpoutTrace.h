@@ -0,0 +1,111 @@
+/*
+
+	spoutTrace.h
+
+	Timeline events for Chrome trace / Perfetto.
+
+	SPOUT_TRACE("name") records the time spent in the enclosing scope as a
+	complete event of the calling thread. Every thread writes to its own
+	ring, the most recent events are kept when it is full. Write() dumps
+	the events of all the threads as Chrome trace JSON, to be loaded in
+	chrome://tracing or ui.perfetto.dev.
+
+	Timestamps come from the performance counter, which is the same for
+	all the processes of a machine, and events carry the process id: the
+	traceEvents arrays of a host trace and of a client trace can simply be
+	concatenated to see both sides on one timeline.
+
+	Recording is off until Enable(true). Build with SPOUT_TRACING defined
+	as 0 to compile the trace points out. Event names must be string
+	literals, only the pointer is stored.
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#pragma once
+
+#ifndef __spoutTrace__
+#define __spoutTrace__
+
+#include "SpoutCommon.h"
+
+#ifndef SPOUT_TRACING
+#define SPOUT_TRACING 1
+#endif
+
+class SPOUT_DLLEXP spoutTrace {
+
+	public:
+
+		static void Enable(bool bEnable);
+		static bool IsEnabled();
+
+		// Shown as the process name in the viewer
+		static void SetProcessName(const char *name);
+
+		// Performance counter ticks
+		static long long Now();
+		static void Record(const char *name, long long start, long long end);
+
+		// Dump all the recorded events, false if the file can't be written.
+		// Threads still recording may tear the event being written.
+		static bool Write(const char *path);
+
+		// Forget the recorded events
+		static void Clear();
+
+};
+
+class spoutTraceScope {
+
+	public:
+
+		spoutTraceScope(const char *name) {
+			m_name = spoutTrace::IsEnabled() ? name : 0;
+			if(m_name) m_start = spoutTrace::Now();
+		}
+
+		~spoutTraceScope() {
+			if(m_name) spoutTrace::Record(m_name, m_start, spoutTrace::Now());
+		}
+
+	private:
+
+		const char *m_name;
+		long long m_start;
+
+};
+
+#if SPOUT_TRACING
+#define SPOUT_TRACE_CONCAT2(a, b) a##b
+#define SPOUT_TRACE_CONCAT(a, b) SPOUT_TRACE_CONCAT2(a, b)
+#define SPOUT_TRACE(name) spoutTraceScope SPOUT_TRACE_CONCAT(spoutTraceScope_, __LINE__)(name)
+#else
+#define SPOUT_TRACE(name)
+#endif
+
+#endif
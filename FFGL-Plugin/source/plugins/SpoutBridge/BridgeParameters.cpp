@@ -0,0 +1,224 @@
+//**********************************************************************************
+//
+// BridgeParameters.cpp
+//
+// Parameter schema and current values of the SpoutBridge plugin.
+//
+//**********************************************************************************
+
+#include "BridgeParameters.h"
+
+#include <FreeFrame.h>
+
+#include <fstream>
+#include <sstream>
+#include <stdlib.h>
+
+// FreeFrame parameter names are at most 16 characters
+#define MAX_PARAMETER_NAME_LENGTH 16
+
+//**********************************************************************************
+//**********************************************************************************
+
+static std::string Trim(const std::string& s)
+{
+	size_t begin = s.find_first_not_of(" \t\r\n");
+	if (begin == std::string::npos)
+	{
+		return "";
+	}
+
+	size_t end = s.find_last_not_of(" \t\r\n");
+	return s.substr(begin, end - begin + 1);
+}
+
+static bool ParseType(const std::string& typeName, unsigned int& type)
+{
+	if (typeName == "float") type = FF_TYPE_STANDARD;
+	else if (typeName == "bool") type = FF_TYPE_BOOLEAN;
+	else if (typeName == "event") type = FF_TYPE_EVENT;
+	else if (typeName == "xpos") type = FF_TYPE_XPOS;
+	else if (typeName == "ypos") type = FF_TYPE_YPOS;
+	else return false;
+
+	return true;
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+BridgeParameters::BridgeParameters()
+{
+	SetDefaultSchema();
+}
+
+void BridgeParameters::Clear()
+{
+	names.clear();
+	types.clear();
+	defaults.clear();
+	minValues.clear();
+	maxValues.clear();
+	values.clear();
+	dirtyBits.clear();
+	dirtyCount = 0;
+}
+
+void BridgeParameters::Add(const std::string& name, unsigned int type, float defaultValue, float minValue, float maxValue)
+{
+	// the host only knows normalized values
+	float normalizedDefault = (maxValue != minValue) ? (defaultValue - minValue) / (maxValue - minValue) : 0.0f;
+	if (normalizedDefault < 0.0f) normalizedDefault = 0.0f;
+	if (normalizedDefault > 1.0f) normalizedDefault = 1.0f;
+
+	names.push_back(name.substr(0, MAX_PARAMETER_NAME_LENGTH));
+	types.push_back(type);
+	defaults.push_back(normalizedDefault);
+	minValues.push_back(minValue);
+	maxValues.push_back(maxValue);
+	values.push_back(normalizedDefault);
+
+	if (dirtyBits.size() * 32 < names.size())
+	{
+		dirtyBits.push_back(0);
+	}
+}
+
+void BridgeParameters::SetDefaultSchema()
+{
+	Clear();
+
+	Add("Move X", FF_TYPE_STANDARD, 0.5f, 0.0f, 1.0f);
+	Add("Move Y", FF_TYPE_STANDARD, 0.5f, 0.0f, 1.0f);
+	Add("Rotate", FF_TYPE_STANDARD, 0.5f, 0.0f, 1.0f);
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+bool BridgeParameters::LoadSchema(const char* path)
+{
+	std::ifstream file(path);
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	BridgeParameters loaded;
+	loaded.Clear();
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		line = Trim(line);
+		if (line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+
+		std::vector<std::string> fields;
+		std::stringstream stream(line);
+		std::string field;
+		while (std::getline(stream, field, ','))
+		{
+			fields.push_back(Trim(field));
+		}
+
+		unsigned int type;
+		if (fields.size() < 2 || fields[0].empty() || !ParseType(fields[1], type))
+		{
+			continue; // skip malformed lines
+		}
+
+		float defaultValue = (fields.size() > 2) ? (float)atof(fields[2].c_str()) : 0.0f;
+		float minValue = (fields.size() > 3) ? (float)atof(fields[3].c_str()) : 0.0f;
+		float maxValue = (fields.size() > 4) ? (float)atof(fields[4].c_str()) : 1.0f;
+		int count = (fields.size() > 5) ? atoi(fields[5].c_str()) : 1;
+
+		if (count <= 1)
+		{
+			loaded.Add(fields[0], type, defaultValue, minValue, maxValue);
+		}
+		else
+		{
+			for (int i = 0; i < count; i++)
+			{
+				// keep the index visible even when the base name must be cut
+				std::string suffix = " " + std::to_string(i + 1);
+				std::string name = fields[0].substr(0, MAX_PARAMETER_NAME_LENGTH - suffix.size()) + suffix;
+				loaded.Add(name, type, defaultValue, minValue, maxValue);
+			}
+		}
+	}
+
+	if (loaded.GetCount() == 0)
+	{
+		return false;
+	}
+
+	*this = loaded;
+	return true;
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+bool BridgeParameters::SetValue(unsigned int index, float value)
+{
+	if (values[index] == value)
+	{
+		return false;
+	}
+
+	values[index] = value;
+
+	unsigned int& word = dirtyBits[index / 32];
+	unsigned int bit = 1u << (index % 32);
+	if ((word & bit) == 0)
+	{
+		word |= bit;
+		dirtyCount++;
+	}
+
+	return true;
+}
+
+void BridgeParameters::MarkAllDirty()
+{
+	for (unsigned int i = 0; i < dirtyBits.size(); i++)
+	{
+		dirtyBits[i] = 0xFFFFFFFFu;
+	}
+
+	// don't leave bits set past the last parameter
+	if (GetCount() % 32 != 0)
+	{
+		dirtyBits.back() = (1u << (GetCount() % 32)) - 1;
+	}
+
+	dirtyCount = GetCount();
+}
+
+void BridgeParameters::TakeDirtyIndices(std::vector<unsigned int>& indices)
+{
+	indices.clear();
+
+	for (unsigned int w = 0; w < dirtyBits.size() && dirtyCount > 0; w++)
+	{
+		unsigned int word = dirtyBits[w];
+		for (unsigned int b = 0; word != 0; b++, word >>= 1)
+		{
+			if (word & 1)
+			{
+				indices.push_back(w * 32 + b);
+			}
+		}
+
+		dirtyBits[w] = 0;
+	}
+
+	dirtyCount = 0;
+}
+
+//**********************************************************************************
+//**********************************************************************************
@@ -0,0 +1,74 @@
+//**********************************************************************************
+//
+// BridgeParameters.h
+//
+// Parameter schema and current values of the SpoutBridge plugin.
+//
+// The schema (names, types, ranges, defaults) is read from a text file placed
+// next to the plugin binary, so that new effects don't need a plugin rebuild.
+// Values are kept as parallel arrays with one dirty bit each, so that only the
+// parameters the host actually changed are forwarded to the client.
+//
+//**********************************************************************************
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+class BridgeParameters
+{
+public:
+	BridgeParameters();
+
+	// The three floats the plugin always had (Move X, Move Y, Rotate)
+	void SetDefaultSchema();
+
+	// Loads a schema file, one parameter per line:
+	//
+	//   name, type [, default [, min [, max [, count]]]]
+	//
+	// type is one of float, bool, event, xpos, ypos. default, min and max are
+	// in client units (defaults 0, 0, 1), the host always works in [0, 1].
+	// count > 1 declares an array, expanded to "name 1" ... "name N".
+	// Empty lines and lines starting with # are ignored.
+	// Returns false, leaving the current schema untouched, if the file can't
+	// be read or contains no valid parameter.
+	bool LoadSchema(const char* path);
+
+	unsigned int GetCount() const { return (unsigned int)names.size(); }
+
+	const char* GetName(unsigned int index) const { return names[index].c_str(); }
+	unsigned int GetType(unsigned int index) const { return types[index]; }
+	float GetDefault(unsigned int index) const { return defaults[index]; }
+
+	// Normalized [0, 1] value, as seen by the host
+	float GetValue(unsigned int index) const { return values[index]; }
+
+	// Value mapped to the [min, max] range of the schema, as seen by the client
+	float GetScaledValue(unsigned int index) const { return minValues[index] + values[index] * (maxValues[index] - minValues[index]); }
+
+	// Stores a normalized value, returns true (and marks the parameter dirty)
+	// only if it differs from the current one
+	bool SetValue(unsigned int index, float value);
+
+	bool HasDirtyValues() const { return dirtyCount > 0; }
+	void MarkAllDirty();
+
+	// Collects the indices of dirty parameters and clears their dirty bits
+	void TakeDirtyIndices(std::vector<unsigned int>& indices);
+
+private:
+	std::vector<std::string> names;
+	std::vector<unsigned int> types;
+	std::vector<float> defaults;
+	std::vector<float> minValues;
+	std::vector<float> maxValues;
+	std::vector<float> values;
+
+	std::vector<unsigned int> dirtyBits; // one bit per parameter
+	unsigned int dirtyCount;
+
+	void Clear();
+	void Add(const std::string& name, unsigned int type, float defaultValue, float minValue, float maxValue);
+};
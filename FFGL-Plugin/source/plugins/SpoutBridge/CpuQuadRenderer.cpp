@@ -0,0 +1,101 @@
+//**********************************************************************************
+//
+// CpuQuadRenderer.cpp
+//
+//**********************************************************************************
+
+#include "CpuQuadRenderer.h"
+
+#include <math.h>
+
+CpuQuadRenderer::CpuQuadRenderer()
+{
+	target = nullptr;
+}
+
+void CpuQuadRenderer::SetTexture(unsigned int texture, const CpuImage* image)
+{
+	if (image != nullptr)
+	{
+		textures[texture] = image;
+	}
+	else
+	{
+		textures.erase(texture);
+	}
+}
+
+//**********************************************************************************
+// The quad is axis aligned: a pixel is drawn when its center is inside, with
+// the texture coordinates interpolated between the corners
+//**********************************************************************************
+
+void CpuQuadRenderer::Draw(unsigned int texture, const QuadParams& params)
+{
+	auto itr = textures.find(texture);
+	if (target == nullptr || itr == textures.end() || itr->second->width == 0 || itr->second->height == 0)
+	{
+		return;
+	}
+
+	const CpuImage& source = *itr->second;
+
+	float positions[8], texCoords[8];
+	GetQuad(params, positions, texCoords);
+
+	// Corner 0 is bottom left, corner 2 top right
+	float x0 = positions[0], y0 = positions[1], x1 = positions[4], y1 = positions[5];
+	float s0 = texCoords[0], t0 = texCoords[1], s1 = texCoords[4], t1 = texCoords[5];
+
+	for (unsigned int row = 0; row < target->height; row++)
+	{
+		float y = ((float)row + 0.5f) / (float)target->height * 2.0f - 1.0f;
+		if (y < y0 || y >= y1)
+		{
+			continue;
+		}
+		float t = t0 + (y - y0) / (y1 - y0) * (t1 - t0);
+
+		for (unsigned int column = 0; column < target->width; column++)
+		{
+			float x = ((float)column + 0.5f) / (float)target->width * 2.0f - 1.0f;
+			if (x < x0 || x >= x1)
+			{
+				continue;
+			}
+			float s = s0 + (x - x0) / (x1 - x0) * (s1 - s0);
+
+			Sample(source, s, t, &target->pixels[((size_t)row * target->width + column) * 4]);
+		}
+	}
+}
+
+void CpuQuadRenderer::Sample(const CpuImage& image, float s, float t, unsigned char* rgba)
+{
+	// Texel centers are at half integers
+	float x = s * (float)image.width - 0.5f;
+	float y = t * (float)image.height - 0.5f;
+
+	float fx = floorf(x), fy = floorf(y);
+	float wx = x - fx, wy = y - fy;
+
+	int maxX = (int)image.width - 1, maxY = (int)image.height - 1;
+	int xa = (int)fx, ya = (int)fy;
+	int xb = xa + 1, yb = ya + 1;
+	xa = xa < 0 ? 0 : (xa > maxX ? maxX : xa);
+	xb = xb < 0 ? 0 : (xb > maxX ? maxX : xb);
+	ya = ya < 0 ? 0 : (ya > maxY ? maxY : ya);
+	yb = yb < 0 ? 0 : (yb > maxY ? maxY : yb);
+
+	const unsigned char* p00 = &image.pixels[((size_t)ya * image.width + xa) * 4];
+	const unsigned char* p10 = &image.pixels[((size_t)ya * image.width + xb) * 4];
+	const unsigned char* p01 = &image.pixels[((size_t)yb * image.width + xa) * 4];
+	const unsigned char* p11 = &image.pixels[((size_t)yb * image.width + xb) * 4];
+
+	for (int c = 0; c < 4; c++)
+	{
+		float bottom = p00[c] + (p10[c] - p00[c]) * wx;
+		float top = p01[c] + (p11[c] - p01[c]) * wx;
+		rgba[c] = (unsigned char)(bottom + (top - bottom) * wy + 0.5f);
+	}
+}
@@ -0,0 +1,47 @@
+//**********************************************************************************
+//
+// CpuQuadRenderer.h
+//
+// Reference QuadRenderer drawing into memory images, for checking the
+// compositing without OpenGL. Pixels are RGBA, 4 bytes, rows from the bottom
+// like OpenGL textures. Sampling is bilinear with clamp to edge, like the
+// plugin textures.
+//
+//**********************************************************************************
+
+#pragma once
+
+#include "QuadRenderer.h"
+
+#include <stddef.h>
+#include <map>
+#include <vector>
+
+struct CpuImage
+{
+	unsigned int width, height;
+	std::vector<unsigned char> pixels;
+
+	CpuImage(unsigned int width = 0, unsigned int height = 0) : width(width), height(height), pixels((size_t)width * height * 4, 0) {}
+};
+
+class CpuQuadRenderer : public QuadRenderer
+{
+public:
+	CpuQuadRenderer();
+
+	bool Init() override { return true; }
+	void Release() override { textures.clear(); }
+
+	// Images are not copied, they must outlive the draws
+	void SetTexture(unsigned int texture, const CpuImage* image);
+	void SetTarget(CpuImage* image) { target = image; }
+
+	void Draw(unsigned int texture, const QuadParams& params) override;
+
+private:
+	static void Sample(const CpuImage& image, float s, float t, unsigned char* rgba);
+
+	std::map<unsigned int, const CpuImage*> textures;
+	CpuImage* target;
+};
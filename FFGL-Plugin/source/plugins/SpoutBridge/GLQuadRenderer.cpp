@@ -0,0 +1,226 @@
+//**********************************************************************************
+//
+// GLQuadRenderer.cpp
+//
+//**********************************************************************************
+
+#include "GLQuadRenderer.h"
+#include "SpoutLog.h"
+
+#include <string.h>
+#include <string>
+
+// Unit quad in triangle fan order, positions then texture coordinates,
+// scaled by the uniforms
+static const GLfloat unitQuad[16] =
+{
+	-1.0f, -1.0f,
+	-1.0f,  1.0f,
+	 1.0f,  1.0f,
+	 1.0f, -1.0f,
+
+	0.0f, 0.0f,
+	0.0f, 1.0f,
+	1.0f, 1.0f,
+	1.0f, 0.0f
+};
+
+// Bodies shared by the GLSL versions, the version line and the in/out
+// qualifiers are added by Compile
+static const char* vertexShaderBody =
+	"uniform vec2 positionScale;\n"
+	"uniform vec4 maxCoords;\n"
+	"IN vec2 position;\n"
+	"IN vec2 texCoord;\n"
+	"OUT vec2 uv;\n"
+	"void main()\n"
+	"{\n"
+	"	uv = maxCoords.xy + texCoord * maxCoords.zw;\n"
+	"	gl_Position = vec4(position * positionScale, 0.0, 1.0);\n"
+	"}\n";
+
+static const char* fragmentShaderBody =
+	"uniform sampler2D inputTexture;\n"
+	"IN vec2 uv;\n"
+	"FRAGMENT_OUTPUT\n"
+	"void main()\n"
+	"{\n"
+	"	FRAG_COLOR = TEXTURE(inputTexture, uv);\n"
+	"}\n";
+
+static const char* version150Defines =
+	"#version 150\n"
+	"#define TEXTURE texture\n"
+	"#define FRAG_COLOR fragColor\n"
+	"#define FRAGMENT_OUTPUT out vec4 fragColor;\n";
+
+static const char* version120Defines =
+	"#version 120\n"
+	"#define TEXTURE texture2D\n"
+	"#define FRAG_COLOR gl_FragColor\n"
+	"#define FRAGMENT_OUTPUT\n";
+
+//**********************************************************************************
+//**********************************************************************************
+
+GLQuadRenderer::GLQuadRenderer()
+{
+	positionScaleLocation = maxCoordsLocation = -1;
+	vertexArray = 0;
+	vertexBuffer = 0;
+}
+
+bool GLQuadRenderer::IsSupported()
+{
+	return GLEE_VERSION_2_0 && (GLEE_VERSION_3_0 || GLEE_ARB_vertex_array_object);
+}
+
+bool GLQuadRenderer::Init()
+{
+	Release();
+
+	if (!IsSupported())
+	{
+		return false;
+	}
+
+	// Core profile contexts only take 150, legacy ones may not
+	if (!Compile(true) && !Compile(false))
+	{
+		SPOUT_LOG_WARNING("GLQuadRenderer : cannot compile the quad shader");
+		return false;
+	}
+
+	GLint position = shader.FindAttribute("position");
+	GLint texCoord = shader.FindAttribute("texCoord");
+	positionScaleLocation = shader.FindUniform("positionScale");
+	maxCoordsLocation = shader.FindUniform("maxCoords");
+	if (position < 0 || texCoord < 0)
+	{
+		Release();
+		return false;
+	}
+
+	// Values Draw will compare against
+	positionScale[0] = positionScale[1] = 1.0f;
+	maxCoords[0] = maxCoords[1] = 0.0f;
+	maxCoords[2] = maxCoords[3] = 1.0f;
+
+	shader.BindShader();
+	glUniform1i(shader.FindUniform("inputTexture"), 0);
+	glUniform2fv(positionScaleLocation, 1, positionScale);
+	glUniform4fv(maxCoordsLocation, 1, maxCoords);
+	shader.UnbindShader();
+
+	glGenVertexArrays(1, &vertexArray);
+	glBindVertexArray(vertexArray);
+	glGenBuffers(1, &vertexBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(unitQuad), unitQuad, GL_STATIC_DRAW);
+	glEnableVertexAttribArray(position);
+	glVertexAttribPointer(position, 2, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)0);
+	glEnableVertexAttribArray(texCoord);
+	glVertexAttribPointer(texCoord, 2, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)(8 * sizeof(GLfloat)));
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	return true;
+}
+
+void GLQuadRenderer::Release()
+{
+	if (vertexBuffer != 0)
+	{
+		glDeleteBuffers(1, &vertexBuffer);
+		vertexBuffer = 0;
+	}
+	if (vertexArray != 0)
+	{
+		glDeleteVertexArrays(1, &vertexArray);
+		vertexArray = 0;
+	}
+	shader.FreeGLResources();
+}
+
+bool GLQuadRenderer::Compile(bool core)
+{
+	std::string defines = core ? version150Defines : version120Defines;
+	std::string vertexSource = defines + (core ? "#define IN in\n#define OUT out\n" : "#define IN attribute\n#define OUT varying\n") + vertexShaderBody;
+	std::string fragmentSource = defines + (core ? "#define IN in\n" : "#define IN varying\n") + fragmentShaderBody;
+
+	// A failed attempt leaves shaders attached, start from new objects
+	shader.FreeGLResources();
+	if (shader.Compile(vertexSource, fragmentSource) && shader.IsReady())
+	{
+		return true;
+	}
+
+	shader.FreeGLResources();
+	return false;
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+void GLQuadRenderer::Draw(unsigned int texture, const QuadParams& params)
+{
+	if (vertexArray == 0)
+	{
+		return;
+	}
+
+	GLfloat positions[8], texCoords[8];
+	GetQuad(params, positions, texCoords);
+
+	// Corner 2 is top right, corner 0 the texture coordinates origin
+	GLfloat newPositionScale[2] = { positions[4], positions[5] };
+	GLfloat newMaxCoords[4] = { texCoords[0], texCoords[1], texCoords[4] - texCoords[0], texCoords[5] - texCoords[1] };
+
+	shader.BindShader();
+
+	// Uniforms belong to the program, they only need setting when they change
+	if (memcmp(newPositionScale, positionScale, sizeof(positionScale)) != 0)
+	{
+		memcpy(positionScale, newPositionScale, sizeof(positionScale));
+		glUniform2fv(positionScaleLocation, 1, positionScale);
+	}
+	if (memcmp(newMaxCoords, maxCoords, sizeof(maxCoords)) != 0)
+	{
+		memcpy(maxCoords, newMaxCoords, sizeof(maxCoords));
+		glUniform4fv(maxCoordsLocation, 1, maxCoords);
+	}
+
+	glBindVertexArray(vertexArray);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glBindVertexArray(0);
+
+	shader.UnbindShader();
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+void FixedFunctionQuadRenderer::Draw(unsigned int texture, const QuadParams& params)
+{
+	GLfloat verts[8], tex_coords[8];
+	GetQuad(params, verts, tex_coords);
+
+	glPushMatrix();
+	glColor4f(1.f, 1.f, 1.f, 1.f);
+	glEnable(GL_TEXTURE_2D);
+	glBindTexture(GL_TEXTURE_2D, texture);
+
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glTexCoordPointer(2, GL_FLOAT, 0, tex_coords);
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(2, GL_FLOAT, 0, verts);
+	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+	glDisable(GL_TEXTURE_2D);
+	glPopMatrix();
+}
@@ -0,0 +1,59 @@
+//**********************************************************************************
+//
+// GLQuadRenderer.h
+//
+// OpenGL QuadRenderer backends.
+//
+// GLQuadRenderer compiles its shader and uploads a unit quad to a vertex
+// buffer once, in Init. The vertex array object keeps the attribute setup, so
+// a draw only binds the program, the vertex array and the texture, and sets
+// the quad uniforms when they differ from the previous draw. The default state
+// FFGL hosts expect is restored after each draw.
+//
+// FixedFunctionQuadRenderer is the legacy client array path, for contexts
+// without OpenGL 2 or vertex array objects.
+//
+//**********************************************************************************
+
+#pragma once
+
+#include <FFGLShader.h>
+#include "QuadRenderer.h"
+
+class GLQuadRenderer : public QuadRenderer
+{
+public:
+	GLQuadRenderer();
+
+	// Whether the current context has what Init needs
+	static bool IsSupported();
+
+	bool Init() override;
+	void Release() override;
+
+	void Draw(unsigned int texture, const QuadParams& params) override;
+
+private:
+	// GLSL 1.50 for core profiles, 1.20 otherwise
+	bool Compile(bool core);
+
+	FFGLShader shader;
+	GLint positionScaleLocation;
+	GLint maxCoordsLocation;
+	GLuint vertexArray;
+	GLuint vertexBuffer;
+
+	// Uniform values set by the last draw: quad half size, then texture
+	// coordinates origin and extent
+	GLfloat positionScale[2];
+	GLfloat maxCoords[4];
+};
+
+class FixedFunctionQuadRenderer : public QuadRenderer
+{
+public:
+	bool Init() override { return true; }
+	void Release() override {}
+
+	void Draw(unsigned int texture, const QuadParams& params) override;
+};
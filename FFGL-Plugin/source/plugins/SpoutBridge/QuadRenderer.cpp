@@ -0,0 +1,46 @@
+//**********************************************************************************
+//
+// QuadRenderer.cpp
+//
+//**********************************************************************************
+
+#include "QuadRenderer.h"
+
+void QuadRenderer::GetQuad(const QuadParams& params, float positions[8], float texCoords[8])
+{
+	// Letterbox or pillarbox to keep the source proportions
+	float halfWidth = 1.0f, halfHeight = 1.0f;
+	if (params.aspect > 1.0f)
+	{
+		halfHeight = 1.0f / params.aspect;
+	}
+	else if (params.aspect > 0.0f)
+	{
+		halfWidth = params.aspect;
+	}
+
+	float bottom = params.flip ? params.maxT : 0.0f;
+	float top = params.flip ? 0.0f : params.maxT;
+
+	const float corners[8] =
+	{
+		-halfWidth, -halfHeight,
+		-halfWidth,  halfHeight,
+		 halfWidth,  halfHeight,
+		 halfWidth, -halfHeight
+	};
+
+	const float coords[8] =
+	{
+		0.0f, bottom,
+		0.0f, top,
+		params.maxS, top,
+		params.maxS, bottom
+	};
+
+	for (int i = 0; i < 8; i++)
+	{
+		positions[i] = corners[i];
+		texCoords[i] = coords[i];
+	}
+}
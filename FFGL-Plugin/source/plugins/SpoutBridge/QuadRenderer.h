@@ -0,0 +1,40 @@
+//**********************************************************************************
+//
+// QuadRenderer.h
+//
+// Draws a texture over the current viewport, the way the plugin composites the
+// host and client frames.
+//
+// The quad geometry (used part of the texture, vertical flip, aspect ratio
+// fit) is computed by GetQuad for all the backends, the OpenGL ones draw it
+// and the CPU one rasterizes it into memory images, so the compositing can be
+// checked without a GPU. This header has no OpenGL dependency.
+//
+//**********************************************************************************
+
+#pragma once
+
+struct QuadParams
+{
+	float maxS, maxT;	// used part of the texture, in texture coordinates
+	bool flip;			// upside down
+	float aspect;		// source aspect over viewport aspect, 0 to fill the viewport
+
+	QuadParams(float maxS = 1.0f, float maxT = 1.0f) : maxS(maxS), maxT(maxT), flip(false), aspect(0.0f) {}
+};
+
+class QuadRenderer
+{
+public:
+	virtual ~QuadRenderer() {}
+
+	// OpenGL backends need the context current
+	virtual bool Init() = 0;
+	virtual void Release() = 0;
+
+	virtual void Draw(unsigned int texture, const QuadParams& params) = 0;
+
+	// Corners in triangle fan order, positions in normalized device
+	// coordinates and texture coordinates, 2 floats each
+	static void GetQuad(const QuadParams& params, float positions[8], float texCoords[8]);
+};
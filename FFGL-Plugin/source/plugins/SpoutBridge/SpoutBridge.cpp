@@ -57,11 +57,13 @@
 #include "SpoutBridge.h"
 #include "../../lib/ffgl/utilities/utilities.h"
 
-#define FFPARAM_MOVE_X  (0)
-#define FFPARAM_MOVE_Y	 (1)
-#define FFPARAM_ROTATE	 (2)
-#define FFPARAM_SHARING_NAME (3)
-#define FFPARAM_OSC_PORT (4)
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+#define SCHEMA_FILE_EXTENSION ".params"
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////
 //  Plugin information
@@ -80,30 +82,98 @@ static CFFGLPluginInfo PluginInfo(
 	"By Davide Mani 2017 - software@cogitamus.it"				// About
 );
 
+//**********************************************************************************
+// Path of the parameter schema file: the plugin binary path with its extension
+// replaced, e.g. "...\vfx\SpoutBridge.dll" -> "...\vfx\SpoutBridge.params"
+//**********************************************************************************
+
+static bool GetSchemaPath(char* path, size_t size)
+{
+#ifdef _WIN32
+	HMODULE module = NULL;
+	if (!GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT, (LPCSTR)&GetSchemaPath, &module))
+	{
+		return false;
+	}
+
+	DWORD length = GetModuleFileNameA(module, path, (DWORD)size);
+	if (length == 0 || length >= size)
+	{
+		return false;
+	}
+#else
+	Dl_info info;
+	if (!dladdr((void*)&GetSchemaPath, &info) || info.dli_fname == NULL || strlen(info.dli_fname) >= size)
+	{
+		return false;
+	}
+
+	strcpy(path, info.dli_fname);
+#endif
+
+	char* extension = strrchr(path, '.');
+	char* separator = strrchr(path, '\\') > strrchr(path, '/') ? strrchr(path, '\\') : strrchr(path, '/');
+	if (extension == NULL || extension < separator)
+	{
+		extension = path + strlen(path);
+	}
+
+	if ((size_t)(extension - path) + strlen(SCHEMA_FILE_EXTENSION) >= size)
+	{
+		return false;
+	}
+
+	strcpy(extension, SCHEMA_FILE_EXTENSION);
+	return true;
+}
+
+//**********************************************************************************
+// Diagnostics files named by environment variables. Trace recording and lock
+// statistics are process wide, the first instance turns tracing on and every
+// instance leaving writes what has been recorded so far
+//**********************************************************************************
+
+static const char* GetDiagnosticsPath(const char* variable)
+{
+	const char* path = getenv(variable);
+	return (path != NULL && path[0] != 0) ? path : NULL;
+}
+
 FFGLSpoutBridge::FFGLSpoutBridge()
 	:CFreeFrameGLPlugin(),
-	m_initResources(1),
-	m_inputTextureLocation(-1),
-	m_BrightnessLocation(-1)
+	m_initResources(1)
 {
+	// Messages are written by the log thread, not in ProcessOpenGL
+	spoutLog::Start();
+	if (GetDiagnosticsPath(LOG_PATH_VARIABLE) != NULL)
+	{
+		spoutLog::SetFile(GetDiagnosticsPath(LOG_PATH_VARIABLE));
+	}
+
 	// Input properties
 	SetMinInputs(1);
 	SetMaxInputs(1);
 
 	// Parameters
-	SetParamInfo(FFPARAM_MOVE_X, "Move X", FF_TYPE_STANDARD, 0.5f);
-	moveX = 0.5f;
-
-	SetParamInfo(FFPARAM_MOVE_Y, "Move Y", FF_TYPE_STANDARD, 0.5f);
-	moveY = 0.5f;
+	// Use the schema file next to the plugin if there is one, otherwise
+	// keep the built in Move X / Move Y / Rotate set
+	char schemaPath[1024];
+	if (GetSchemaPath(schemaPath, sizeof(schemaPath)) && parameters.LoadSchema(schemaPath))
+	{
+		SPOUT_LOG_NOTICE("Loaded %u parameters from %s", parameters.GetCount(), schemaPath);
+	}
 
-	SetParamInfo(FFPARAM_ROTATE, "Rotate", FF_TYPE_STANDARD, 0.5f);
-	rotate = 0.5f;
+	for (unsigned int i = 0; i < parameters.GetCount(); i++)
+	{
+		SetParamInfo(i, parameters.GetName(i), parameters.GetType(i), parameters.GetDefault(i));
+	}
 
-	SetParamInfo(FFPARAM_SHARING_NAME, "Name", FF_TYPE_TEXT, defaultName);
+	sharingNameParamIndex = parameters.GetCount();
+	SetParamInfo(sharingNameParamIndex, "Name", FF_TYPE_TEXT, defaultName);
 	strcpy(currentName, defaultName);
 
-	SetParamInfo(FFPARAM_OSC_PORT, "OSC Port", FF_TYPE_TEXT, OSC_DEFAULT_PORT);
+	oscPortParamIndex = parameters.GetCount() + 1;
+	SetParamInfo(oscPortParamIndex, "OSC Port", FF_TYPE_TEXT, OSC_DEFAULT_PORT);
 	currentOscPort = atoi(OSC_DEFAULT_PORT);
 
 	transmitSocket = new UdpTransmitSocket(IpEndpointName(OSC_ADDRESS, atoi(OSC_DEFAULT_PORT)));
@@ -111,10 +181,19 @@ FFGLSpoutBridge::FFGLSpoutBridge()
 	spoutSenderIsInitialized = spoutReceiverIsInitialized = false;
 
 	receivedTexture = 0;      // only used for memoryshare mode
+	localFormats = 0;
+	senderFormat = receivedFormat = 0;
+	quadRenderer = NULL;
 	receiverWidth = receiverHeight = -1;
 
 	sharingNameHasChanged = false;
 
+#if SPOUTBRIDGE_TIMING
+	lastStatsTime = 0;
+#endif
+
+	captureRequested = GetDiagnosticsPath(CAPTURE_PATH_VARIABLE) != NULL;
+
 	strcpy(spoutName, defaultName);
 	
 	strcpy(spoutSenderName, spoutName);
@@ -122,13 +201,31 @@ FFGLSpoutBridge::FFGLSpoutBridge()
 
 	strcpy(spoutReceiverName, spoutName);
 	strcat(spoutReceiverName, "ToHost");
+	receiverConnection.SetSenderName(spoutReceiverName);
+
+	UpdateParameterAddresses();
+	parameters.MarkAllDirty(); // the client gets every value once
+
+	if (GetDiagnosticsPath(TRACE_PATH_VARIABLE) != NULL && !spoutTrace::IsEnabled())
+	{
+		spoutTrace::SetProcessName("FFGL host");
+		spoutTrace::Enable(true);
+
+		SPOUT_LOG_NOTICE("Recording trace to %s", GetDiagnosticsPath(TRACE_PATH_VARIABLE));
+	}
+
+	if (captureRequested)
+	{
+		SPOUT_LOG_NOTICE("Capturing the session to %s", GetDiagnosticsPath(CAPTURE_PATH_VARIABLE));
+	}
 
-	sprintf(debugBuffer, "SpoutBridge plugin started");
-	OutputDebugString(debugBuffer);
+	SPOUT_LOG_NOTICE("SpoutBridge plugin started");
 }
 
 FFGLSpoutBridge::~FFGLSpoutBridge()
 {
+	spoutContext->EndUser(this);
+
 	// OpenGL context required
 	// ReleaseSender does nothing if there is no sender
 	if (wglGetCurrentContext())
@@ -147,21 +244,70 @@ FFGLSpoutBridge::~FFGLSpoutBridge()
 
 		receivedTexture = 0;
 	}
+
+	const char* tracePath = GetDiagnosticsPath(TRACE_PATH_VARIABLE);
+	if (tracePath != NULL && spoutTrace::IsEnabled())
+	{
+		if (!spoutTrace::Write(tracePath))
+		{
+			SPOUT_LOG_ERROR("Could not write trace to %s", tracePath);
+		}
+	}
+
+	const char* lockStatsPath = GetDiagnosticsPath(LOCK_STATS_PATH_VARIABLE);
+	if (lockStatsPath != NULL)
+	{
+		if (!spoutLockStats::Write(lockStatsPath))
+		{
+			SPOUT_LOG_ERROR("Could not write lock statistics to %s", lockStatsPath);
+		}
+	}
+
+	capture.Close();
+
+	// No context to free its objects here, DeInitGL did it
+	delete quadRenderer;
+
+	spoutLog::Stop();
 }
 
 FFResult FFGLSpoutBridge::InitGL(const FFGLViewportStruct *vp)
 {
 	m_initResources = 0;
 
-	sprintf(debugBuffer, "InitGL done");
-	OutputDebugString(debugBuffer);
+	delete quadRenderer;
+	quadRenderer = NULL;
+
+	if (GLQuadRenderer::IsSupported())
+	{
+		quadRenderer = new GLQuadRenderer();
+		if (!quadRenderer->Init())
+		{
+			delete quadRenderer;
+			quadRenderer = NULL;
+		}
+	}
+
+	if (quadRenderer == NULL)
+	{
+		SPOUT_LOG_NOTICE("Using fixed function drawing");
+		quadRenderer = new FixedFunctionQuadRenderer();
+		quadRenderer->Init();
+	}
+
+	SPOUT_LOG_NOTICE("InitGL done");
 
 	return FF_SUCCESS;
 }
 
 FFResult FFGLSpoutBridge::DeInitGL()
 {
-	m_shader.FreeGLResources();
+	if (quadRenderer != NULL)
+	{
+		quadRenderer->Release();
+		delete quadRenderer;
+		quadRenderer = NULL;
+	}
 
 	// OpenGL context required
 	if (wglGetCurrentContext())
@@ -184,6 +330,32 @@ FFResult FFGLSpoutBridge::ProcessOpenGL(ProcessOpenGLStruct *pGL)
 
 	FFGLTextureStruct &InputTexture = *(pGL->inputTextures[0]);
 
+	TIME_STAGE(frameTimer, stageTimers, STAGE_FRAME);
+	SPOUT_TRACE("ProcessOpenGL");
+
+	// Lets the shared context tell host frames apart, sender checks
+	// are then made once per frame for all the instances
+	spoutContext->BeginFrame(this);
+
+	// Spout skips the binds already in place until the end of the frame,
+	// the host fbo is bound again on return. Our own OpenGL work is
+	// preceded by spoutGLState::Restore()
+	spoutGLStateScope glState(pGL->HostFBO);
+
+	if (captureRequested)
+	{
+		OpenCapture();
+	}
+
+	// Forward the parameters the host changed since the previous frame
+	TIME_STAGE(parametersTimer, stageTimers, STAGE_PARAMETERS);
+	SendChangedParameters();
+	TIME_STAGE_END(parametersTimer);
+#if SPOUTBRIDGE_TIMING
+	// Outside the parameters stage, so that the stats do not time themselves
+	SendStageStats();
+#endif
+
 	// get the max s,t that correspond to the width, height
 	// of the used portion of the allocated texture space
 	FFGLTexCoords maxCoords = GetMaxGLTexCoords(InputTexture);
@@ -196,44 +368,77 @@ FFResult FFGLSpoutBridge::ProcessOpenGL(ProcessOpenGLStruct *pGL)
 	// Manage Spout sender initialization and such
 	//*********************************************************
 
-	if (!spoutSenderIsInitialized) // create a sender if not initialized yet
+	TIME_STAGE(senderTimer, stageTimers, STAGE_SENDER);
+
+	if (!spoutSenderIsInitialized || sharingNameHasChanged) // create a sender if not initialized yet or renamed
 	{
+		if (sharingNameHasChanged)
+		{
+			SPOUT_LOG_NOTICE("Sharing name changed, moving to sender [%s]", spoutSenderName);
+
+			// A sender can't be renamed, replace it in the same frame
+			if (spoutSenderIsInitialized)
+			{
+				spoutSender.ReleaseSender();
+				spoutSenderIsInitialized = false;
+				capture.WriteSenderEvent(SPOUT_SENDER_RELEASED, spoutSenderName, m_Width, m_Height);
+			}
+
+			// The client comes back under the new name as well
+			if (spoutReceiverIsInitialized)
+			{
+				spoutReceiver.ReleaseReceiver();
+				spoutReceiverIsInitialized = false;
+				capture.WriteSenderEvent(SPOUT_RECEIVER_RELEASED, spoutReceiverName, receiverWidth, receiverHeight);
+			}
+
+			sharingNameHasChanged = false;
+		}
+
 		// Set global width and height so any change can be tested
 		m_Width = (unsigned int)InputTexture.Width;
 		m_Height = (unsigned int)InputTexture.Height;
 
 		// Create a new sender
-		spoutSenderIsInitialized = spoutSender.CreateSender(spoutSenderName, m_Width, m_Height);
-		if (!spoutSenderIsInitialized)
+		if (!CreateSpoutSender(InputTexture.Handle))
 		{
-			sprintf(debugBuffer, "Error: could not create Spout sender");
-			OutputDebugString(debugBuffer);
+			return FF_SUCCESS;
 		}
-		else
+	}
+	else if (m_Width != (unsigned int)InputTexture.Width || // Has the texture size changed ?
+		     m_Height != (unsigned int)InputTexture.Height)
+	{
+		m_Width = (unsigned int)InputTexture.Width;
+		m_Height = (unsigned int)InputTexture.Height;
+
+		// Resize in place: only the shared texture is re-created, the sender
+		// registration and its shared memory are kept and no frame is dropped
+		if (!spoutSender.UpdateSender(spoutSenderName, m_Width, m_Height))
 		{
-			sprintf(debugBuffer, "Created new Spout sender[%s]\n", spoutSenderName);
-			OutputDebugString(debugBuffer);
+			SPOUT_LOG_ERROR("Could not resize sender [%s], releasing it", spoutSenderName);
+
+			spoutSender.ReleaseSender();
+			spoutSenderIsInitialized = false;
+			capture.WriteSenderEvent(SPOUT_SENDER_RELEASED, spoutSenderName, m_Width, m_Height);
+			return FF_SUCCESS; // created again on the next frame
 		}
 
-		return FF_SUCCESS; // give it one frame to initialize
+		SPOUT_LOG_NOTICE("Resized sender [%s] to %ux%u", spoutSenderName, m_Width, m_Height);
+		capture.WriteSenderEvent(SPOUT_SENDER_RESIZED, spoutSenderName, m_Width, m_Height);
 	}
-	else if (m_Width != (unsigned int)InputTexture.Width || // Has the texture size or sharing name changed ?
-		     m_Height != (unsigned int)InputTexture.Height ||
-			 sharingNameHasChanged)
-	{
-		sprintf(debugBuffer, "Release existing sender [%s]\n", spoutSenderName);
-		OutputDebugString(debugBuffer);
 
-		// Release existing sender
-		spoutSender.ReleaseSender();
-		spoutSenderIsInitialized = false;
-		sharingNameHasChanged = false;
-		return FF_SUCCESS; // return for initialization on the next frame
-	}
+	TIME_STAGE_END(senderTimer);
 
 	// Render the Freeframe texture into the shared texture
 	// Important - pass the FFGL host FBO to restore the binding because Spout uses a local fbo
+	TIME_STAGE(drawToSharedTimer, stageTimers, STAGE_DRAW_TO_SHARED);
 	spoutSender.DrawToSharedTexture(InputTexture.Handle, GL_TEXTURE_2D, m_Width, m_Height, (float)maxCoords.s, (float)maxCoords.t, 1.0f, false, pGL->HostFBO);
+	TIME_STAGE_END(drawToSharedTimer);
+
+	if (capture.IsOpen())
+	{
+		CaptureFrame(InputTexture);
+	}
 
 	//*********************************************************
 	// Manage Spout receiver initialization
@@ -241,6 +446,8 @@ FFResult FFGLSpoutBridge::ProcessOpenGL(ProcessOpenGLStruct *pGL)
 
 	if (!spoutReceiverIsInitialized) // create a sender if not initialized yet
 	{
+		TIME_STAGE(receiverCheckTimer, stageTimers, STAGE_RECEIVER_CHECK);
+
 		// Set global width and height so any change can be tested
 		//m_Width = (unsigned int)InputTexture.Width;
 		//m_Height = (unsigned int)InputTexture.Height;
@@ -249,14 +456,45 @@ FFResult FFGLSpoutBridge::ProcessOpenGL(ProcessOpenGLStruct *pGL)
 		// CreateReceiver will return true only if it finds a sender running.
 		// If a sender name is specified and does not exist it will return false.
 		// This also sets the global width and height
+		//
+		// Attempts are spaced out while the client is away, many idle
+		// instances would otherwise probe Spout on every frame
+
+		if (!receiverConnection.ShouldConnect())
+		{
+			return FF_SUCCESS;
+		}
 		
 		if (spoutReceiver.CreateReceiver(spoutReceiverName, receiverWidth, receiverHeight, false))
 		{
+			receiverConnection.Connected();
+
+			receivedCapacity.Reset();
+			receivedCapacity.Update(receiverWidth, receiverHeight);
+			receivedFormat = spoutReceiver.GetSenderFormat();
 			initReceivedTexture(); // Initialize a texture
 			spoutReceiverIsInitialized = true;
 
-			sprintf(debugBuffer, "Spout receiver initialized [%s]", spoutReceiverName);
-			OutputDebugString(debugBuffer);
+			// The client may take another format than the one chosen while
+			// it was away, the sender is replaced before the next frame
+			if (spoutSenderIsInitialized && NegotiateSenderFormat(InputTexture.Handle) != senderFormat)
+			{
+				spoutSender.ReleaseSender();
+				spoutSenderIsInitialized = false;
+				capture.WriteSenderEvent(SPOUT_SENDER_RELEASED, spoutSenderName, m_Width, m_Height);
+				CreateSpoutSender(InputTexture.Handle);
+			}
+
+			// The client (re)started, it needs all current values
+			parameters.MarkAllDirty();
+
+			SPOUT_LOG_NOTICE("Spout receiver initialized [%s] after %u attempts, %.0f ms (%u checks skipped)",
+				spoutReceiverName, receiverConnection.GetAttempts(), receiverConnection.GetLastConnectTime(), receiverConnection.GetSkipped());
+			capture.WriteSenderEvent(SPOUT_RECEIVER_CONNECTED, spoutReceiverName, receiverWidth, receiverHeight);
+		}
+		else
+		{
+			receiverConnection.Failed();
 		}
 
 		return FF_SUCCESS; // give it one frame to initialize
@@ -272,21 +510,67 @@ FFResult FFGLSpoutBridge::ProcessOpenGL(ProcessOpenGLStruct *pGL)
 
 		unsigned int width = receiverWidth, height = receiverHeight;
 
-		if (spoutReceiver.ReceiveTexture(spoutReceiverName, width, height, receivedTexture, GL_TEXTURE_2D, false, pGL->HostFBO))
+		TIME_STAGE(receiveTimer, stageTimers, STAGE_RECEIVE);
+
+		bool received = spoutReceiver.ReceiveTexture(spoutReceiverName, width, height, receivedTexture, GL_TEXTURE_2D, false, pGL->HostFBO);
+
+		if (received && (width != receiverWidth || height != receiverHeight))
+		{
+			// The client changed size: the receiver reconnected without copying,
+			// make room if needed and copy again so the frame is not lost
+			receiverWidth = width;
+			receiverHeight = height;
+
+			bool reallocate = receivedCapacity.Update(width, height);
+			if (spoutReceiver.GetSenderFormat() != receivedFormat)
+			{
+				receivedFormat = spoutReceiver.GetSenderFormat();
+				reallocate = true;
+			}
+
+			if (reallocate)
+			{
+				initReceivedTexture();
+			}
+
+			received = spoutReceiver.ReceiveTexture(spoutReceiverName, width, height, receivedTexture, GL_TEXTURE_2D, false, pGL->HostFBO);
+		}
+		else if (received && spoutReceiver.GetSenderFormat() != receivedFormat)
 		{
-			// draw the shared texture
-			DrawReceivedTexture(receivedTexture, GL_TEXTURE_2D, m_Width, m_Height);
+			// The client changed format: reconnected without copying as well
+			receivedFormat = spoutReceiver.GetSenderFormat();
+			SPOUT_LOG_NOTICE("Receiving [%s] in %s", spoutReceiverName,
+				spoutFormat::GetName(spoutFormat::FromDXGIFormat(receivedFormat)));
+
+			initReceivedTexture();
+			received = spoutReceiver.ReceiveTexture(spoutReceiverName, width, height, receivedTexture, GL_TEXTURE_2D, false, pGL->HostFBO);
+		}
+		else if (received && receivedCapacity.Update(width, height))
+		{
+			// The storage shrank after staying mostly unused, copy again
+			initReceivedTexture();
+			received = spoutReceiver.ReceiveTexture(spoutReceiverName, width, height, receivedTexture, GL_TEXTURE_2D, false, pGL->HostFBO);
+		}
+
+		TIME_STAGE_END(receiveTimer);
+
+		if (received)
+		{
+			// draw the shared texture, only the part the client wrote
+			TIME_STAGE(drawTimer, stageTimers, STAGE_DRAW);
+			DrawReceivedTexture(receivedTexture, GL_TEXTURE_2D, receivedCapacity.GetMaxS(), receivedCapacity.GetMaxT());
+			TIME_STAGE_END(drawTimer);
 			//DrawFFGLtexture(receivedTexture, maxCoords);
-			//DrawReceivedTexture(InputTexture.Handle, GL_TEXTURE_2D, m_Width, m_Height);
 		}
 		else 
 		{
 			// The sender has closed
 			spoutReceiver.ReleaseReceiver();
 			spoutReceiverIsInitialized = false;
+			receiverConnection.Disconnected();
 
-			sprintf(debugBuffer, "Release existing receiver [%s]\n", spoutReceiverName);
-			OutputDebugString(debugBuffer);
+			SPOUT_LOG_NOTICE("Release existing receiver [%s]", spoutReceiverName);
+			capture.WriteSenderEvent(SPOUT_RECEIVER_RELEASED, spoutReceiverName, receiverWidth, receiverHeight);
 		}
 	}
 
@@ -300,33 +584,36 @@ FFResult FFGLSpoutBridge::ProcessOpenGL(ProcessOpenGLStruct *pGL)
 
 FFResult FFGLSpoutBridge::SetTextParameter(unsigned int dwIndex, const char *value)
 {
-	switch (dwIndex)
+	if (dwIndex == sharingNameParamIndex)
 	{
-	case FFPARAM_SHARING_NAME:
 		if (strcmp(spoutName, value) != 0)
 		{
 			strcpy(spoutName, value);
 
-			sprintf(debugBuffer, "Sharing name changed -> %s", spoutName);
-			OutputDebugString(debugBuffer);
+			SPOUT_LOG_NOTICE("Sharing name changed -> %s", spoutName);
 
 			strcpy(spoutSenderName, spoutName);
 			strcat(spoutSenderName, "FromHost");
 
 			strcpy(spoutReceiverName, spoutName);
 			strcat(spoutReceiverName, "ToHost");
+			receiverConnection.SetSenderName(spoutReceiverName);
+
+			UpdateParameterAddresses();
+			parameters.MarkAllDirty();
 
 			sharingNameHasChanged = true;
 		}
-		break;
-	case FFPARAM_OSC_PORT:
+	}
+	else if (dwIndex == oscPortParamIndex)
+	{
 		if (atoi(value) != currentOscPort)
 		{
 			//delete transmitSocket;
 			//transmitSocket = new UdpTransmitSocket(IpEndpointName(OSC_ADDRESS, atoi(value)));
 			currentOscPort = atoi(value);
+			parameters.MarkAllDirty();
 		}
-		break;
 	}
 
 	return FF_SUCCESS;
@@ -341,15 +628,18 @@ char* FFGLSpoutBridge::GetTextParameter(unsigned int dwIndex)
 {
 	static char buf[32];
 	
-	switch (dwIndex)
+	if (dwIndex == sharingNameParamIndex)
 	{
-	case FFPARAM_SHARING_NAME:
 		return spoutName;
-	case FFPARAM_OSC_PORT:
+	}
+	else if (dwIndex == oscPortParamIndex)
+	{
 		string s = std::to_string(currentOscPort);
 		strcpy(buf, s.c_str());
 		return buf;
 	}
+
+	return NULL;
 }
 
 //**********************************************************************************
@@ -359,88 +649,218 @@ char* FFGLSpoutBridge::GetTextParameter(unsigned int dwIndex)
 
 float FFGLSpoutBridge::GetFloatParameter(unsigned int dwIndex)
 {
-	float retValue = 0.0;
-
-	switch (dwIndex)
-	{
-	case FFPARAM_MOVE_X:
-		retValue = moveX;
-		return retValue;
-	case FFPARAM_MOVE_Y:
-		retValue = moveY;
-		return retValue;
-	case FFPARAM_ROTATE:
-		retValue = rotate;
-		return retValue;
-	default:
-		return retValue;
+	if (dwIndex < parameters.GetCount())
+	{
+		return parameters.GetValue(dwIndex);
 	}
+
+	return 0.0;
 }
 
 //**********************************************************************************
+// Values are only stored here, changed ones are sent to the client once per
+// frame by SendChangedParameters()
 //**********************************************************************************
 
 FFResult FFGLSpoutBridge::SetFloatParameter(unsigned int dwIndex, float value)
 {
-	switch (dwIndex)
-	{
-	case FFPARAM_MOVE_X:
-		moveX = value;
-		break;
-	case FFPARAM_MOVE_Y:
-		moveY = value;
-		break;
-	case FFPARAM_ROTATE:
-		rotate = value;
-		break;
-	default:
+	if (dwIndex >= parameters.GetCount())
+	{
 		return FF_FAIL;
 	}
 
-	// send parameters data via OSC to client application
-	string address = string("/") + spoutName;
-	
-	osc::OutboundPacketStream packet(oscBuffer, OUTPUT_BUFFER_SIZE);
-	packet << osc::BeginMessage(address.c_str()) << moveX << moveY << rotate << osc::EndMessage;
-
-	transmitSocket->SendTo(IpEndpointName(OSC_ADDRESS, currentOscPort), packet.Data(), packet.Size());
+	parameters.SetValue(dwIndex, value);
 
 	return FF_SUCCESS;
 }
 
 //**********************************************************************************
+// Every parameter has its own OSC address, "/<sharing name>/param/<index>",
+// and a preformatted message with a single float, only the value is patched
+// when the parameter is sent
 //**********************************************************************************
 
-void FFGLSpoutBridge::DrawFFGLtexture(GLuint TextureHandle, FFGLTexCoords maxCoords)
+void FFGLSpoutBridge::UpdateParameterAddresses()
 {
-	GLfloat tex_coords[] = {
-		0.0, 0.0,
-		0.0, (float)maxCoords.t,
-		(float)maxCoords.s, (float)maxCoords.t,
-		(float)maxCoords.s, 0.0 };
-
-	GLfloat verts[] = {
-		-1.0, -1.0,
-		-1.0,  1.0,
-		1.0,  1.0,
-		1.0, -1.0 };
-
-	glPushMatrix();
-	glColor4f(1.f, 1.f, 1.f, 1.f);
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, TextureHandle); // bind the FFGL texture
-
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-	glTexCoordPointer(2, GL_FLOAT, 0, tex_coords);
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(2, GL_FLOAT, 0, verts);
-	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-	glDisableClientState(GL_VERTEX_ARRAY);
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	parameterMessages.resize(parameters.GetCount());
 
-	glBindTexture(GL_TEXTURE_2D, 0);
-	glDisable(GL_TEXTURE_2D);
-	glPopMatrix();
+	for (unsigned int i = 0; i < parameters.GetCount(); i++)
+	{
+		string address = string("/") + spoutName + "/param/" + std::to_string(i);
+		parameterMessages[i].Init(address.c_str(), "f");
+	}
+}
+
+//**********************************************************************************
+// Send the parameters changed since the last call to the client, one message
+// per parameter (value in the range given by the schema) packed in as few
+// bundles as possible
+//**********************************************************************************
+
+void FFGLSpoutBridge::SendChangedParameters()
+{
+	if (!parameters.HasDirtyValues())
+	{
+		return;
+	}
+
+	SPOUT_TRACE("SendChangedParameters");
+
+	parameters.TakeDirtyIndices(dirtyIndices);
+
+	IpEndpointName endpoint(OSC_ADDRESS, currentOscPort);
+
+	osc::OutboundPacketStream packet(oscBuffer, OSC_BUFFER_SIZE);
+	packet << osc::BeginBundleImmediate;
+
+	for (size_t i = 0; i < dirtyIndices.size(); i++)
+	{
+		osc::MessageTemplate& message = parameterMessages[dirtyIndices[i]];
+		message.SetFloat(0, parameters.GetScaledValue(dirtyIndices[i]));
+
+		// element size + message
+		if (packet.Size() + 4 + message.Size() > packet.Capacity())
+		{
+			packet << osc::EndBundle;
+			SendPacket(endpoint, packet);
+
+			packet.Clear();
+			packet << osc::BeginBundleImmediate;
+		}
+
+		packet << message;
+	}
+
+	packet << osc::EndBundle;
+	SendPacket(endpoint, packet);
+}
+
+//**********************************************************************************
+// Every OSC packet to the client goes through here to be captured as sent
+//**********************************************************************************
+
+void FFGLSpoutBridge::SendPacket(const IpEndpointName& endpoint, const osc::OutboundPacketStream& packet)
+{
+	transmitSocket->SendTo(endpoint, packet.Data(), packet.Size());
+	capture.WriteOsc(packet.Data(), packet.Size());
+}
+
+#if SPOUTBRIDGE_TIMING
+
+//**********************************************************************************
+// Once per second send the client the stage timings, one message per stage,
+// "/<sharing name>/stats/<stage>" with p50, p95 and p99 in milliseconds
+//**********************************************************************************
+
+void FFGLSpoutBridge::SendStageStats()
+{
+	long long now = StageTimers::Now();
+	if (lastStatsTime != 0 && StageTimers::ToMicroseconds(now - lastStatsTime) < STATS_INTERVAL_US)
+	{
+		return;
+	}
+	lastStatsTime = now;
+
+	SPOUT_TRACE("SendStageStats");
+
+	IpEndpointName endpoint(OSC_ADDRESS, currentOscPort);
+
+	osc::OutboundPacketStream packet(oscBuffer, OSC_BUFFER_SIZE);
+	packet << osc::BeginBundleImmediate;
+
+	string prefix = string("/") + spoutName + "/stats/";
+	for (int stage = 0; stage < STAGE_COUNT; stage++)
+	{
+		float p50, p95, p99;
+		if (stageTimers.GetPercentiles(stage, p50, p95, p99))
+		{
+			string address = prefix + StageTimers::GetStageName(stage);
+			packet << osc::BeginMessage(address.c_str()) << p50 / 1000.0f << p95 / 1000.0f << p99 / 1000.0f << osc::EndMessage;
+		}
+	}
+
+	packet << osc::EndBundle;
+	SendPacket(endpoint, packet);
+}
+
+#endif
+
+//**********************************************************************************
+// Session capture for replay without a host, see SpoutCapture.h
+//**********************************************************************************
+
+void FFGLSpoutBridge::OpenCapture()
+{
+	captureRequested = false;
+
+	const char* folder = GetDiagnosticsPath(CAPTURE_PATH_VARIABLE);
+	if (folder == NULL)
+	{
+		return;
+	}
+
+	// Hashes and pixels stall the host on a read back every frame, only on request
+	int level = SPOUT_CAPTURE_HEADERS;
+	const char* levelName = getenv(CAPTURE_LEVEL_VARIABLE);
+	if (levelName != NULL && strcmp(levelName, "hashes") == 0) level = SPOUT_CAPTURE_HASHES;
+	if (levelName != NULL && strcmp(levelName, "pixels") == 0) level = SPOUT_CAPTURE_PIXELS;
+
+	string path = string(folder) + "\\" + spoutName + ".spcap";
+	if (!capture.Open(path.c_str(), level))
+	{
+		SPOUT_LOG_ERROR("Could not open capture file %s", path.c_str());
+		return;
+	}
+
+	SPOUT_LOG_NOTICE("Capture started in %s", path.c_str());
+
+	// Sender created before the capture
+	if (spoutSenderIsInitialized)
+	{
+		capture.WriteSenderEvent(SPOUT_SENDER_CREATED, spoutSenderName, m_Width, m_Height);
+	}
+}
+
+void FFGLSpoutBridge::CaptureFrame(const FFGLTextureStruct& texture)
+{
+	const unsigned char* pixels = NULL;
+
+	// No pixel buffer may be bound for the read back
+	spoutGLState::Restore();
+
+	// Hashes and pixels need a read back, synchronous
+	if (capture.GetLevel() >= SPOUT_CAPTURE_HASHES)
+	{
+		capturePixels.resize((size_t)texture.HardwareWidth * texture.HardwareHeight * 4);
+
+		glBindTexture(GL_TEXTURE_2D, texture.Handle);
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, capturePixels.data());
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		// Keep the used part of the host texture
+		if (texture.HardwareWidth != texture.Width)
+		{
+			for (unsigned int row = 1; row < texture.Height; row++)
+			{
+				memmove(&capturePixels[(size_t)row * texture.Width * 4], &capturePixels[(size_t)row * texture.HardwareWidth * 4], (size_t)texture.Width * 4);
+			}
+		}
+
+		pixels = capturePixels.data();
+	}
+
+	capture.WriteFrame(texture.Width, texture.Height, pixels);
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+void FFGLSpoutBridge::DrawFFGLtexture(GLuint TextureHandle, FFGLTexCoords maxCoords)
+{
+	if (quadRenderer != NULL)
+	{
+		quadRenderer->Draw(TextureHandle, QuadParams((float)maxCoords.s, (float)maxCoords.t));
+	}
 }
 
 //**********************************************************************************
@@ -449,6 +869,8 @@ void FFGLSpoutBridge::DrawFFGLtexture(GLuint TextureHandle, FFGLTexCoords maxCoo
 
 void FFGLSpoutBridge::initReceivedTexture()
 {
+	spoutGLState::Restore();
+
 	if (receivedTexture != 0) 
 	{
 		glDeleteTextures(1, &receivedTexture);
@@ -461,49 +883,76 @@ void FFGLSpoutBridge::initReceivedTexture()
 	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_Width, m_Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+	// Same precision as the client sender, no conversion in the copy
+	GLenum internalFormat = spoutFormat::GetGLInternalFormat(spoutFormat::FromDXGIFormat(receivedFormat));
+	glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, receivedCapacity.GetWidth(), receivedCapacity.GetHeight(), 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
 	glBindTexture(GL_TEXTURE_2D, 0);
 }
 
 //**********************************************************************************
+// Shared texture format : the cheapest one both sides can share that keeps
+// the precision of the host texture. 8 bit BGRA is the native DirectX
+// format and needs no swizzle, higher precision is only used when the
+// host texture has it
 //**********************************************************************************
 
-void FFGLSpoutBridge::DrawReceivedTexture(GLuint TextureID, GLuint TextureTarget, unsigned int width, unsigned int height)
+DWORD FFGLSpoutBridge::NegotiateSenderFormat(GLuint inputTexture)
 {
-	GLfloat tex_coords[] =
-	{
-		0.0, 0.0,
-		0.0, 1.0,
-		1.0, 1.0,
-		1.0, 0.0
-	};
-
-	GLfloat verts[] =
-	{
-		-1.0, -1.0,
-		-1.0,  1.0,
-		1.0,  1.0,
-		1.0, -1.0
-	};
-
-	glPushMatrix();
-	glColor4f(1.f, 1.f, 1.f, 1.f);
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, TextureID); // bind the FFGL texture
-
-	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
-	glTexCoordPointer(2, GL_FLOAT, 0, tex_coords);
-	glEnableClientState(GL_VERTEX_ARRAY);
-	glVertexPointer(2, GL_FLOAT, 0, verts);
-	glDrawArrays(GL_TRIANGLE_FAN, 0, 4);
-	glDisableClientState(GL_VERTEX_ARRAY);
-	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	// GetShareMode reads the registry, only done when a sender is created
+	localFormats = spoutFormat::GetSupportedFormats(spoutSender.GetShareMode(), spoutSender.GetDX9());
 
+	// Formats published by the client sender, none while it is away
+	DWORD clientFormats = 0;
+	if (!spoutReceiverIsInitialized || !spoutReceiver.GetSenderFormats(spoutReceiverName, clientFormats))
+	{
+		clientFormats = 0;
+	}
+
+	GLint hostFormat = GL_RGBA8;
+	spoutGLState::Restore();
+	glBindTexture(GL_TEXTURE_2D, inputTexture);
+	glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_INTERNAL_FORMAT, &hostFormat);
 	glBindTexture(GL_TEXTURE_2D, 0);
-	glDisable(GL_TEXTURE_2D);
-	glPopMatrix();
 
-	return;
+	DWORD format = spoutFormat::Negotiate(localFormats, clientFormats, spoutFormat::FromGLInternalFormat((unsigned int)hostFormat));
+	return spoutFormat::GetDXGIFormat(format);
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+bool FFGLSpoutBridge::CreateSpoutSender(GLuint inputTexture)
+{
+	senderFormat = NegotiateSenderFormat(inputTexture);
+
+	spoutSenderIsInitialized = spoutSender.CreateSender(spoutSenderName, m_Width, m_Height, senderFormat);
+	if (!spoutSenderIsInitialized)
+	{
+		SPOUT_LOG_ERROR("Could not create Spout sender");
+		return false;
+	}
+
+	// Lets the client negotiate in turn
+	spoutSender.SetSenderFormats(localFormats);
+
+	SPOUT_LOG_NOTICE("Created new Spout sender[%s] in %s", spoutSenderName,
+		spoutFormat::GetName(spoutFormat::FromDXGIFormat(senderFormat)));
+	capture.WriteSenderEvent(SPOUT_SENDER_CREATED, spoutSenderName, m_Width, m_Height);
+	return true;
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+void FFGLSpoutBridge::DrawReceivedTexture(GLuint TextureID, GLuint TextureTarget, float maxS, float maxT)
+{
+	// Draws into the host fbo
+	spoutGLState::Restore();
+
+	if (quadRenderer != NULL)
+	{
+		quadRenderer->Draw(TextureID, QuadParams(maxS, maxT));
+	}
 }
 
 //**********************************************************************************
@@ -56,17 +56,50 @@
 #include <FFGLShader.h>
 #include "FFGLPluginSDK.h"
 #include <string>
+#include <vector>
 
 //#include "FFGLExtensions.h" // can't use these if using Glew 31.12.13
 #include "FFGLLib.h"
 #include "Spout.h"
+#include "SpoutSharedContext.h"
+#include "SpoutConnectionState.h"
+#include "SpoutTrace.h"
+#include "SpoutLockStats.h"
+#include "SpoutLog.h"
+#include "SpoutCapture.h"
+#include "SpoutGLState.h"
+#include "SpoutFormat.h"
 #include "osc/OscOutboundPacketStream.h"
+#include "osc/OscMessageTemplate.h"
 #include "ip/UdpSocket.h"
+#include "BridgeParameters.h"
+#include "TextureCapacity.h"
+#include "StageTimers.h"
+#include "GLQuadRenderer.h"
 
 #define OSC_ADDRESS "127.0.0.1"
 #define OSC_DEFAULT_PORT "7251"
 
-#define OUTPUT_BUFFER_SIZE 1024
+#define OSC_BUFFER_SIZE 4096
+
+// Interval between two stage timing reports to the client
+#define STATS_INTERVAL_US 1000000.0f
+
+// Path of the Chrome trace written when the plugin is unloaded,
+// nothing is recorded if the variable is not set
+#define TRACE_PATH_VARIABLE "SPOUTBRIDGE_TRACE"
+
+// Path of the shared memory lock statistics written when the plugin is unloaded
+#define LOCK_STATS_PATH_VARIABLE "SPOUTBRIDGE_LOCKSTATS"
+
+// Log file, messages also go to the debugger output (DebugView)
+#define LOG_PATH_VARIABLE "SPOUTBRIDGE_LOG"
+
+// Folder receiving a "<sharing name>.spcap" capture of the session for
+// replay, frames recorded as "headers" (default), "hashes" or "pixels".
+// Hashes and pixels read the host texture back on every frame.
+#define CAPTURE_PATH_VARIABLE "SPOUTBRIDGE_CAPTURE"
+#define CAPTURE_LEVEL_VARIABLE "SPOUTBRIDGE_CAPTURE_LEVEL"
 
 class FFGLSpoutBridge : public CFreeFrameGLPlugin
 {
@@ -102,49 +135,85 @@ public:
 
 protected:
 	// Parameters
-	float moveX;
-	float moveY;
-	float rotate;
+	// float parameters come from the schema file, the two text parameters
+	// (sharing name and OSC port) always follow them
+	BridgeParameters parameters;
+	unsigned int sharingNameParamIndex;
+	unsigned int oscPortParamIndex;
 	char currentName[256];
 
 	int m_initResources;
 
 	char defaultName[256] = "FFGLSpoutBridge";
 
-	FFGLShader m_shader;
-	GLint m_inputTextureLocation;
-	GLint m_BrightnessLocation;
-
     // Spout stuff
 
 	//FFGLExtensions m_extensions; // can't use these if using Glew 31.12.13
 
-	GLint m_maxCoordsLocation;
 	GLuint receivedTexture;
 
+	// Process wide DirectX / interop devices and sender checks shared by all
+	// the instances, must be declared before the sender and the receiver
+	spoutSharedContextRef spoutContext;
+
 	SpoutSender spoutSender;
 	SpoutReceiver spoutReceiver;
+	spoutConnectionState receiverConnection; // when to try CreateReceiver again
 
 	unsigned int m_Width, m_Height;
 
+	// Pixel formats, see spoutFormat.h. The sender format is negotiated
+	// with the formats the client publishes, the received one is whatever
+	// the client sends (DXGI values)
+	DWORD localFormats;
+	DWORD senderFormat;
+	DWORD receivedFormat;
+
 	char spoutName[256];
 	char spoutSenderName[270];
 	char spoutReceiverName[270];
 	bool sharingNameHasChanged;
 
 	unsigned int receiverWidth, receiverHeight;
+	TextureCapacity receivedCapacity; // storage size of receivedTexture
 
 	bool spoutSenderIsInitialized, spoutReceiverIsInitialized;
 
+	// Draws full viewport quads, shader based when the context allows it,
+	// created by InitGL
+	QuadRenderer* quadRenderer;
+
 	void DrawFFGLtexture(GLuint TextureHandle, FFGLTexCoords maxCoords);
 
+	DWORD NegotiateSenderFormat(GLuint inputTexture);
+	bool CreateSpoutSender(GLuint inputTexture);
 	void initReceivedTexture();
-	void DrawReceivedTexture(GLuint TextureID, GLuint TextureTarget, unsigned int width, unsigned int height);
+	void DrawReceivedTexture(GLuint TextureID, GLuint TextureTarget, float maxS, float maxT);
 
-	char debugBuffer[512];
 	//char spoutSharingName[512];
 
 	UdpTransmitSocket* transmitSocket;
-	char oscBuffer[OUTPUT_BUFFER_SIZE];
+	char oscBuffer[OSC_BUFFER_SIZE];
 	int currentOscPort;
+
+	std::vector<osc::MessageTemplate> parameterMessages; // "/<sharing name>/param/<index>" f
+	std::vector<unsigned int> dirtyIndices;
+
+	void UpdateParameterAddresses();
+	void SendChangedParameters();
+	void SendPacket(const IpEndpointName& endpoint, const osc::OutboundPacketStream& packet);
+
+	// Session capture, opened on the first frame once the host has set the name
+	spoutCaptureWriter capture;
+	bool captureRequested;
+	std::vector<unsigned char> capturePixels;
+
+	void OpenCapture();
+	void CaptureFrame(const FFGLTextureStruct& texture);
+
+#if SPOUTBRIDGE_TIMING
+	StageTimers stageTimers;
+	long long lastStatsTime;
+	void SendStageStats();
+#endif
 };
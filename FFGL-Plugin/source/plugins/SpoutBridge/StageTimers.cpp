@@ -0,0 +1,99 @@
+//**********************************************************************************
+//
+// StageTimers.cpp
+//
+//**********************************************************************************
+
+#include "StageTimers.h"
+
+#include <windows.h>
+#include <algorithm>
+
+static const char* stageNames[STAGE_COUNT] =
+{
+	"frame",
+	"parameters",
+	"sender",
+	"drawtoshared",
+	"receivercheck",
+	"receive",
+	"draw"
+};
+
+//**********************************************************************************
+//**********************************************************************************
+
+StageTimers::StageTimers()
+{
+	for (int i = 0; i < STAGE_COUNT; i++)
+	{
+		for (int j = 0; j < STAGE_RING_SIZE; j++)
+		{
+			rings[i].samples[j].store(0.0f, std::memory_order_relaxed);
+		}
+		rings[i].count.store(0, std::memory_order_relaxed);
+	}
+}
+
+void StageTimers::Record(int stage, float microseconds)
+{
+	Ring& ring = rings[stage];
+
+	unsigned int count = ring.count.load(std::memory_order_relaxed);
+	ring.samples[count % STAGE_RING_SIZE].store(microseconds, std::memory_order_relaxed);
+	ring.count.store(count + 1, std::memory_order_release);
+}
+
+bool StageTimers::GetPercentiles(int stage, float& p50, float& p95, float& p99) const
+{
+	const Ring& ring = rings[stage];
+
+	unsigned int count = ring.count.load(std::memory_order_acquire);
+	if (count == 0)
+	{
+		return false;
+	}
+
+	unsigned int n = count < STAGE_RING_SIZE ? count : STAGE_RING_SIZE;
+
+	float sorted[STAGE_RING_SIZE];
+	for (unsigned int i = 0; i < n; i++)
+	{
+		sorted[i] = ring.samples[i].load(std::memory_order_relaxed);
+	}
+	std::sort(sorted, sorted + n);
+
+	p50 = sorted[(n - 1) * 50 / 100];
+	p95 = sorted[(n - 1) * 95 / 100];
+	p99 = sorted[(n - 1) * 99 / 100];
+
+	return true;
+}
+
+const char* StageTimers::GetStageName(int stage)
+{
+	return (stage >= 0 && stage < STAGE_COUNT) ? stageNames[stage] : "";
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+long long StageTimers::Now()
+{
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart;
+}
+
+float StageTimers::ToMicroseconds(long long ticks)
+{
+	static long long frequency = 0;
+	if (frequency == 0)
+	{
+		LARGE_INTEGER f;
+		QueryPerformanceFrequency(&f);
+		frequency = f.QuadPart;
+	}
+
+	return (float)((double)ticks * 1000000.0 / (double)frequency);
+}
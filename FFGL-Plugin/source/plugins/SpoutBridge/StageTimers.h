@@ -0,0 +1,94 @@
+//**********************************************************************************
+//
+// StageTimers.h
+//
+// CPU time spent in each stage of ProcessOpenGL, to tell whether frame drops
+// come from the plugin, the Spout transfers or the client.
+//
+// Each stage keeps its last samples in a ring written by the render thread
+// only, percentiles are computed on demand from a copy. The plugin publishes
+// them to the client over OSC once per second.
+//
+// Build with SPOUTBRIDGE_TIMING defined as 0 to compile the timers out.
+//
+//**********************************************************************************
+
+#pragma once
+
+#include <atomic>
+
+#ifndef SPOUTBRIDGE_TIMING
+#define SPOUTBRIDGE_TIMING 1
+#endif
+
+// Samples kept for each stage
+#define STAGE_RING_SIZE 512
+
+enum BridgeStage
+{
+	STAGE_FRAME,			// the whole ProcessOpenGL call
+	STAGE_PARAMETERS,		// OSC parameter forwarding
+	STAGE_SENDER,			// sender creation and resize
+	STAGE_DRAW_TO_SHARED,	// host texture into the shared texture
+	STAGE_RECEIVER_CHECK,	// receiver connection
+	STAGE_RECEIVE,			// ReceiveTexture
+	STAGE_DRAW,				// client texture to the host fbo
+	STAGE_COUNT
+};
+
+class StageTimers
+{
+public:
+	StageTimers();
+
+	void Record(int stage, float microseconds);
+
+	// false if the stage has no samples yet, values in microseconds
+	bool GetPercentiles(int stage, float& p50, float& p95, float& p99) const;
+
+	static const char* GetStageName(int stage);
+
+	// High resolution clock
+	static long long Now();
+	static float ToMicroseconds(long long ticks);
+
+private:
+	struct Ring
+	{
+		std::atomic<float> samples[STAGE_RING_SIZE];
+		std::atomic<unsigned int> count; // samples ever written
+	};
+
+	Ring rings[STAGE_COUNT];
+};
+
+// Records the time from construction to Stop() or destruction, whichever
+// comes first, so early returns are accounted for too
+class ScopedStageTimer
+{
+public:
+	ScopedStageTimer(StageTimers& timers, int stage) : timers(timers), stage(stage), start(StageTimers::Now()) {}
+	~ScopedStageTimer() { Stop(); }
+
+	void Stop()
+	{
+		if (stage >= 0)
+		{
+			timers.Record(stage, StageTimers::ToMicroseconds(StageTimers::Now() - start));
+			stage = -1;
+		}
+	}
+
+private:
+	StageTimers& timers;
+	int stage;
+	long long start;
+};
+
+#if SPOUTBRIDGE_TIMING
+#define TIME_STAGE(name, timers, stage) ScopedStageTimer name(timers, stage)
+#define TIME_STAGE_END(name) name.Stop()
+#else
+#define TIME_STAGE(name, timers, stage)
+#define TIME_STAGE_END(name)
+#endif
@@ -0,0 +1,85 @@
+//**********************************************************************************
+//
+// TextureCapacity.cpp
+//
+//**********************************************************************************
+
+#include "TextureCapacity.h"
+
+// Storage sizes are multiples of this
+#define CAPACITY_ALIGNMENT 64
+
+// Frames the content must stay under half the storage area before shrinking,
+// a couple of seconds at usual frame rates
+#define CAPACITY_SHRINK_FRAMES 120
+
+//**********************************************************************************
+//**********************************************************************************
+
+TextureCapacity::TextureCapacity()
+{
+	Reset();
+}
+
+void TextureCapacity::Reset()
+{
+	contentWidth = contentHeight = 0;
+	capacityWidth = capacityHeight = 0;
+	smallFrames = 0;
+}
+
+unsigned int TextureCapacity::Grow(unsigned int current, unsigned int required)
+{
+	// 1.5x the current size, but at least what is required
+	unsigned int grown = current + current / 2;
+	if (grown < required)
+	{
+		grown = required;
+	}
+
+	return (grown + CAPACITY_ALIGNMENT - 1) / CAPACITY_ALIGNMENT * CAPACITY_ALIGNMENT;
+}
+
+bool TextureCapacity::Update(unsigned int width, unsigned int height)
+{
+	contentWidth = width;
+	contentHeight = height;
+
+	if (width > capacityWidth || height > capacityHeight)
+	{
+		// The first allocation fits the content, geometric growth only kicks in
+		// once the size actually changes
+		if (capacityWidth == 0 || capacityHeight == 0)
+		{
+			capacityWidth = Grow(0, width);
+			capacityHeight = Grow(0, height);
+		}
+		else
+		{
+			capacityWidth = width > capacityWidth ? Grow(capacityWidth, width) : capacityWidth;
+			capacityHeight = height > capacityHeight ? Grow(capacityHeight, height) : capacityHeight;
+		}
+
+		smallFrames = 0;
+		return true;
+	}
+
+	// Shrink only after the content has been small for a while
+	if ((unsigned long long)width * height * 2 <= (unsigned long long)capacityWidth * capacityHeight)
+	{
+		smallFrames++;
+		if (smallFrames >= CAPACITY_SHRINK_FRAMES)
+		{
+			capacityWidth = Grow(0, width);
+			capacityHeight = Grow(0, height);
+			smallFrames = 0;
+			return true;
+		}
+	}
+	else
+	{
+		smallFrames = 0;
+	}
+
+	return false;
+}
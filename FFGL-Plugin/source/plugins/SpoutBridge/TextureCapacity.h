@@ -0,0 +1,42 @@
+//**********************************************************************************
+//
+// TextureCapacity.h
+//
+// Allocation size of a texture whose content size changes over time.
+//
+// The storage grows geometrically, so a layer being resized step by step does
+// not reallocate on every step, and only shrinks after the content has been
+// much smaller than the storage for a number of consecutive frames, so that
+// switching back and forth between two compositions doesn't reallocate either.
+//
+//**********************************************************************************
+
+#pragma once
+
+class TextureCapacity
+{
+public:
+	TextureCapacity();
+
+	// Call once per frame with the size of the content.
+	// Returns true when the storage has to be (re)allocated at
+	// GetWidth() x GetHeight().
+	bool Update(unsigned int width, unsigned int height);
+
+	// Forget the current storage, the next Update allocates
+	void Reset();
+
+	unsigned int GetWidth() const { return capacityWidth; }
+	unsigned int GetHeight() const { return capacityHeight; }
+
+	// Texture coordinates of the content corner in the storage
+	float GetMaxS() const { return capacityWidth > 0 ? (float)contentWidth / (float)capacityWidth : 1.0f; }
+	float GetMaxT() const { return capacityHeight > 0 ? (float)contentHeight / (float)capacityHeight : 1.0f; }
+
+private:
+	static unsigned int Grow(unsigned int current, unsigned int required);
+
+	unsigned int contentWidth, contentHeight;
+	unsigned int capacityWidth, capacityHeight;
+	unsigned int smallFrames; // consecutive frames the content used less than half the storage
+};
@@ -0,0 +1,1045 @@
+//**********************************************************************************
+//
+// HostSimulator.cpp
+//
+// Headless FFGL host for soak and throughput testing of plugins, on Windows
+// and Linux.
+//
+// The simulator loads a plugin dll or shared object, resolves plugMain and drives it the
+// way a VJ host does: FF_INSTANTIATEGL for every instance, then at a fixed frame
+// rate FF_SETTIME, a burst of randomized FF_SETPARAMETER calls and
+// FF_PROCESSOPENGL with an input texture. Every plugMain call is timed and the
+// latencies are collected in per function histograms that are printed
+// periodically and at exit, together with the process resident set size so
+// long runs also show leaks.
+//
+// GL context:
+//   wgl   (Windows) context on a hidden window, the one to use for SpoutBridge,
+//         which shares through DirectX and needs a real GPU context
+//   egl   (Linux) software or hardware context on an EGL pbuffer, no display
+//         server needed (set LIBGL_ALWAYS_SOFTWARE=1 to force llvmpipe)
+//   none  no context at all; on Linux GL calls made by the plugin fall through
+//         to the no-op dispatch of libglvnd, which isolates plugMain dispatch
+//         overhead. Plugins that need GL, SpoutBridge included, fail to start.
+//
+// SpoutBridge is Windows only (wgl, DirectX 11 and Spout): on Linux the
+// simulator can only drive FFGL plugins built for Linux.
+//
+// Build on Windows, from a Visual Studio command prompt of the same
+// architecture as the plugin (x86 or x64):
+//   cl /O2 /EHsc /I..\..\lib\ffgl HostSimulator.cpp LatencyHistogram.cpp ..\..\lib\glee\GLee.c opengl32.lib user32.lib gdi32.lib psapi.lib winmm.lib
+//
+// Build on Linux:
+//   g++ -O2 -std=c++11 -I../../lib/ffgl HostSimulator.cpp LatencyHistogram.cpp -o HostSimulator -ldl -lEGL -lGL
+//
+// Example, 8 SpoutBridge instances at 60 fps for 24 hours:
+//   HostSimulator.exe SpoutBridge.dll -n 8 -r 60 -d 86400
+//
+//**********************************************************************************
+
+#include "LatencyHistogram.h"
+
+#include <FFGL.h>
+
+#ifdef _WIN32
+#include <psapi.h>
+#include <mmsystem.h>
+#else
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+
+#include <dlfcn.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+//**********************************************************************************
+//**********************************************************************************
+
+enum SimulatedCall
+{
+	CALL_INSTANTIATEGL,
+	CALL_DEINSTANTIATEGL,
+	CALL_SETTIME,
+	CALL_SETPARAMETER,
+	CALL_GETPARAMETER,
+	CALL_PROCESSOPENGL,
+	CALL_RESIZE,
+	CALL_COUNT
+};
+
+static const char* callNames[CALL_COUNT] =
+{
+	"InstantiateGL",
+	"DeInstantiateGL",
+	"SetTime",
+	"SetParameter",
+	"GetParameter",
+	"ProcessOpenGL",
+	"Resize"
+};
+
+struct SimulatorOptions
+{
+	std::string pluginPath;
+	std::string glMode;
+	unsigned int instances;
+	double frameRate;
+	double duration;
+	unsigned int width;
+	unsigned int height;
+	unsigned int parameterChanges;
+	unsigned int churnFrames;
+	unsigned int resizeFrames;
+	double reportInterval;
+	unsigned int seed;
+	bool textParameters;
+};
+
+struct SimulatedInstance
+{
+	FFInstanceID id;
+	unsigned int width;
+	unsigned int height;
+};
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void HandleSignal(int)
+{
+	stopRequested = 1;
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+#ifdef _WIN32
+
+static uint64_t NowNs()
+{
+	static LARGE_INTEGER frequency = { 0 };
+	if (frequency.QuadPart == 0)
+	{
+		QueryPerformanceFrequency(&frequency);
+	}
+
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+
+	// split so that the product does not overflow on long runs
+	uint64_t seconds = (uint64_t)(counter.QuadPart / frequency.QuadPart);
+	uint64_t remainder = (uint64_t)(counter.QuadPart % frequency.QuadPart);
+	return seconds * 1000000000ull + remainder * 1000000000ull / (uint64_t)frequency.QuadPart;
+}
+
+// Whole milliseconds, Run sets the timer resolution to 1 ms
+static void SleepUntilNs(uint64_t deadline)
+{
+	uint64_t now = NowNs();
+	if (deadline > now && !stopRequested)
+	{
+		Sleep((DWORD)((deadline - now) / 1000000ull));
+	}
+}
+
+static unsigned long ResidentSetKb()
+{
+	PROCESS_MEMORY_COUNTERS counters;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return 0;
+	}
+
+	return (unsigned long)(counters.WorkingSetSize / 1024);
+}
+
+#else
+
+static uint64_t NowNs()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void SleepUntilNs(uint64_t deadline)
+{
+	struct timespec ts;
+	ts.tv_sec = (time_t)(deadline / 1000000000ull);
+	ts.tv_nsec = (long)(deadline % 1000000000ull);
+
+	// Again only when a signal cut the sleep short, an absolute deadline
+	// needs no adjusting; other errors would fail every time
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR && !stopRequested)
+	{
+	}
+}
+
+static unsigned long ResidentSetKb()
+{
+	FILE* f = fopen("/proc/self/statm", "r");
+	if (f == NULL)
+	{
+		return 0;
+	}
+
+	unsigned long size = 0, resident = 0;
+	if (fscanf(f, "%lu %lu", &size, &resident) != 2)
+	{
+		resident = 0;
+	}
+	fclose(f);
+
+	return resident * (unsigned long)(sysconf(_SC_PAGESIZE) / 1024);
+}
+
+#endif
+
+// xorshift32, fast and deterministic for a given seed
+static uint32_t NextRandom(uint32_t& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+static float NextRandomFloat(uint32_t& state)
+{
+	return (float)(NextRandom(state) >> 8) / (float)(1 << 24);
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+class HostSimulator
+{
+public:
+	HostSimulator(const SimulatorOptions& options);
+	~HostSimulator();
+
+	bool Load();
+	bool CreateContext();
+	void DestroyContext();
+	void Run();
+	void Shutdown();
+
+private:
+	FFMixed Call(SimulatedCall call, FFUInt32 functionCode, FFMixed inputValue, FFInstanceID instanceID);
+
+	bool Instantiate(SimulatedInstance& instance);
+	void DeInstantiate(SimulatedInstance& instance);
+	void Frame(SimulatedInstance& instance, double time);
+	void RandomizeParameter(SimulatedInstance& instance);
+
+#ifdef _WIN32
+	bool CreateWGLContext();
+#else
+	bool CreateEGLContext();
+#endif
+	void CreateInputTexture(unsigned int width, unsigned int height);
+	void PrintReport(const char* title, const LatencyHistogram* histograms, double elapsed);
+
+	SimulatorOptions options;
+	uint32_t randomState;
+
+	void* library;
+	FF_Main_FuncPtr plugMain;
+	std::vector<FFUInt32> parameterTypes;
+	std::vector<std::string> textValues;
+
+	bool hasContext;
+#ifdef _WIN32
+	HWND window;
+	HDC dc;
+	HGLRC context;
+#else
+	EGLDisplay display;
+	EGLSurface surface;
+	EGLContext context;
+#endif
+
+	GLuint inputTexture;
+	FFGLTextureStruct inputTextureStruct;
+
+	std::vector<SimulatedInstance> instances;
+
+	// totals since start and since the last periodic report
+	LatencyHistogram totals[CALL_COUNT];
+	LatencyHistogram interval[CALL_COUNT];
+	uint64_t failures[CALL_COUNT];
+};
+
+//**********************************************************************************
+//**********************************************************************************
+
+HostSimulator::HostSimulator(const SimulatorOptions& options) :
+	options(options),
+	randomState(options.seed != 0 ? options.seed : 1),
+	library(NULL),
+	plugMain(NULL),
+	hasContext(false),
+#ifdef _WIN32
+	window(NULL),
+	dc(NULL),
+	context(NULL),
+#else
+	display(EGL_NO_DISPLAY),
+	surface(EGL_NO_SURFACE),
+	context(EGL_NO_CONTEXT),
+#endif
+	inputTexture(0)
+{
+	memset(&inputTextureStruct, 0, sizeof(inputTextureStruct));
+	memset(failures, 0, sizeof(failures));
+}
+
+HostSimulator::~HostSimulator()
+{
+	Shutdown();
+}
+
+FFMixed HostSimulator::Call(SimulatedCall call, FFUInt32 functionCode, FFMixed inputValue, FFInstanceID instanceID)
+{
+	uint64_t start = NowNs();
+	FFMixed result = plugMain(functionCode, inputValue, instanceID);
+	uint64_t elapsed = NowNs() - start;
+
+	totals[call].Record(elapsed);
+	interval[call].Record(elapsed);
+
+	return result;
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+bool HostSimulator::Load()
+{
+#ifdef _WIN32
+	library = (void*)LoadLibraryA(options.pluginPath.c_str());
+	if (library == NULL)
+	{
+		fprintf(stderr, "Cannot load %s: error %lu\n", options.pluginPath.c_str(), GetLastError());
+		return false;
+	}
+
+	plugMain = (FF_Main_FuncPtr)GetProcAddress((HMODULE)library, "plugMain");
+#else
+	library = dlopen(options.pluginPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+	if (library == NULL)
+	{
+		fprintf(stderr, "Cannot load %s: %s\n", options.pluginPath.c_str(), dlerror());
+		return false;
+	}
+
+	plugMain = (FF_Main_FuncPtr)dlsym(library, "plugMain");
+#endif
+	if (plugMain == NULL)
+	{
+		fprintf(stderr, "%s does not export plugMain\n", options.pluginPath.c_str());
+		return false;
+	}
+
+	FFMixed input;
+	input.UIntValue = 0;
+
+	PluginInfoStruct* info = (PluginInfoStruct*)plugMain(FF_GETINFO, input, NULL).PointerValue;
+	if (info == NULL)
+	{
+		fprintf(stderr, "FF_GETINFO failed\n");
+		return false;
+	}
+
+	char name[17];
+	memcpy(name, info->PluginName, 16);
+	name[16] = 0;
+	printf("Plugin \"%s\", FreeFrame API %u.%03u\n", name, info->APIMajorVersion, info->APIMinorVersion);
+
+	input.UIntValue = FF_CAP_PROCESSOPENGL;
+	if (plugMain(FF_GETPLUGINCAPS, input, NULL).UIntValue != FF_SUPPORTED)
+	{
+		fprintf(stderr, "Plugin does not support FF_CAP_PROCESSOPENGL\n");
+		return false;
+	}
+
+	input.UIntValue = 0;
+	if (plugMain(FF_INITIALISE, input, NULL).UIntValue != FF_SUCCESS)
+	{
+		fprintf(stderr, "FF_INITIALISE failed\n");
+		return false;
+	}
+
+	unsigned int count = plugMain(FF_GETNUMPARAMETERS, input, NULL).UIntValue;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		input.UIntValue = i;
+		FFUInt32 type = plugMain(FF_GETPARAMETERTYPE, input, NULL).UIntValue;
+		const char* parameterName = (const char*)plugMain(FF_GETPARAMETERNAME, input, NULL).PointerValue;
+
+		memset(name, 0, sizeof(name));
+		if (parameterName != NULL)
+		{
+			strncpy(name, parameterName, 16);
+		}
+
+		parameterTypes.push_back(type);
+		printf("  parameter %u: %-16s type %u\n", i, name, type);
+
+		// text parameters are only ever set back to their default, random
+		// strings would make the plugin reconnect on every frame
+		const char* defaultText = NULL;
+		if (type == FF_TYPE_TEXT)
+		{
+			defaultText = (const char*)plugMain(FF_GETPARAMETERDEFAULT, input, NULL).PointerValue;
+		}
+		textValues.push_back(defaultText != NULL ? defaultText : "");
+	}
+
+	return true;
+}
+
+bool HostSimulator::CreateContext()
+{
+	if (options.glMode == "none")
+	{
+		printf("Running without a GL context\n");
+		return true;
+	}
+
+#ifdef _WIN32
+	hasContext = CreateWGLContext();
+#else
+	hasContext = CreateEGLContext();
+#endif
+	if (!hasContext)
+	{
+		return false;
+	}
+
+	printf("GL renderer \"%s\", version \"%s\"\n",
+		(const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+
+	CreateInputTexture(options.width, options.height);
+
+	return true;
+}
+
+#ifdef _WIN32
+
+bool HostSimulator::CreateWGLContext()
+{
+	// never shown, it only provides a device context with a GL pixel format
+	WNDCLASSA windowClass;
+	memset(&windowClass, 0, sizeof(windowClass));
+	windowClass.style = CS_OWNDC;
+	windowClass.lpfnWndProc = DefWindowProcA;
+	windowClass.hInstance = GetModuleHandle(NULL);
+	windowClass.lpszClassName = "FFGLHostSimulator";
+	RegisterClassA(&windowClass);
+
+	window = CreateWindowA(windowClass.lpszClassName, "FFGL host simulator", WS_OVERLAPPEDWINDOW,
+		0, 0, (int)options.width, (int)options.height, NULL, NULL, windowClass.hInstance, NULL);
+	dc = (window != NULL) ? GetDC(window) : NULL;
+	if (dc == NULL)
+	{
+		fprintf(stderr, "Cannot create the hidden window\n");
+		return false;
+	}
+
+	PIXELFORMATDESCRIPTOR pfd;
+	memset(&pfd, 0, sizeof(pfd));
+	pfd.nSize = sizeof(pfd);
+	pfd.nVersion = 1;
+	pfd.dwFlags = PFD_DRAW_TO_WINDOW | PFD_SUPPORT_OPENGL | PFD_DOUBLEBUFFER;
+	pfd.iPixelType = PFD_TYPE_RGBA;
+	pfd.cColorBits = 32;
+	pfd.cAlphaBits = 8;
+	pfd.cDepthBits = 24;
+	pfd.iLayerType = PFD_MAIN_PLANE;
+
+	int pixelFormat = ChoosePixelFormat(dc, &pfd);
+	if (pixelFormat == 0 || !SetPixelFormat(dc, pixelFormat, &pfd))
+	{
+		fprintf(stderr, "No pixel format with OpenGL support\n");
+		return false;
+	}
+
+	context = wglCreateContext(dc);
+	if (context == NULL || !wglMakeCurrent(dc, context))
+	{
+		fprintf(stderr, "Cannot create a WGL context\n");
+		return false;
+	}
+
+	return true;
+}
+
+#else
+
+bool HostSimulator::CreateEGLContext()
+{
+	EGLint major, minor;
+	display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+	if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+	{
+		// no display server, fall back to the Mesa surfaceless platform
+		PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay =
+			(PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+
+		display = (getPlatformDisplay != NULL) ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, NULL) : EGL_NO_DISPLAY;
+		if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor))
+		{
+			fprintf(stderr, "Cannot initialize EGL\n");
+			return false;
+		}
+	}
+
+	const EGLint configAttributes[] =
+	{
+		EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+		EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+		EGL_RED_SIZE, 8,
+		EGL_GREEN_SIZE, 8,
+		EGL_BLUE_SIZE, 8,
+		EGL_ALPHA_SIZE, 8,
+		EGL_NONE
+	};
+
+	EGLConfig config;
+	EGLint configCount = 0;
+	if (!eglChooseConfig(display, configAttributes, &config, 1, &configCount) || configCount == 0)
+	{
+		fprintf(stderr, "No EGL config with desktop GL and pbuffer support\n");
+		return false;
+	}
+
+	const EGLint surfaceAttributes[] =
+	{
+		EGL_WIDTH, (EGLint)options.width,
+		EGL_HEIGHT, (EGLint)options.height,
+		EGL_NONE
+	};
+
+	eglBindAPI(EGL_OPENGL_API);
+	surface = eglCreatePbufferSurface(display, config, surfaceAttributes);
+	context = eglCreateContext(display, config, EGL_NO_CONTEXT, NULL);
+	if (surface == EGL_NO_SURFACE || context == EGL_NO_CONTEXT || !eglMakeCurrent(display, surface, surface, context))
+	{
+		fprintf(stderr, "Cannot create an EGL context\n");
+		return false;
+	}
+
+	printf("EGL %d.%d\n", major, minor);
+
+	return true;
+}
+
+#endif
+
+void HostSimulator::CreateInputTexture(unsigned int width, unsigned int height)
+{
+	inputTextureStruct.Width = width;
+	inputTextureStruct.Height = height;
+	inputTextureStruct.HardwareWidth = width;
+	inputTextureStruct.HardwareHeight = height;
+
+	if (!hasContext)
+	{
+		return;
+	}
+
+	if (inputTexture == 0)
+	{
+		glGenTextures(1, &inputTexture);
+	}
+
+	// a gradient so a plugin that reads the input back gets something non trivial
+	std::vector<unsigned char> pixels((size_t)width * height * 4);
+	for (unsigned int y = 0; y < height; y++)
+	{
+		for (unsigned int x = 0; x < width; x++)
+		{
+			unsigned char* p = &pixels[((size_t)y * width + x) * 4];
+			p[0] = (unsigned char)(x * 255 / (width > 1 ? width - 1 : 1));
+			p[1] = (unsigned char)(y * 255 / (height > 1 ? height - 1 : 1));
+			p[2] = 128;
+			p[3] = 255;
+		}
+	}
+
+	glBindTexture(GL_TEXTURE_2D, inputTexture);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	inputTextureStruct.Handle = inputTexture;
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+bool HostSimulator::Instantiate(SimulatedInstance& instance)
+{
+	FFGLViewportStruct viewport;
+	viewport.x = 0;
+	viewport.y = 0;
+	viewport.width = options.width;
+	viewport.height = options.height;
+
+	FFMixed input;
+	input.PointerValue = &viewport;
+
+	FFMixed result = Call(CALL_INSTANTIATEGL, FF_INSTANTIATEGL, input, NULL);
+	if (result.PointerValue == NULL || result.PointerValue == (void*)(uintptr_t)FF_FAIL)
+	{
+		failures[CALL_INSTANTIATEGL]++;
+		instance.id = NULL;
+		return false;
+	}
+
+	instance.id = (FFInstanceID)result.PointerValue;
+	instance.width = options.width;
+	instance.height = options.height;
+	return true;
+}
+
+void HostSimulator::DeInstantiate(SimulatedInstance& instance)
+{
+	if (instance.id == NULL)
+	{
+		return;
+	}
+
+	FFMixed input;
+	input.UIntValue = 0;
+
+	if (Call(CALL_DEINSTANTIATEGL, FF_DEINSTANTIATEGL, input, instance.id).UIntValue != FF_SUCCESS)
+	{
+		failures[CALL_DEINSTANTIATEGL]++;
+	}
+
+	instance.id = NULL;
+}
+
+void HostSimulator::RandomizeParameter(SimulatedInstance& instance)
+{
+	if (parameterTypes.empty())
+	{
+		return;
+	}
+
+	unsigned int index = NextRandom(randomState) % parameterTypes.size();
+	FFUInt32 type = parameterTypes[index];
+
+	SetParameterStruct parameter;
+	parameter.ParameterNumber = index;
+
+	if (type == FF_TYPE_TEXT)
+	{
+		if (!options.textParameters)
+		{
+			return;
+		}
+		parameter.NewParameterValue.PointerValue = (void*)textValues[index].c_str();
+	}
+	else
+	{
+		float value = NextRandomFloat(randomState);
+		if (type == FF_TYPE_BOOLEAN || type == FF_TYPE_EVENT)
+		{
+			value = (value < 0.5f) ? 0.0f : 1.0f;
+		}
+		memcpy(&parameter.NewParameterValue.UIntValue, &value, sizeof(value));
+	}
+
+	FFMixed input;
+	input.PointerValue = &parameter;
+
+	if (Call(CALL_SETPARAMETER, FF_SETPARAMETER, input, instance.id).UIntValue != FF_SUCCESS)
+	{
+		failures[CALL_SETPARAMETER]++;
+	}
+
+	// read it back, hosts poll parameters to refresh their UI
+	input.UIntValue = index;
+	Call(CALL_GETPARAMETER, FF_GETPARAMETER, input, instance.id);
+}
+
+void HostSimulator::Frame(SimulatedInstance& instance, double time)
+{
+	FFMixed input;
+
+	input.PointerValue = &time;
+	Call(CALL_SETTIME, FF_SETTIME, input, instance.id);
+
+	for (unsigned int i = 0; i < options.parameterChanges; i++)
+	{
+		RandomizeParameter(instance);
+	}
+
+	FFGLTextureStruct* inputTextures[1] = { &inputTextureStruct };
+
+	ProcessOpenGLStruct process;
+	process.numInputTextures = 1;
+	process.inputTextures = inputTextures;
+	process.HostFBO = 0;
+
+	input.PointerValue = &process;
+	if (Call(CALL_PROCESSOPENGL, FF_PROCESSOPENGL, input, instance.id).UIntValue != FF_SUCCESS)
+	{
+		failures[CALL_PROCESSOPENGL]++;
+	}
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+void HostSimulator::Run()
+{
+	signal(SIGINT, HandleSignal);
+	signal(SIGTERM, HandleSignal);
+
+#ifdef _WIN32
+	// Sleep is only as fine as the system timer
+	timeBeginPeriod(1);
+#endif
+
+	instances.resize(options.instances);
+	for (size_t i = 0; i < instances.size(); i++)
+	{
+		if (!Instantiate(instances[i]))
+		{
+			fprintf(stderr, "FF_INSTANTIATEGL failed for instance %u\n", (unsigned int)i);
+		}
+	}
+
+	const uint64_t framePeriod = (uint64_t)(1000000000.0 / options.frameRate);
+	const uint64_t reportPeriod = (uint64_t)(options.reportInterval * 1000000000.0);
+	const uint64_t start = NowNs();
+	const uint64_t end = (options.duration > 0) ? start + (uint64_t)(options.duration * 1000000000.0) : UINT64_MAX;
+
+	uint64_t nextFrame = start;
+	uint64_t nextReport = start + reportPeriod;
+	uint64_t lastReport = start;
+	uint64_t frame = 0;
+	uint64_t lateFrames = 0;
+
+	printf("Running %u instance(s) at %.1f fps, %ux%u, %u parameter change(s) per frame\n",
+		options.instances, options.frameRate, options.width, options.height, options.parameterChanges);
+
+	while (!stopRequested && NowNs() < end)
+	{
+		double time = (double)(NowNs() - start) / 1000000000.0;
+
+		for (size_t i = 0; i < instances.size(); i++)
+		{
+			if (instances[i].id != NULL)
+			{
+				Frame(instances[i], time);
+			}
+		}
+
+		if (hasContext)
+		{
+			glFinish();
+		}
+
+		frame++;
+
+		// recreate one instance every churnFrames frames to exercise
+		// the instantiate / deinstantiate paths during soaks
+		if (options.churnFrames > 0 && frame % options.churnFrames == 0 && !instances.empty())
+		{
+			SimulatedInstance& instance = instances[(frame / options.churnFrames) % instances.size()];
+			DeInstantiate(instance);
+			Instantiate(instance);
+		}
+
+		// alternate between the base size and a smaller one
+		if (options.resizeFrames > 0 && frame % options.resizeFrames == 0)
+		{
+			bool shrink = ((frame / options.resizeFrames) % 2) == 1;
+
+			FFGLViewportStruct viewport;
+			viewport.x = 0;
+			viewport.y = 0;
+			viewport.width = shrink ? options.width / 2 : options.width;
+			viewport.height = shrink ? options.height / 2 : options.height;
+
+			FFMixed input;
+			input.PointerValue = &viewport;
+
+			for (size_t i = 0; i < instances.size(); i++)
+			{
+				if (instances[i].id != NULL && Call(CALL_RESIZE, FF_RESIZE, input, instances[i].id).UIntValue != FF_SUCCESS)
+				{
+					failures[CALL_RESIZE]++;
+				}
+			}
+
+			CreateInputTexture(viewport.width, viewport.height);
+		}
+
+		uint64_t now = NowNs();
+		if (reportPeriod > 0 && now >= nextReport)
+		{
+			char title[64];
+			snprintf(title, sizeof(title), "frame %llu", (unsigned long long)frame);
+			PrintReport(title, interval, (double)(now - lastReport) / 1000000000.0);
+
+			for (int c = 0; c < CALL_COUNT; c++)
+			{
+				interval[c].Reset();
+			}
+
+			lastReport = now;
+			nextReport = now + reportPeriod;
+		}
+
+		nextFrame += framePeriod;
+		if (nextFrame < now)
+		{
+			// running behind, drop the missed slots instead of bursting to catch up
+			lateFrames++;
+			nextFrame = now;
+		}
+		else
+		{
+			SleepUntilNs(nextFrame);
+		}
+	}
+
+	double elapsed = (double)(NowNs() - start) / 1000000000.0;
+	printf("\n%llu frame(s) in %.1f s, %llu late\n", (unsigned long long)frame, elapsed, (unsigned long long)lateFrames);
+	PrintReport("total", totals, elapsed);
+
+#ifdef _WIN32
+	timeEndPeriod(1);
+#endif
+}
+
+void HostSimulator::Shutdown()
+{
+	for (size_t i = 0; i < instances.size(); i++)
+	{
+		DeInstantiate(instances[i]);
+	}
+	instances.clear();
+
+	if (plugMain != NULL)
+	{
+		FFMixed input;
+		input.UIntValue = 0;
+		plugMain(FF_DEINITIALISE, input, NULL);
+		plugMain = NULL;
+	}
+
+	if (inputTexture != 0)
+	{
+		glDeleteTextures(1, &inputTexture);
+		inputTexture = 0;
+	}
+
+	DestroyContext();
+
+	if (library != NULL)
+	{
+#ifdef _WIN32
+		FreeLibrary((HMODULE)library);
+#else
+		dlclose(library);
+#endif
+		library = NULL;
+	}
+}
+
+void HostSimulator::DestroyContext()
+{
+	hasContext = false;
+
+#ifdef _WIN32
+	if (context != NULL)
+	{
+		wglMakeCurrent(NULL, NULL);
+		wglDeleteContext(context);
+		context = NULL;
+	}
+
+	if (window != NULL)
+	{
+		if (dc != NULL) ReleaseDC(window, dc);
+		DestroyWindow(window);
+		window = NULL;
+		dc = NULL;
+	}
+#else
+	if (display != EGL_NO_DISPLAY)
+	{
+		eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+		if (context != EGL_NO_CONTEXT) eglDestroyContext(display, context);
+		if (surface != EGL_NO_SURFACE) eglDestroySurface(display, surface);
+		eglTerminate(display);
+
+		display = EGL_NO_DISPLAY;
+		context = EGL_NO_CONTEXT;
+		surface = EGL_NO_SURFACE;
+	}
+#endif
+}
+
+void HostSimulator::PrintReport(const char* title, const LatencyHistogram* histograms, double elapsed)
+{
+	printf("\n[%s] %.1f s, rss %lu kB\n", title, elapsed, ResidentSetKb());
+	printf("  %-16s %10s %9s %9s %9s %9s %9s %9s %7s\n", "call", "count", "calls/s", "mean us", "p50 us", "p95 us", "p99 us", "max us", "failed");
+
+	for (int c = 0; c < CALL_COUNT; c++)
+	{
+		const LatencyHistogram& h = histograms[c];
+		if (h.GetCount() == 0)
+		{
+			continue;
+		}
+
+		printf("  %-16s %10llu %9.0f %9.1f %9.1f %9.1f %9.1f %9.1f %7llu\n",
+			callNames[c],
+			(unsigned long long)h.GetCount(),
+			elapsed > 0 ? (double)h.GetCount() / elapsed : 0.0,
+			h.GetMean() / 1000.0,
+			(double)h.GetPercentile(50) / 1000.0,
+			(double)h.GetPercentile(95) / 1000.0,
+			(double)h.GetPercentile(99) / 1000.0,
+			(double)h.GetMax() / 1000.0,
+			(unsigned long long)failures[c]);
+	}
+
+	fflush(stdout);
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+static void PrintUsage(const char* program)
+{
+	printf("Usage: %s <plugin.dll|plugin.so> [options]\n", program);
+	printf("  -n <count>    plugin instances (default 1)\n");
+	printf("  -r <fps>      frames per second (default 60)\n");
+	printf("  -d <seconds>  run time, 0 runs until interrupted (default 10)\n");
+	printf("  -w <width>    viewport width (default 1280)\n");
+	printf("  -h <height>   viewport height (default 720)\n");
+	printf("  -p <count>    random parameter changes per instance and frame (default 2)\n");
+	printf("  -t            also set text parameters (back to their default value)\n");
+	printf("  -c <frames>   recreate one instance every <frames> frames (default off)\n");
+	printf("  -z <frames>   resize all instances every <frames> frames (default off)\n");
+	printf("  -i <seconds>  periodic report interval, 0 disables (default 10)\n");
+	printf("  -s <seed>     random seed (default 1)\n");
+#ifdef _WIN32
+	printf("  -g <mode>     GL context, wgl or none (default wgl)\n");
+#else
+	printf("  -g <mode>     GL context, egl or none (default egl)\n");
+#endif
+}
+
+// Fills in options from the command line, getopt style but without getopt,
+// which the Windows C runtime does not have
+static bool ParseArguments(int argc, char* argv[], SimulatorOptions& options)
+{
+	for (int i = 1; i < argc; i++)
+	{
+		const char* arg = argv[i];
+		if (arg[0] != '-' || arg[1] == '\0' || arg[2] != '\0')
+		{
+			if (arg[0] == '-' || !options.pluginPath.empty())
+			{
+				return false;
+			}
+			options.pluginPath = arg;
+			continue;
+		}
+
+		if (arg[1] == 't')
+		{
+			options.textParameters = true;
+			continue;
+		}
+
+		if (i + 1 >= argc)
+		{
+			return false;
+		}
+		const char* value = argv[++i];
+
+		switch (arg[1])
+		{
+		case 'n': options.instances = (unsigned int)atoi(value); break;
+		case 'r': options.frameRate = atof(value); break;
+		case 'd': options.duration = atof(value); break;
+		case 'w': options.width = (unsigned int)atoi(value); break;
+		case 'h': options.height = (unsigned int)atoi(value); break;
+		case 'p': options.parameterChanges = (unsigned int)atoi(value); break;
+		case 'c': options.churnFrames = (unsigned int)atoi(value); break;
+		case 'z': options.resizeFrames = (unsigned int)atoi(value); break;
+		case 'i': options.reportInterval = atof(value); break;
+		case 's': options.seed = (unsigned int)strtoul(value, NULL, 10); break;
+		case 'g': options.glMode = value; break;
+		default:
+			return false;
+		}
+	}
+
+	return !options.pluginPath.empty();
+}
+
+int main(int argc, char* argv[])
+{
+	SimulatorOptions options;
+#ifdef _WIN32
+	const char* contextMode = "wgl";
+#else
+	const char* contextMode = "egl";
+#endif
+	options.glMode = contextMode;
+	options.instances = 1;
+	options.frameRate = 60.0;
+	options.duration = 10.0;
+	options.width = 1280;
+	options.height = 720;
+	options.parameterChanges = 2;
+	options.churnFrames = 0;
+	options.resizeFrames = 0;
+	options.reportInterval = 10.0;
+	options.seed = 1;
+	options.textParameters = false;
+
+	if (!ParseArguments(argc, argv, options) || options.frameRate <= 0 || options.width == 0 || options.height == 0
+		|| (options.glMode != contextMode && options.glMode != "none"))
+	{
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	HostSimulator simulator(options);
+
+	// the context must be current before the plugin is initialised,
+	// FFGL plugins load their GL extensions in FF_INITIALISE
+	if (!simulator.CreateContext() || !simulator.Load())
+	{
+		return 1;
+	}
+
+	simulator.Run();
+	simulator.Shutdown();
+
+	return 0;
+}
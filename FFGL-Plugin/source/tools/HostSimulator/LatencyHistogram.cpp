@@ -0,0 +1,127 @@
+//**********************************************************************************
+//
+// LatencyHistogram.cpp
+//
+//**********************************************************************************
+
+#include "LatencyHistogram.h"
+
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+// Index of the most significant set bit, value must not be zero
+static unsigned int MostSignificantBit(uint64_t value)
+{
+#if defined(_MSC_VER) && defined(_WIN64)
+	unsigned long index;
+	_BitScanReverse64(&index, value);
+	return (unsigned int)index;
+#elif defined(_MSC_VER)
+	unsigned long index;
+	if (_BitScanReverse(&index, (unsigned long)(value >> 32)))
+	{
+		return (unsigned int)index + 32;
+	}
+	_BitScanReverse(&index, (unsigned long)value);
+	return (unsigned int)index;
+#else
+	return 63 - __builtin_clzll(value);
+#endif
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+LatencyHistogram::LatencyHistogram()
+{
+	Reset();
+}
+
+void LatencyHistogram::Reset()
+{
+	memset(buckets, 0, sizeof(buckets));
+	count = 0;
+	minValue = UINT64_MAX;
+	maxValue = 0;
+	sum = 0.0;
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+unsigned int LatencyHistogram::BucketIndex(uint64_t value)
+{
+	// values below LATENCY_SUB_BUCKETS map one to one on the first row
+	if (value < LATENCY_SUB_BUCKETS)
+	{
+		return (unsigned int)value;
+	}
+
+	unsigned int msb = MostSignificantBit(value);
+	unsigned int shift = msb - LATENCY_SUB_BUCKET_BITS;
+	unsigned int row = shift + 1;
+	unsigned int column = (unsigned int)(value >> shift) - LATENCY_SUB_BUCKETS;
+
+	return row * LATENCY_SUB_BUCKETS + column;
+}
+
+uint64_t LatencyHistogram::BucketUpperBound(unsigned int index)
+{
+	unsigned int row = index / LATENCY_SUB_BUCKETS;
+	uint64_t column = index % LATENCY_SUB_BUCKETS;
+
+	if (row == 0)
+	{
+		return column;
+	}
+
+	unsigned int shift = row - 1;
+	return ((LATENCY_SUB_BUCKETS + column + 1) << shift) - 1;
+}
+
+//**********************************************************************************
+//**********************************************************************************
+
+void LatencyHistogram::Record(uint64_t nanoseconds)
+{
+	buckets[BucketIndex(nanoseconds)]++;
+	count++;
+	sum += (double)nanoseconds;
+
+	if (nanoseconds < minValue) minValue = nanoseconds;
+	if (nanoseconds > maxValue) maxValue = nanoseconds;
+}
+
+double LatencyHistogram::GetMean() const
+{
+	return (count > 0) ? sum / (double)count : 0.0;
+}
+
+uint64_t LatencyHistogram::GetPercentile(double percentile) const
+{
+	if (count == 0)
+	{
+		return 0;
+	}
+
+	uint64_t rank = (uint64_t)(percentile / 100.0 * (double)count + 0.5);
+	if (rank < 1) rank = 1;
+	if (rank > count) rank = count;
+
+	uint64_t seen = 0;
+	for (unsigned int i = 0; i < LATENCY_BUCKET_COUNT; i++)
+	{
+		seen += buckets[i];
+		if (seen >= rank)
+		{
+			// never report more than what was actually measured
+			uint64_t bound = BucketUpperBound(i);
+			return (bound < maxValue) ? bound : maxValue;
+		}
+	}
+
+	return maxValue;
+}
@@ -0,0 +1,47 @@
+//**********************************************************************************
+//
+// LatencyHistogram.h
+//
+// Fixed size log-linear histogram of call latencies, used by the host simulator
+// to report per-call percentiles without keeping every sample around.
+//
+// Values are recorded in nanoseconds; each power of two range is split in
+// LATENCY_SUB_BUCKETS linear buckets, so the relative error of a reported
+// percentile is below 1 / LATENCY_SUB_BUCKETS.
+//
+//**********************************************************************************
+
+#pragma once
+
+#include <stdint.h>
+
+#define LATENCY_SUB_BUCKET_BITS 4
+#define LATENCY_SUB_BUCKETS (1 << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_BUCKET_COUNT ((64 - LATENCY_SUB_BUCKET_BITS + 1) * LATENCY_SUB_BUCKETS)
+
+class LatencyHistogram
+{
+public:
+	LatencyHistogram();
+
+	void Reset();
+	void Record(uint64_t nanoseconds);
+
+	uint64_t GetCount() const { return count; }
+	uint64_t GetMin() const { return (count > 0) ? minValue : 0; }
+	uint64_t GetMax() const { return maxValue; }
+	double GetMean() const;
+
+	// percentile in [0, 100], returns the upper bound of the bucket holding it
+	uint64_t GetPercentile(double percentile) const;
+
+private:
+	static unsigned int BucketIndex(uint64_t value);
+	static uint64_t BucketUpperBound(unsigned int index);
+
+	uint64_t buckets[LATENCY_BUCKET_COUNT];
+	uint64_t count;
+	uint64_t minValue;
+	uint64_t maxValue;
+	double sum;
+};
@@ -47,6 +47,10 @@ void ofApp::setup()
 	font.load("Arial", 45);
 	currentHue = 0.0;
 	currentParameterX = currentParameterY = currentParameterRotate = 0;
+	showStats = false;
+
+	// Kept in memory until written with "d"
+	ofxFFGLSpoutBridge::startTrace();
 
 	ofEnableSmoothing();
 }
@@ -56,6 +60,13 @@ void ofApp::setup()
 
 void ofApp::update()
 {
+	// frames and osc messages of a capture, if one is playing
+	replay.update();
+	if (!replay.isRunning() && spoutBridge.getMemoryShare())
+	{
+		spoutBridge.setMemoryShare(false); // back to the host
+	}
+
 	// check for waiting osc messages
 	while (oscReceiver.hasWaitingMessages())
 	{
@@ -64,12 +75,36 @@ void ofApp::update()
 		oscReceiver.getNextMessage(message);
 
 		// is this message meant for us?
-		if (message.getAddress() == "/" + shareName)
+		// the plugin sends each parameter that changed as "/<share name>/param/<index>"
+		string parameterPrefix = "/" + shareName + "/param/";
+		if (message.getAddress().compare(0, parameterPrefix.size(), parameterPrefix) == 0)
 		{
-			// we have three floats waiting for us
-			currentParameterX = message.getArgAsFloat(0);
-			currentParameterY = message.getArgAsFloat(1);
-			currentParameterRotate = message.getArgAsFloat(2);
+			int index = ofToInt(message.getAddress().substr(parameterPrefix.size()));
+			float value = message.getArgAsFloat(0);
+
+			switch (index)
+			{
+			case 0:
+				currentParameterX = value;
+				break;
+			case 1:
+				currentParameterY = value;
+				break;
+			case 2:
+				currentParameterRotate = value;
+				break;
+			}
+		}
+
+		// and once per second the time spent in each stage of the plugin
+		// as "/<share name>/stats/<stage>" p50 p95 p99, in milliseconds
+		string statsPrefix = "/" + shareName + "/stats/";
+		if (message.getAddress().compare(0, statsPrefix.size(), statsPrefix) == 0 && message.getNumArgs() >= 3)
+		{
+			pluginStats[message.getAddress().substr(statsPrefix.size())] =
+				ofToString(message.getArgAsFloat(0), 2) + " / " +
+				ofToString(message.getArgAsFloat(1), 2) + " / " +
+				ofToString(message.getArgAsFloat(2), 2) + " ms";
 		}
 	}
 }
@@ -132,6 +167,17 @@ void ofApp::draw()
 	sharedFbo.draw(0, 0);
 
 	spoutBridge.send();
+
+	if (showStats)
+	{
+		// Drawn after sending, the host doesn't get them
+		string text = "plugin stage p50 / p95 / p99\n";
+		for (auto itr = pluginStats.begin(); itr != pluginStats.end(); itr++)
+		{
+			text += itr->first + ": " + itr->second + "\n";
+		}
+		ofDrawBitmapStringHighlight(text, 10, 20);
+	}
 }
 
 //******************************************************************
@@ -160,6 +206,30 @@ void ofApp::keyPressed(int key)
 			oscReceiver.setup(currentOscPort);
 		}
 	}
+	else if (key == 't')
+	{
+		spoutBridge.setPipelined(!spoutBridge.isPipelined());
+	}
+	else if (key == 's')
+	{
+		showStats = !showStats;
+	}
+	else if (key == 'r' || key == 'R')
+	{
+		// Captures are named after the sharing name, use the same one here
+		ofFileDialogResult result = ofSystemLoadDialog("Plugin capture to replay");
+		if (result.bSuccess && replay.load(result.getPath(), shareName, currentOscPort))
+		{
+			spoutBridge.setMemoryShare(true); // the replay sends by memoryshare
+			replay.start(key == 'R'); // shift: as fast as possible
+		}
+	}
+	else if (key == 'd')
+	{
+		string timestamp = ofGetTimestampString();
+		ofxFFGLSpoutBridge::writeTrace(ofToDataPath("trace_" + timestamp + ".json", true));
+		ofxFFGLSpoutBridge::writeLockStats(ofToDataPath("locks_" + timestamp + ".txt", true));
+	}
 }
 
 //******************************************************************
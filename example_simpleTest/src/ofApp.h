@@ -32,6 +32,7 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ofMain.h"
 #include "ofxOsc.h"
 #include "ofxFFGLSpoutBridge.h"
+#include "ofxFFGLSpoutBridgeReplay.h"
 
 // Important: if you get errors from ofxOsc addon complaining about missing headers
 // remove the "ofxOsc/libs/oscpack/src/ip/posix" directory from your project
@@ -56,4 +57,11 @@ private:
 	ofTrueTypeFont font;
 
 	float currentParameterX, currentParameterY, currentParameterRotate;
+
+	// Plugin stage timings, one line per stage
+	map<string, string> pluginStats;
+	bool showStats;
+
+	// Plays a plugin capture in place of the host
+	ofxFFGLSpoutBridgeReplay replay;
 };
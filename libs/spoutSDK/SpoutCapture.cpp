@@ -0,0 +1,297 @@
+/*
+
+	spoutCapture.cpp
+
+	Binary capture of the traffic of a sharing session.
+	See spoutCapture.h
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "SpoutCapture.h"
+
+#include <string.h>
+
+static const char g_CaptureMagic[4] = { 'S', 'P', 'C', 'P' };
+
+// Largest record, 64 MiB. The writer keeps frame records below it, so
+// anything bigger is a damaged file.
+#define CAPTURE_MAX_RECORD (64*1024*1024)
+#define CAPTURE_FRAME_HEADER_SIZE (4 + 4 + 8 + 1)
+
+template <typename T>
+static void WriteValue(FILE *file, T value)
+{
+	fwrite(&value, sizeof(T), 1, file);
+}
+
+template <typename T>
+static bool ReadValue(FILE *file, T &value)
+{
+	return fread(&value, sizeof(T), 1, file) == 1;
+}
+
+
+//
+// spoutCaptureWriter
+//
+
+spoutCaptureWriter::spoutCaptureWriter()
+{
+	m_file = NULL;
+	m_level = SPOUT_CAPTURE_HEADERS;
+}
+
+spoutCaptureWriter::~spoutCaptureWriter()
+{
+	Close();
+}
+
+bool spoutCaptureWriter::Open(const char *path, int level)
+{
+	Close();
+
+	if(fopen_s(&m_file, path, "wb") != 0 || m_file == NULL) {
+		m_file = NULL;
+		return false;
+	}
+
+	// Pixel records are large, write them in big blocks
+	setvbuf(m_file, NULL, _IOFBF, 1024*1024);
+
+	m_level = level;
+	m_start = std::chrono::steady_clock::now();
+
+	fwrite(g_CaptureMagic, 1, 4, m_file);
+	WriteValue<unsigned int>(m_file, SPOUT_CAPTURE_VERSION);
+	WriteValue<unsigned int>(m_file, (unsigned int)level);
+
+	return true;
+}
+
+void spoutCaptureWriter::Close()
+{
+	if(m_file) {
+		fclose(m_file);
+		m_file = NULL;
+	}
+}
+
+bool spoutCaptureWriter::IsOpen()
+{
+	return m_file != NULL;
+}
+
+int spoutCaptureWriter::GetLevel()
+{
+	return m_level;
+}
+
+void spoutCaptureWriter::WriteFrame(unsigned int width, unsigned int height, const unsigned char *pixels)
+{
+	if(!m_file) return;
+
+	size_t pixelSize = (size_t)width*height*4;
+	unsigned long long hash = (m_level >= SPOUT_CAPTURE_HASHES && pixels != NULL) ? Hash(pixels, pixelSize) : 0;
+
+	// Pixels that would not fit in a record the reader accepts are dropped,
+	// the frame is then replayed from its hash
+	bool bPixels = m_level >= SPOUT_CAPTURE_PIXELS && pixels != NULL
+		&& pixelSize <= CAPTURE_MAX_RECORD - CAPTURE_FRAME_HEADER_SIZE;
+
+	WriteHeader(SPOUT_CAPTURE_FRAME, CAPTURE_FRAME_HEADER_SIZE + (unsigned int)(bPixels ? pixelSize : 0));
+	WriteValue<unsigned int>(m_file, width);
+	WriteValue<unsigned int>(m_file, height);
+	WriteValue<unsigned long long>(m_file, hash);
+	WriteValue<unsigned char>(m_file, bPixels ? 1 : 0);
+	if(bPixels)
+		fwrite(pixels, 1, pixelSize, m_file);
+}
+
+void spoutCaptureWriter::WriteSenderEvent(int event, const char *name, unsigned int width, unsigned int height)
+{
+	if(!m_file) return;
+
+	unsigned int length = name ? (unsigned int)strlen(name) : 0;
+
+	WriteHeader(SPOUT_CAPTURE_SENDER, 4 + 4 + 4 + 4 + length);
+	WriteValue<unsigned int>(m_file, (unsigned int)event);
+	WriteValue<unsigned int>(m_file, width);
+	WriteValue<unsigned int>(m_file, height);
+	WriteValue<unsigned int>(m_file, length);
+	if(length > 0)
+		fwrite(name, 1, length, m_file);
+}
+
+void spoutCaptureWriter::WriteOsc(const char *data, size_t size)
+{
+	if(!m_file) return;
+
+	WriteHeader(SPOUT_CAPTURE_OSC, (unsigned int)size);
+	fwrite(data, 1, size, m_file);
+}
+
+void spoutCaptureWriter::WriteHeader(int type, unsigned int size)
+{
+	unsigned long long time = std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - m_start).count();
+
+	WriteValue<unsigned char>(m_file, (unsigned char)type);
+	WriteValue<unsigned long long>(m_file, time);
+	WriteValue<unsigned int>(m_file, size);
+}
+
+unsigned long long spoutCaptureWriter::Hash(const unsigned char *data, size_t size)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	for(size_t i = 0; i < size; i++) {
+		hash ^= data[i];
+		hash *= 1099511628211ULL;
+	}
+	return hash;
+}
+
+
+//
+// spoutCaptureReader
+//
+
+spoutCaptureReader::spoutCaptureReader()
+{
+	m_file = NULL;
+	m_level = SPOUT_CAPTURE_HEADERS;
+	m_firstRecord = 0;
+}
+
+spoutCaptureReader::~spoutCaptureReader()
+{
+	Close();
+}
+
+bool spoutCaptureReader::Open(const char *path)
+{
+	Close();
+
+	if(fopen_s(&m_file, path, "rb") != 0 || m_file == NULL) {
+		m_file = NULL;
+		return false;
+	}
+
+	char magic[4];
+	unsigned int version = 0;
+	unsigned int level = 0;
+	if(fread(magic, 1, 4, m_file) != 4 || memcmp(magic, g_CaptureMagic, 4) != 0
+		|| !ReadValue(m_file, version) || version != SPOUT_CAPTURE_VERSION
+		|| !ReadValue(m_file, level)) {
+		Close();
+		return false;
+	}
+
+	m_level = (int)level;
+	m_firstRecord = ftell(m_file);
+
+	return true;
+}
+
+void spoutCaptureReader::Close()
+{
+	if(m_file) {
+		fclose(m_file);
+		m_file = NULL;
+	}
+}
+
+bool spoutCaptureReader::IsOpen()
+{
+	return m_file != NULL;
+}
+
+int spoutCaptureReader::GetLevel()
+{
+	return m_level;
+}
+
+bool spoutCaptureReader::Read(spoutCaptureRecord &record)
+{
+	if(!m_file) return false;
+
+	unsigned char type;
+	unsigned int size;
+	if(!ReadValue(m_file, type) || !ReadValue(m_file, record.time) || !ReadValue(m_file, size))
+		return false;
+
+	if(size > CAPTURE_MAX_RECORD)
+		return false;
+
+	record.type = type;
+	record.width = record.height = 0;
+	record.hash = 0;
+	record.event = 0;
+	record.name.clear();
+	record.data.clear();
+
+	switch(type) {
+
+		case SPOUT_CAPTURE_FRAME : {
+			unsigned char bPixels = 0;
+			if(size < CAPTURE_FRAME_HEADER_SIZE || !ReadValue(m_file, record.width) || !ReadValue(m_file, record.height)
+				|| !ReadValue(m_file, record.hash) || !ReadValue(m_file, bPixels))
+				return false;
+			if(bPixels) {
+				size_t pixelSize = (size_t)record.width*record.height*4;
+				if(pixelSize != size - CAPTURE_FRAME_HEADER_SIZE) return false;
+				record.data.resize(pixelSize);
+				if(fread(record.data.data(), 1, pixelSize, m_file) != pixelSize) return false;
+			}
+			return true;
+		}
+
+		case SPOUT_CAPTURE_SENDER : {
+			unsigned int event = 0, length = 0;
+			if(size < 16 || !ReadValue(m_file, event) || !ReadValue(m_file, record.width)
+				|| !ReadValue(m_file, record.height) || !ReadValue(m_file, length) || length != size - 16)
+				return false;
+			record.event = (int)event;
+			record.name.resize(length);
+			if(length > 0 && fread(&record.name[0], 1, length, m_file) != length) return false;
+			return true;
+		}
+
+		case SPOUT_CAPTURE_OSC :
+			record.data.resize(size);
+			return size == 0 || fread(record.data.data(), 1, size, m_file) == size;
+
+		default :
+			// Record type from a later version
+			return fseek(m_file, size, SEEK_CUR) == 0 && Read(record);
+	}
+}
+
+void spoutCaptureReader::Rewind()
+{
+	if(m_file) fseek(m_file, m_firstRecord, SEEK_SET);
+}
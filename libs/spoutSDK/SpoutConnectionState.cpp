@@ -0,0 +1,182 @@
+/*
+
+	spoutConnectionState.cpp
+
+	Connection retry policy for receivers waiting for a sender.
+	See spoutConnectionState.h
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "SpoutConnectionState.h"
+
+#include <functional>
+
+// Default backoff, msec
+#define CONNECTION_MIN_DELAY 50
+#define CONNECTION_MAX_DELAY 1000
+
+spoutConnectionState::spoutConnectionState()
+{
+	m_dwMinMsec = CONNECTION_MIN_DELAY;
+	m_dwMaxMsec = CONNECTION_MAX_DELAY;
+
+	m_attempts = 0;
+	m_skipped = 0;
+	m_connections = 0;
+	m_lastConnectTime = 0.0;
+
+	Disconnected();
+}
+
+spoutConnectionState::~spoutConnectionState()
+{
+
+}
+
+void spoutConnectionState::SetSenderName(const char *sendername)
+{
+	m_sendername = sendername ? sendername : "";
+	Disconnected();
+}
+
+void spoutConnectionState::SetBackoff(DWORD dwMinMsec, DWORD dwMaxMsec)
+{
+	m_dwMinMsec = dwMinMsec;
+	m_dwMaxMsec = dwMaxMsec > dwMinMsec ? dwMaxMsec : dwMinMsec;
+	m_dwDelay = m_dwMinMsec;
+}
+
+
+bool spoutConnectionState::ShouldConnect()
+{
+	if(!IsDue())
+		return false;
+
+	// One read of the sender name set, no sender shared memory is opened
+	std::set<std::string> senders;
+	m_senders.GetSenderNames(&senders);
+
+	return ShouldConnect(senders);
+}
+
+bool spoutConnectionState::ShouldConnect(const std::set<std::string> &senders)
+{
+	if(!IsDue())
+		return false;
+
+	if(!m_sendername.empty() && senders.find(m_sendername) == senders.end()) {
+		m_skipped++;
+		Schedule();
+		return false;
+	}
+
+	std::string names;
+	for(auto itr = senders.begin(); itr != senders.end(); itr++) {
+		names += *itr;
+		names += '\0';
+	}
+	size_t hash = std::hash<std::string>()(names);
+
+	// Nothing changed since the last failure, wait for the longest delay
+	if(m_bFailedSetValid && hash == m_failedSetHash && m_dwDelay < m_dwMaxMsec) {
+		m_skipped++;
+		Schedule();
+		return false;
+	}
+
+	m_failedSetHash = hash;
+	return true;
+}
+
+void spoutConnectionState::Connected()
+{
+	m_attempts++;
+	m_connections++;
+	m_bConnected = true;
+
+	m_lastConnectTime = std::chrono::duration<double, std::milli>(clock::now() - m_disconnectTime).count();
+}
+
+void spoutConnectionState::Failed()
+{
+	m_attempts++;
+	m_bFailedSetValid = true;
+	Schedule();
+}
+
+void spoutConnectionState::Disconnected()
+{
+	// The sender may come back at once, e.g. after a resize or a restart
+	m_bConnected = false;
+	m_bFailedSetValid = false;
+	m_failedSetHash = 0;
+	m_dwDelay = m_dwMinMsec;
+	m_disconnectTime = clock::now();
+	m_nextCheck = m_disconnectTime;
+}
+
+bool spoutConnectionState::IsConnected()
+{
+	return m_bConnected;
+}
+
+
+unsigned int spoutConnectionState::GetAttempts()
+{
+	return m_attempts;
+}
+
+unsigned int spoutConnectionState::GetSkipped()
+{
+	return m_skipped;
+}
+
+unsigned int spoutConnectionState::GetConnections()
+{
+	return m_connections;
+}
+
+double spoutConnectionState::GetLastConnectTime()
+{
+	return m_lastConnectTime;
+}
+
+
+bool spoutConnectionState::IsDue()
+{
+	return !m_bConnected && clock::now() >= m_nextCheck;
+}
+
+void spoutConnectionState::Schedule()
+{
+	m_nextCheck = clock::now() + std::chrono::milliseconds(m_dwDelay);
+
+	m_dwDelay *= 2;
+	if(m_dwDelay > m_dwMaxMsec)
+		m_dwDelay = m_dwMaxMsec;
+}
@@ -0,0 +1,116 @@
+/*
+
+	spoutConnectionState.h
+
+	Connection retry policy for receivers waiting for a sender.
+
+	Calling CreateReceiver every frame while the sender is absent opens
+	shared memory and reads the registry each time, for nothing. Here
+	attempts are spaced with an exponential backoff, and when it is time
+	to try the sender name set is read first :
+
+	- no attempt is made while the sender is not listed
+	- no attempt is made while the set is the same as when the last
+	  attempt failed, until the backoff reaches its maximum
+
+	Attempts, skipped checks and the time it took to connect are counted.
+
+	Use : while not connected call ShouldConnect every frame and only
+	try to connect when it returns true, then report the outcome with
+	Connected or Failed. Call Disconnected when the connection is lost.
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#pragma once
+
+#ifndef __spoutConnectionState__
+#define __spoutConnectionState__
+
+#include "SpoutCommon.h"
+#include "SpoutSenderNames.h"
+#include <string>
+#include <set>
+#include <chrono>
+
+class SPOUT_DLLEXP spoutConnectionState {
+
+	public:
+
+		spoutConnectionState();
+		~spoutConnectionState();
+
+		// Sender to wait for, starts over as disconnected
+		void SetSenderName(const char *sendername);
+
+		// Delay after the first failed attempt and upper bound of the backoff
+		void SetBackoff(DWORD dwMinMsec, DWORD dwMaxMsec);
+
+		// Reads the sender name set itself
+		bool ShouldConnect();
+		// Same with a sender name set the caller has already read, e.g.
+		// once per frame for several connections
+		bool ShouldConnect(const std::set<std::string> &senders);
+		void Connected();
+		void Failed();
+		void Disconnected();
+		bool IsConnected();
+
+		// Metrics
+		unsigned int GetAttempts();    // connection attempts made
+		unsigned int GetSkipped();     // checks that found no reason to attempt
+		unsigned int GetConnections(); // successful attempts
+		double GetLastConnectTime();   // msec from disconnection to connection
+
+	protected:
+
+		typedef std::chrono::steady_clock clock;
+
+		bool IsDue();    // not connected and the delay has run out
+		void Schedule(); // next check after the current delay, then grow it
+
+		spoutSenderNames m_senders;
+		std::string m_sendername;
+
+		bool m_bConnected;
+		DWORD m_dwMinMsec;
+		DWORD m_dwMaxMsec;
+		DWORD m_dwDelay;
+		clock::time_point m_nextCheck;
+		clock::time_point m_disconnectTime;
+
+		bool m_bFailedSetValid;
+		size_t m_failedSetHash; // sender set when the last attempt failed
+
+		unsigned int m_attempts;
+		unsigned int m_skipped;
+		unsigned int m_connections;
+		double m_lastConnectTime;
+
+};
+
+#endif
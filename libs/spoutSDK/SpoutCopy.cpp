@@ -35,6 +35,7 @@
 				   Revise rgb2rgba etc.
 		11.10.16 - Added SSSE detection and rgba-bgra function
 		04.01.17 - Added rgb2bgra, bgr2bgra, bgra2rgb, bgra2bgr
+		19.10.26 - Added half float and 10 bit conversions for RGBA16F and RGB10A2 textures
 
 */
 #include "spoutCopy.h"
@@ -695,3 +696,227 @@ void spoutCopy::bgra2bgr(void *bgra_source, void *bgr_dest, unsigned int width,
 
 } // end bgra2bgr
 
+
+
+//
+// Half float and packed 10 bit conversions, for RGBA16F and RGB10A2 shared textures.
+// Pixels are in rgba order, 4 half floats or one 32 bit value with red in the low bits
+// (GL_UNSIGNED_INT_2_10_10_10_REV, DXGI_FORMAT_R10G10B10A2_UNORM).
+//
+
+unsigned short spoutCopy::FloatToHalf(float value)
+{
+	unsigned int f;
+	memcpy((void *)&f, (void *)&value, 4);
+
+	unsigned int sign = (f >> 16) & 0x8000;
+	unsigned int mantissa = f & 0x007FFFFF;
+	int exponent = (int)((f >> 23) & 0xFF) - 127 + 15;
+	unsigned int half;
+
+	if(((f >> 23) & 0xFF) == 0xFF) // Infinity or NaN
+		return (unsigned short)(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+
+	if(exponent >= 31) // Too large, infinity
+		return (unsigned short)(sign | 0x7C00);
+
+	if(exponent <= 0) {
+		// Too small, zero
+		if(exponent < -10)
+			return (unsigned short)sign;
+		// Denormal, with the implicit leading bit
+		mantissa |= 0x00800000;
+		unsigned int shift = (unsigned int)(14 - exponent);
+		half = mantissa >> shift;
+		if((mantissa >> (shift - 1)) & 1) half++; // round
+		return (unsigned short)(sign | half);
+	}
+
+	half = sign | ((unsigned int)exponent << 10) | (mantissa >> 13);
+	if(mantissa & 0x1000) half++; // round, a carry into the exponent is still correct
+	return (unsigned short)half;
+}
+
+
+float spoutCopy::HalfToFloat(unsigned short value)
+{
+	unsigned int sign = (unsigned int)(value & 0x8000) << 16;
+	int exponent = (value >> 10) & 0x1F;
+	unsigned int mantissa = value & 0x3FF;
+	unsigned int f;
+	float result;
+
+	if(exponent == 0) {
+		if(mantissa == 0) {
+			f = sign; // zero
+		}
+		else {
+			// Denormal, normalize it
+			exponent = 1;
+			while(!(mantissa & 0x400)) {
+				mantissa <<= 1;
+				exponent--;
+			}
+			mantissa &= 0x3FF;
+			f = sign | ((unsigned int)(exponent + 127 - 15) << 23) | (mantissa << 13);
+		}
+	}
+	else if(exponent == 31) {
+		f = sign | 0x7F800000 | (mantissa << 13); // Infinity or NaN
+	}
+	else {
+		f = sign | ((unsigned int)(exponent + 127 - 15) << 23) | (mantissa << 13);
+	}
+
+	memcpy((void *)&result, (void *)&f, 4);
+	return result;
+}
+
+
+// 4 floats to 4 half floats per pixel
+void spoutCopy::float2half(void *float_source, void *half_dest, unsigned int width, unsigned int height, bool bInvert)
+{
+	unsigned long pitch = width*4;
+
+	for (unsigned int y = 0; y < height; y++) {
+		const float *src = (const float *)float_source + (bInvert ? height-1-y : y)*pitch;
+		unsigned short *dst = (unsigned short *)half_dest + y*pitch;
+		for (unsigned long x = 0; x < pitch; x++)
+			dst[x] = FloatToHalf(src[x]);
+	}
+
+} // end float2half
+
+
+void spoutCopy::half2float(void *half_source, void *float_dest, unsigned int width, unsigned int height, bool bInvert)
+{
+	unsigned long pitch = width*4;
+
+	for (unsigned int y = 0; y < height; y++) {
+		const unsigned short *src = (const unsigned short *)half_source + (bInvert ? height-1-y : y)*pitch;
+		float *dst = (float *)float_dest + y*pitch;
+		for (unsigned long x = 0; x < pitch; x++)
+			dst[x] = HalfToFloat(src[x]);
+	}
+
+} // end half2float
+
+
+// rgba bytes to rgba half floats
+void spoutCopy::rgba2half(void *rgba_source, void *half_dest, unsigned int width, unsigned int height, bool bInvert)
+{
+	// There are only 256 values to convert
+	static unsigned short table[256];
+	static bool bTable = false;
+	if(!bTable) {
+		for (int i = 0; i < 256; i++)
+			table[i] = FloatToHalf((float)i/255.0f);
+		bTable = true;
+	}
+
+	unsigned long pitch = width*4;
+
+	for (unsigned int y = 0; y < height; y++) {
+		const unsigned char *src = (const unsigned char *)rgba_source + (bInvert ? height-1-y : y)*pitch;
+		unsigned short *dst = (unsigned short *)half_dest + y*pitch;
+		for (unsigned long x = 0; x < pitch; x++)
+			dst[x] = table[src[x]];
+	}
+
+} // end rgba2half
+
+
+// rgba half floats to rgba bytes, clamped to 0-1
+void spoutCopy::half2rgba(void *half_source, void *rgba_dest, unsigned int width, unsigned int height, bool bInvert)
+{
+	unsigned long pitch = width*4;
+
+	for (unsigned int y = 0; y < height; y++) {
+		const unsigned short *src = (const unsigned short *)half_source + (bInvert ? height-1-y : y)*pitch;
+		unsigned char *dst = (unsigned char *)rgba_dest + y*pitch;
+		for (unsigned long x = 0; x < pitch; x++)
+			dst[x] = (unsigned char)(Clamp(HalfToFloat(src[x]))*255.0f + 0.5f);
+	}
+
+} // end half2rgba
+
+
+// rgba bytes to packed 10 bit, the low bits repeat the high ones so that 255 is 1023
+void spoutCopy::rgba2rgb10a2(void *rgba_source, void *rgb10a2_dest, unsigned int width, unsigned int height, bool bInvert)
+{
+	for (unsigned int y = 0; y < height; y++) {
+		const unsigned char *rgba = (const unsigned char *)rgba_source + (bInvert ? height-1-y : y)*width*4;
+		unsigned int *dst = (unsigned int *)rgb10a2_dest + y*width;
+		for (unsigned int x = 0; x < width; x++) {
+			unsigned int r = ((unsigned int)rgba[0] << 2) | (rgba[0] >> 6);
+			unsigned int g = ((unsigned int)rgba[1] << 2) | (rgba[1] >> 6);
+			unsigned int b = ((unsigned int)rgba[2] << 2) | (rgba[2] >> 6);
+			unsigned int a = ((unsigned int)rgba[3]*3 + 127)/255;
+			dst[x] = r | (g << 10) | (b << 20) | (a << 30);
+			rgba += 4;
+		}
+	}
+
+} // end rgba2rgb10a2
+
+
+void spoutCopy::rgb10a2rgba(void *rgb10a2_source, void *rgba_dest, unsigned int width, unsigned int height, bool bInvert)
+{
+	for (unsigned int y = 0; y < height; y++) {
+		const unsigned int *src = (const unsigned int *)rgb10a2_source + (bInvert ? height-1-y : y)*width;
+		unsigned char *rgba = (unsigned char *)rgba_dest + y*width*4;
+		for (unsigned int x = 0; x < width; x++) {
+			unsigned int pixel = src[x];
+			rgba[0] = (unsigned char)((pixel & 0x3FF) >> 2);
+			rgba[1] = (unsigned char)(((pixel >> 10) & 0x3FF) >> 2);
+			rgba[2] = (unsigned char)(((pixel >> 20) & 0x3FF) >> 2);
+			rgba[3] = (unsigned char)((pixel >> 30)*85);
+			rgba += 4;
+		}
+	}
+
+} // end rgb10a2rgba
+
+
+// rgba half floats to packed 10 bit, clamped to 0-1
+void spoutCopy::half2rgb10a2(void *half_source, void *rgb10a2_dest, unsigned int width, unsigned int height, bool bInvert)
+{
+	for (unsigned int y = 0; y < height; y++) {
+		const unsigned short *half = (const unsigned short *)half_source + (bInvert ? height-1-y : y)*width*4;
+		unsigned int *dst = (unsigned int *)rgb10a2_dest + y*width;
+		for (unsigned int x = 0; x < width; x++) {
+			unsigned int r = (unsigned int)(Clamp(HalfToFloat(half[0]))*1023.0f + 0.5f);
+			unsigned int g = (unsigned int)(Clamp(HalfToFloat(half[1]))*1023.0f + 0.5f);
+			unsigned int b = (unsigned int)(Clamp(HalfToFloat(half[2]))*1023.0f + 0.5f);
+			unsigned int a = (unsigned int)(Clamp(HalfToFloat(half[3]))*3.0f + 0.5f);
+			dst[x] = r | (g << 10) | (b << 20) | (a << 30);
+			half += 4;
+		}
+	}
+
+} // end half2rgb10a2
+
+
+void spoutCopy::rgb10a2half(void *rgb10a2_source, void *half_dest, unsigned int width, unsigned int height, bool bInvert)
+{
+	for (unsigned int y = 0; y < height; y++) {
+		const unsigned int *src = (const unsigned int *)rgb10a2_source + (bInvert ? height-1-y : y)*width;
+		unsigned short *half = (unsigned short *)half_dest + y*width*4;
+		for (unsigned int x = 0; x < width; x++) {
+			unsigned int pixel = src[x];
+			half[0] = FloatToHalf((float)(pixel & 0x3FF)/1023.0f);
+			half[1] = FloatToHalf((float)((pixel >> 10) & 0x3FF)/1023.0f);
+			half[2] = FloatToHalf((float)((pixel >> 20) & 0x3FF)/1023.0f);
+			half[3] = FloatToHalf((float)(pixel >> 30)/3.0f);
+			half += 4;
+		}
+	}
+
+} // end rgb10a2half
+
+
+float spoutCopy::Clamp(float value)
+{
+	// NaN compares false and gives 0
+	return value > 0.0f ? (value < 1.0f ? value : 1.0f) : 0.0f;
+}
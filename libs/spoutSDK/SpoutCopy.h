@@ -79,9 +79,23 @@ class SPOUT_DLLEXP spoutCopy {
 		void bgra2rgb (void* bgra_source, void *rgb_dest,  unsigned int width, unsigned int height, bool bInvert = false);
 		void bgra2bgr (void* bgra_source, void *bgr_dest,  unsigned int width, unsigned int height, bool bInvert = false);
 
+		// Half float (RGBA16F) and packed 10 bit (RGB10A2) pixels, rgba order
+		static unsigned short FloatToHalf(float value);
+		static float HalfToFloat(unsigned short value);
+
+		void float2half  (void* float_source, void *half_dest, unsigned int width, unsigned int height, bool bInvert = false);
+		void half2float  (void* half_source, void *float_dest, unsigned int width, unsigned int height, bool bInvert = false);
+		void rgba2half   (void* rgba_source, void *half_dest, unsigned int width, unsigned int height, bool bInvert = false);
+		void half2rgba   (void* half_source, void *rgba_dest, unsigned int width, unsigned int height, bool bInvert = false);
+		void rgba2rgb10a2(void* rgba_source, void *rgb10a2_dest, unsigned int width, unsigned int height, bool bInvert = false);
+		void rgb10a2rgba (void* rgb10a2_source, void *rgba_dest, unsigned int width, unsigned int height, bool bInvert = false);
+		void half2rgb10a2(void* half_source, void *rgb10a2_dest, unsigned int width, unsigned int height, bool bInvert = false);
+		void rgb10a2half (void* rgb10a2_source, void *half_dest, unsigned int width, unsigned int height, bool bInvert = false);
+
 	private :
 
 		void CheckSSE();
+		static float Clamp(float value);
 		bool m_bSSE2;
 		bool m_bSSE3;
 		bool m_bSSSE3;
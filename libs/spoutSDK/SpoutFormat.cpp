@@ -0,0 +1,183 @@
+/*
+
+	spoutFormat.cpp
+
+	Pixel formats of the shared texture and their negotiation.
+	See spoutFormat.h
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "SpoutFormat.h"
+
+// Values used here, to keep this independent of the DirectX and OpenGL headers
+#define FORMAT_DXGI_R32G32B32A32_FLOAT	2
+#define FORMAT_DXGI_R16G16B16A16_FLOAT	10
+#define FORMAT_DXGI_R16G16B16A16_UNORM	11
+#define FORMAT_DXGI_R10G10B10A2_UNORM	24
+#define FORMAT_DXGI_R8G8B8A8_UNORM		28
+#define FORMAT_DXGI_B8G8R8A8_UNORM		87
+
+#define FORMAT_GL_RGBA8					0x8058
+#define FORMAT_GL_RGB10_A2				0x8059
+#define FORMAT_GL_RGBA12				0x805A
+#define FORMAT_GL_RGBA16				0x805B
+#define FORMAT_GL_RGBA32F				0x8814
+#define FORMAT_GL_RGB32F				0x8815
+#define FORMAT_GL_RGBA16F				0x881A
+#define FORMAT_GL_RGB16F				0x881B
+#define FORMAT_GL_R11F_G11F_B10F		0x8C3A
+
+// From the cheapest to the most expensive
+static const DWORD g_FormatOrder[] = {
+	SPOUT_FORMAT_BGRA8,
+	SPOUT_FORMAT_RGBA8,
+	SPOUT_FORMAT_RGB10A2,
+	SPOUT_FORMAT_RGBA16F
+};
+static const int g_FormatCount = sizeof(g_FormatOrder)/sizeof(g_FormatOrder[0]);
+
+
+DWORD spoutFormat::GetSupportedFormats(int shareMode, bool bDX9)
+{
+	// The texture share copies on the GPU, which converts between any formats.
+	// A DX9 shared texture is always BGRA.
+	if(shareMode == 0)
+		return bDX9 ? SPOUT_FORMAT_BGRA8 : (SPOUT_FORMAT_BGRA8 | SPOUT_FORMAT_RGBA8 | SPOUT_FORMAT_RGB10A2 | SPOUT_FORMAT_RGBA16F);
+
+	// Memoryshare keeps 4 bytes per pixel for older receivers,
+	// either rgba bytes or packed 10 bit values
+	if(shareMode == 2)
+		return SPOUT_FORMAT_BGRA8 | SPOUT_FORMAT_RGB10A2;
+
+	// The CPU staging textures are created BGRA
+	return SPOUT_FORMAT_BGRA8;
+}
+
+
+DWORD spoutFormat::Negotiate(DWORD localFormats, DWORD remoteFormats, DWORD contentFormat)
+{
+	DWORD common = remoteFormats ? (localFormats & remoteFormats) : localFormats;
+	unsigned int bits = GetBitsPerChannel(contentFormat);
+	DWORD best = 0;
+
+	for(int i = 0; i < g_FormatCount; i++) {
+		if(!(common & g_FormatOrder[i]))
+			continue;
+		if(GetBitsPerChannel(g_FormatOrder[i]) >= bits)
+			return g_FormatOrder[i];
+		// The most precise so far in case none is enough
+		if(!best || GetBitsPerChannel(g_FormatOrder[i]) > GetBitsPerChannel(best))
+			best = g_FormatOrder[i];
+	}
+
+	// Every Spout receiver can take BGRA
+	return best ? best : SPOUT_FORMAT_BGRA8;
+}
+
+
+DWORD spoutFormat::GetDXGIFormat(DWORD format)
+{
+	switch(format) {
+		case SPOUT_FORMAT_RGBA8   : return FORMAT_DXGI_R8G8B8A8_UNORM;
+		case SPOUT_FORMAT_RGB10A2 : return FORMAT_DXGI_R10G10B10A2_UNORM;
+		case SPOUT_FORMAT_RGBA16F : return FORMAT_DXGI_R16G16B16A16_FLOAT;
+		default                   : return FORMAT_DXGI_B8G8R8A8_UNORM;
+	}
+}
+
+
+DWORD spoutFormat::FromDXGIFormat(DWORD dxgiFormat)
+{
+	// 0 and 21, 22 are DX9 senders, 87 to 93 the BGRA family
+	if(dxgiFormat >= 27 && dxgiFormat <= 32)
+		return SPOUT_FORMAT_RGBA8;
+	if(dxgiFormat >= 23 && dxgiFormat <= 25)
+		return SPOUT_FORMAT_RGB10A2;
+	if(dxgiFormat == FORMAT_DXGI_R16G16B16A16_FLOAT
+	|| dxgiFormat == FORMAT_DXGI_R16G16B16A16_UNORM
+	|| dxgiFormat == FORMAT_DXGI_R32G32B32A32_FLOAT)
+		return SPOUT_FORMAT_RGBA16F;
+	return SPOUT_FORMAT_BGRA8;
+}
+
+
+unsigned int spoutFormat::GetGLInternalFormat(DWORD format)
+{
+	switch(format) {
+		case SPOUT_FORMAT_RGB10A2 : return FORMAT_GL_RGB10_A2;
+		case SPOUT_FORMAT_RGBA16F : return FORMAT_GL_RGBA16F;
+		default                   : return FORMAT_GL_RGBA8; // OpenGL has no BGRA storage
+	}
+}
+
+
+DWORD spoutFormat::FromGLInternalFormat(unsigned int internalFormat)
+{
+	switch(internalFormat) {
+		case FORMAT_GL_RGB10_A2 :
+		case FORMAT_GL_RGBA12 :
+			return SPOUT_FORMAT_RGB10A2;
+		case FORMAT_GL_RGBA16 :
+		case FORMAT_GL_RGBA16F :
+		case FORMAT_GL_RGB16F :
+		case FORMAT_GL_RGBA32F :
+		case FORMAT_GL_RGB32F :
+		case FORMAT_GL_R11F_G11F_B10F :
+			return SPOUT_FORMAT_RGBA16F;
+		default : // 8 bits, which BGRA carries the cheapest
+			return SPOUT_FORMAT_BGRA8;
+	}
+}
+
+
+unsigned int spoutFormat::GetBitsPerChannel(DWORD format)
+{
+	switch(format) {
+		case SPOUT_FORMAT_RGB10A2 : return 10;
+		case SPOUT_FORMAT_RGBA16F : return 16;
+		default                   : return 8;
+	}
+}
+
+
+unsigned int spoutFormat::GetBytesPerPixel(DWORD format)
+{
+	return format == SPOUT_FORMAT_RGBA16F ? 8 : 4;
+}
+
+
+const char* spoutFormat::GetName(DWORD format)
+{
+	switch(format) {
+		case SPOUT_FORMAT_BGRA8   : return "BGRA8";
+		case SPOUT_FORMAT_RGBA8   : return "RGBA8";
+		case SPOUT_FORMAT_RGB10A2 : return "RGB10A2";
+		case SPOUT_FORMAT_RGBA16F : return "RGBA16F";
+		default                   : return "unknown";
+	}
+}
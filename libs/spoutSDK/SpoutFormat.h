@@ -0,0 +1,90 @@
+/*
+
+	spoutFormat.h
+
+	Pixel formats of the shared texture, and their negotiation between a
+	sender and the receiver at the other end of a bridge.
+
+	A format is one bit of a mask. A sender publishes the mask of the
+	formats it can receive and send in the usage field of its sender
+	information, which older senders leave unset, while the format field
+	keeps the DXGI format of the shared texture for any Spout receiver.
+
+	Negotiate() picks the cheapest format both ends support that keeps the
+	precision of the content: BGRA8 is the native layout of the shared
+	texture on most drivers and needs no swizzle, RGBA8 comes next, RGB10A2
+	keeps 10 bits in the same 4 bytes and RGBA16F is the only one for HDR
+	content, at twice the size.
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#pragma once
+
+#ifndef __spoutFormat__
+#define __spoutFormat__
+
+#include "SpoutCommon.h"
+#include <windows.h>
+
+#define SPOUT_FORMAT_BGRA8		0x01
+#define SPOUT_FORMAT_RGBA8		0x02
+#define SPOUT_FORMAT_RGB10A2	0x04
+#define SPOUT_FORMAT_RGBA16F	0x08
+
+// What a sender without a published mask is assumed to handle
+#define SPOUT_FORMAT_LEGACY		(SPOUT_FORMAT_BGRA8 | SPOUT_FORMAT_RGBA8)
+
+// Marks a published mask in the high word of the usage field
+#define SPOUT_FORMAT_TAG		0x53460000
+#define SPOUT_FORMAT_TAG_MASK	0xFFFF0000
+
+class SPOUT_DLLEXP spoutFormat {
+
+	public:
+
+		// Formats a share mode can carry (0 texture, 1 cpu, 2 memory)
+		static DWORD GetSupportedFormats(int shareMode, bool bDX9 = false);
+
+		// Cheapest format of both masks with at least the bits per channel
+		// of the content format. A remote mask of 0 means the other end is
+		// not there yet and only the local mask is used.
+		static DWORD Negotiate(DWORD localFormats, DWORD remoteFormats, DWORD contentFormat);
+
+		// Conversions, unknown values are taken as 8 bit BGRA
+		static DWORD GetDXGIFormat(DWORD format);
+		static DWORD FromDXGIFormat(DWORD dxgiFormat);
+		static unsigned int GetGLInternalFormat(DWORD format);
+		static DWORD FromGLInternalFormat(unsigned int internalFormat);
+
+		static unsigned int GetBitsPerChannel(DWORD format);
+		static unsigned int GetBytesPerPixel(DWORD format);
+		static const char* GetName(DWORD format);
+
+};
+
+#endif
@@ -191,10 +191,27 @@
 					- CleanupDX9 change to prevent crash with Milkdrop
 					- add pQuery->Release() to FlushWait
 		04.02.17	- corrected test for fbo blit extension
+		19.10.26	- use the DirectX 11 device and GL/DX interop device of the
+					  spoutSharedContext when one is alive
+					- CreateInterop keeps the existing fbo and closes the previous
+					  access mutex handle, so UpdateSender only re-creates the textures
+					- texture transfers and interop locks recorded as trace events
+		19.10.26	- framebuffer, texture and pixel buffer binds go through
+					  spoutGLState, so that a frame scope skips redundant binds
+					  and restores the host fbo once
+		19.10.26	- memoryshare in packed 10 bit for an RGB10A2 sender (SetMemoryFormat)
+					- pixel type argument for LoadTexturePixels and UnloadTexturePixels
+					- the local texture is created again when its format changes
+		19.10.26	- ForceMemoryShare : memoryshare for one object without
+					  writing the machine wide registry setting
 
 */
 
 #include "spoutGLDXinterop.h"
+#include "SpoutSharedContext.h"
+#include "SpoutFormat.h"
+#include "SpoutTrace.h"
+#include "SpoutGLState.h"
 
 spoutGLDXinterop::spoutGLDXinterop() {
 
@@ -203,12 +220,15 @@ spoutGLDXinterop::spoutGLDXinterop() {
 	m_hSharedMemory  = NULL;
 	m_hInteropDevice = NULL;
 	m_hAccessMutex   = NULL;
+	m_bSharedInteropDevice = false;
 
 	m_glTexture = 0;
 	m_fbo       = 0;
 	m_TexID     = 0;
 	m_TexWidth  = 0;
 	m_TexHeight = 0;
+	m_TexFormat = 0;
+	m_MemoryFormat = 0;
 
 	m_TextureInfo.width       = 0;
 	m_TextureInfo.height      = 0;
@@ -226,6 +246,7 @@ spoutGLDXinterop::spoutGLDXinterop() {
 	m_bUseDX9    = false; // Use DX11 (default false) or DX9 (true)
 	m_bUseCPU    = false; // CPU texture processing
 	m_bUseMemory = false; // Memoryshare
+	m_bForceMemory = false;
 	m_pD3D       = NULL;
 	m_pDevice    = NULL;
 	m_dxTexture  = NULL;
@@ -455,6 +476,11 @@ bool spoutGLDXinterop::OpenDirectX11()
 	// Quit if already initialized
 	if(g_pd3dDevice != NULL) return true;
 
+	// Use the process wide device if there is a shared context
+	// The context adds a reference that is released by CleanupDX11
+	spoutSharedContext* pContext = spoutSharedContext::Get();
+	if(pContext) g_pd3dDevice = pContext->GetDX11device(spoutdx);
+
 	// Create a DirectX 11 device
 	if(!g_pd3dDevice) g_pd3dDevice = spoutdx.CreateDX11device();
 	if(g_pd3dDevice == NULL) {
@@ -472,8 +498,13 @@ bool spoutGLDXinterop::DX11available()
 	if(g_pd3dDevice != NULL) return true;
 
 	// Try to create a DirectX 11 device
+	// With a shared context the test device is kept for later use
 	ID3D11Device* pd3dDevice;
-	pd3dDevice = spoutdx.CreateDX11device();
+	spoutSharedContext* pContext = spoutSharedContext::Get();
+	if(pContext)
+		pd3dDevice = pContext->GetDX11device(spoutdx);
+	else
+		pd3dDevice = spoutdx.CreateDX11device();
 	if(pd3dDevice == NULL)
 		return false;
 
@@ -735,12 +766,17 @@ bool spoutGLDXinterop::CreateInterop(HWND hWnd, const char* sendername, unsigned
 	}
 
 	// Create an fbo for copying textures
+	// An existing one is kept, e.g. for a sender update. Attachments are
+	// made on every use, so only make sure the old texture is released.
 	if(m_fbo) {
-		// Delete the fbo before the texture so that any texture attachment is released
-		glDeleteFramebuffersEXT(1, &m_fbo);
-		m_fbo = 0;
+		spoutGLState::BindFramebuffer(m_fbo);
+		glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, 0, 0);
+		glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT1_EXT, GL_TEXTURE_2D, 0, 0);
+		spoutGLState::RestoreFramebuffer(0);
+	}
+	else {
+		glGenFramebuffersEXT(1, &m_fbo); 
 	}
-	glGenFramebuffersEXT(1, &m_fbo); 
 
 	// Create a local opengl texture that will be linked to a shared DirectX texture
 	// This is never initialized using OpenGL, but has size and can be accessed when
@@ -748,6 +784,7 @@ bool spoutGLDXinterop::CreateInterop(HWND hWnd, const char* sendername, unsigned
 	if(m_glTexture) {
 		glDeleteTextures(1, &m_glTexture);
 		m_glTexture = 0;
+		spoutGLState::Invalidate(); // it may have been bound
 	}
 	glGenTextures(1, &m_glTexture);
 
@@ -812,6 +849,8 @@ bool spoutGLDXinterop::CreateInterop(HWND hWnd, const char* sendername, unsigned
 	}
 
 	// Initialize general texture transfer sync mutex - either sender or receiver can do this
+	// Close the handle of a previous call first or it leaks on every sender update
+	if(m_hAccessMutex) spoutdx.CloseAccessMutex(m_hAccessMutex);
 	spoutdx.CreateAccessMutex(sendername, m_hAccessMutex);
 
 	//
@@ -1018,8 +1057,13 @@ HANDLE spoutGLDXinterop::LinkGLDXtextures (	void* pDXdevice,
 	// Prepare the DirectX device for interoperability with OpenGL
 	// The return value is a handle to a GL/DirectX interop device.
 	if(!m_hInteropDevice) {
+		// One interop device per OpenGL context if there is a shared context
+		spoutSharedContext* pContext = spoutSharedContext::Get();
+		if(pContext) m_hInteropDevice = pContext->GetInteropDevice((ID3D11Device*)pDXdevice);
+		m_bSharedInteropDevice = (m_hInteropDevice != NULL);
+
 		// printf("    LinkGLDXtextures creating interop device from %x\n", pDXdevice);
-		m_hInteropDevice = wglDXOpenDeviceNV(pDXdevice);
+		if(!m_hInteropDevice) m_hInteropDevice = wglDXOpenDeviceNV(pDXdevice);
 	}
 
 	if (m_hInteropDevice == NULL) {
@@ -1133,16 +1177,21 @@ void spoutGLDXinterop::CleanupInterop(bool bExit)
 	// Some of these things need an opengl context so check
 	if (ctx != NULL) {
 		// Problem here on exit, but not on change of resolution while the program is running !?
-		if (!bExit) {
+		// A shared interop device stays open for the other objects, so the
+		// object has to be unregistered from it in any case.
+		if (!bExit || m_bSharedInteropDevice) {
 			if (m_hInteropDevice != NULL && m_hInteropObject != NULL) {
 				wglDXUnregisterObjectNV(m_hInteropDevice, m_hInteropObject);
 				m_hInteropObject = NULL;
 			}
 		}
 
+		// A shared interop device is closed by the shared context
 		if (m_hInteropDevice != NULL) {
-			wglDXCloseDeviceNV(m_hInteropDevice);
+			if (!m_bSharedInteropDevice)
+				wglDXCloseDeviceNV(m_hInteropDevice);
 			m_hInteropDevice = NULL;
+			m_bSharedInteropDevice = false;
 		}
 
 		if (m_fbo > 0) {
@@ -1168,8 +1217,12 @@ void spoutGLDXinterop::CleanupInterop(bool bExit)
 			m_TexID = 0;
 			m_TexWidth = 0;
 			m_TexHeight = 0;
+			m_TexFormat = 0;
 		}
 
+		// Deleted objects are unbound
+		spoutGLState::Invalidate();
+
 	} // endif there is an opengl context
 
 	CleanupDirectX(bExit);
@@ -1415,6 +1468,8 @@ bool spoutGLDXinterop::WriteTexture (GLuint TextureID, GLuint TextureTarget,
 									 unsigned int width, unsigned int height,
 									 bool bInvert, GLuint HostFBO)
 {
+	SPOUT_TRACE("WriteTexture");
+
 	if(m_bUseMemory) { // Memoryshare
 		return(WriteMemory(TextureID, TextureTarget, width, height, bInvert, HostFBO));
 	}
@@ -1438,6 +1493,8 @@ bool spoutGLDXinterop::ReadTexture (GLuint TextureID, GLuint TextureTarget,
 									unsigned int width, unsigned int height,
 									bool bInvert, GLuint HostFBO)
 {
+	SPOUT_TRACE("ReadTexture");
+
 	if(m_bUseMemory) { // Memoryshare
 		return(ReadMemory(TextureID, TextureTarget, width, height, bInvert, HostFBO));
 	}
@@ -1460,6 +1517,8 @@ bool spoutGLDXinterop::WriteTexturePixels (const unsigned char *pixels,
 										   unsigned int width, unsigned int height, 
 										   GLenum glFormat, bool bInvert, GLuint HostFBO)
 {
+	SPOUT_TRACE("WriteTexturePixels");
+
 	if(m_bUseMemory) { // Memoryshare
 		return(WriteMemoryPixels(pixels, width, height, glFormat, bInvert));
 	}
@@ -1483,6 +1542,8 @@ bool spoutGLDXinterop::ReadTexturePixels (unsigned char *pixels,
 										  unsigned int width, unsigned int height, 
 										  GLenum glFormat, bool bInvert, GLuint HostFBO)
 {
+	SPOUT_TRACE("ReadTexturePixels");
+
 	if(m_bUseMemory) { // Memoryshare
 		return(ReadMemoryPixels(pixels, width, height, glFormat, bInvert));
 	}
@@ -1502,6 +1563,9 @@ bool spoutGLDXinterop::ReadTexturePixels (unsigned char *pixels,
 
 bool spoutGLDXinterop::DrawSharedTexture(float max_x, float max_y, float aspect, bool bInvert, GLuint HostFBO)
 {
+	// Draws into the host fbo
+	spoutGLState::Restore();
+
 	if(m_bUseMemory) { // Memoryshare
 		return(DrawSharedMemory(max_x, max_y, aspect, bInvert));
 	}
@@ -1527,6 +1591,8 @@ bool spoutGLDXinterop::DrawToSharedTexture(GLuint TextureID, GLuint TextureTarge
 									   float max_x, float max_y, float aspect,
 									   bool bInvert, GLuint HostFBO)
 {
+	SPOUT_TRACE("DrawToSharedTexture");
+
 	if(m_bUseMemory) { // Memoryshare
 		return(DrawToSharedMemory(TextureID, TextureTarget, width, height, max_x, max_y, aspect, bInvert));
 	}
@@ -1562,8 +1628,10 @@ bool spoutGLDXinterop::BindSharedTexture()
 	if(spoutdx.CheckAccess(m_hAccessMutex)) {
 		// lock dx object
 		if(LockInteropObject(m_hInteropDevice, &m_hInteropObject) == S_OK) {
+			// The caller draws into the host fbo
+			spoutGLState::Restore();
 			// Bind our shared OpenGL texture
-			glBindTexture(GL_TEXTURE_2D, m_glTexture);
+			spoutGLState::BindTexture(GL_TEXTURE_2D, m_glTexture);
 			bRet = true;
 		}
 		else {
@@ -1594,7 +1662,7 @@ bool spoutGLDXinterop::UnBindSharedTexture()
 		return false;
 	
 	// Unbind our shared OpenGL texture
-	glBindTexture(GL_TEXTURE_2D,0);
+	spoutGLState::UnbindTexture(GL_TEXTURE_2D);
 	// unlock dx object
 	UnlockInteropObject(m_hInteropDevice, &m_hInteropObject);
 	// Allow access to the texture
@@ -1630,7 +1698,7 @@ bool spoutGLDXinterop::WriteGLDXtexture(GLuint TextureID, GLuint TextureTarget,
 			// which should have been already created
 
 			// bind the FBO (for both, READ_FRAMEBUFFER_EXT and DRAW_FRAMEBUFFER_EXT)
-			glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_fbo);
+			spoutGLState::BindFramebuffer(m_fbo);
 
 			// Attach the Input texture to the color buffer in our frame buffer - note texturetarget 
 			glFramebufferTexture2DEXT(READ_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, TextureTarget, TextureID, 0);
@@ -1666,9 +1734,9 @@ bool spoutGLDXinterop::WriteGLDXtexture(GLuint TextureID, GLuint TextureTarget,
 				else {
 					// No fbo blit extension
 					// Copy from the fbo (input texture attached) to the shared texture
-					glBindTexture(GL_TEXTURE_2D, m_glTexture);
+					spoutGLState::BindTexture(GL_TEXTURE_2D, m_glTexture);
 					glCopyTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 0, 0, width, height);
-					glBindTexture(GL_TEXTURE_2D, 0);
+					spoutGLState::UnbindTexture(GL_TEXTURE_2D);
 				}
 			}
 			else {
@@ -1676,7 +1744,7 @@ bool spoutGLDXinterop::WriteGLDXtexture(GLuint TextureID, GLuint TextureTarget,
 			}
 
 			// restore the previous fbo - default is 0
-			glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+			spoutGLState::RestoreFramebuffer(HostFBO);
 
 			// unlock dx object
 			UnlockInteropObject(m_hInteropDevice, &m_hInteropObject);
@@ -1710,7 +1778,7 @@ bool spoutGLDXinterop::ReadGLDXtexture(GLuint TextureID, GLuint TextureTarget, u
 		if(LockInteropObject(m_hInteropDevice, &m_hInteropObject) == S_OK) {
 
 			// bind the FBO (for both, READ_FRAMEBUFFER_EXT and DRAW_FRAMEBUFFER_EXT)
-			glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_fbo);
+			spoutGLState::BindFramebuffer(m_fbo);
 
 			// Attach the Input texture (the shared texture) to the color buffer in our frame buffer - note texturetarget 
 			glFramebufferTexture2DEXT(READ_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, m_glTexture, 0);
@@ -1744,9 +1812,9 @@ bool spoutGLDXinterop::ReadGLDXtexture(GLuint TextureID, GLuint TextureTarget, u
 				else { 
 					// No fbo blit extension available
 					// Copy from the fbo (shared texture attached) to the dest texture
-					glBindTexture(TextureTarget, TextureID);
+					spoutGLState::BindTexture(TextureTarget, TextureID);
 					glCopyTexSubImage2D(TextureTarget, 0, 0, 0, 0, 0, width, height);
-					glBindTexture(TextureTarget, 0);
+					spoutGLState::UnbindTexture(TextureTarget);
 				}
 			}
 			else {
@@ -1756,7 +1824,7 @@ bool spoutGLDXinterop::ReadGLDXtexture(GLuint TextureID, GLuint TextureTarget, u
 			glDrawBuffer(GL_COLOR_ATTACHMENT0_EXT); // 04.01.16
 
 			// restore the previous fbo - default is 0
-			glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+			spoutGLState::RestoreFramebuffer(HostFBO);
 
 			// unlock dx object
 			UnlockInteropObject(m_hInteropDevice, &m_hInteropObject);
@@ -1789,7 +1857,7 @@ bool spoutGLDXinterop::WriteGLDXpixels(const unsigned char *pixels,
 	// Use a GL texture so that WriteTexture can be used
 	
 	// Create or resize a local OpenGL texture
-	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight);
+	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight, m_TexFormat);
 
 	// Transfer the pixels to the local texture
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
@@ -1797,9 +1865,9 @@ bool spoutGLDXinterop::WriteGLDXpixels(const unsigned char *pixels,
 		LoadTexturePixels(m_TexID, GL_TEXTURE_2D, width, height, (const unsigned char *)pixels, glFormat);
 	}
 	else {
-		glBindTexture(GL_TEXTURE_2D, m_TexID);
+		spoutGLState::BindTexture(GL_TEXTURE_2D, m_TexID);
 		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, glformat, GL_UNSIGNED_BYTE, (GLvoid *)pixels);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		spoutGLState::UnbindTexture(GL_TEXTURE_2D);
 	}
 	glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
 
@@ -1837,7 +1905,7 @@ bool spoutGLDXinterop::ReadGLDXpixels(unsigned char *pixels,
 			glPixelStorei(GL_PACK_ALIGNMENT, 1);
 
 			// Create or resize a local OpenGL texture
-			CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight);
+			CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight, m_TexFormat);
 
 			// Copy the shared texture to the local texture, inverting if necessary
 			CopyTexture(m_glTexture, GL_TEXTURE_2D, m_TexID, GL_TEXTURE_2D, width, height, bInvert, HostFBO);
@@ -1851,7 +1919,7 @@ bool spoutGLDXinterop::ReadGLDXpixels(unsigned char *pixels,
 				// fbo attachment method - current fbo has to be passed in
 				//
 				// Bind our local fbo
-				glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_fbo); 
+				spoutGLState::BindFramebuffer(m_fbo); 
 				// Attach the local rgba texture to the color buffer in our frame buffer
 				glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, m_TexID, 0);
 				status = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT);
@@ -1863,7 +1931,7 @@ bool spoutGLDXinterop::ReadGLDXpixels(unsigned char *pixels,
 					PrintFBOstatus(status);
 				}
 				// restore the previous fbo - default is 0
-				glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+				spoutGLState::RestoreFramebuffer(HostFBO);
 			}
 	
 			glPixelStorei(GL_PACK_ALIGNMENT, 4);
@@ -1905,7 +1973,7 @@ bool spoutGLDXinterop::DrawToGLDXtexture(GLuint TextureID, GLuint TextureTarget,
 			// Draw the input texture into the shared texture via an fbo
 
 			// Bind our fbo and attach the shared texture to it
-			glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_fbo);
+			spoutGLState::BindFramebuffer(m_fbo);
 			glFramebufferTexture2DEXT(GL_READ_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, m_glTexture, 0);
 			
 			status = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT);
@@ -1913,7 +1981,7 @@ bool spoutGLDXinterop::DrawToGLDXtexture(GLuint TextureID, GLuint TextureTarget,
 
 				glColor4f(1.f, 1.f, 1.f, 1.f);
 				glEnable(TextureTarget);
-				glBindTexture(TextureTarget, TextureID);
+				spoutGLState::BindTexture(TextureTarget, TextureID);
 
 				GLfloat tc[4][2] = {0};
 
@@ -1945,19 +2013,19 @@ bool spoutGLDXinterop::DrawToGLDXtexture(GLuint TextureID, GLuint TextureTarget,
 				glDisableClientState(GL_VERTEX_ARRAY);
 				glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 
-				glBindTexture(TextureTarget, 0);
+				spoutGLState::UnbindTexture(TextureTarget);
 				glDisable(TextureTarget);
 
 			}
 			else {
 				PrintFBOstatus(status);
-				glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+				spoutGLState::RestoreFramebuffer(HostFBO);
 				UnlockInteropObject(m_hInteropDevice, &m_hInteropObject);
 				spoutdx.AllowAccess(m_hAccessMutex); // Allow access to the texture
 				return false;
 			}
 			// restore the previous fbo - default is 0
-			glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+			spoutGLState::RestoreFramebuffer(HostFBO);
 			UnlockInteropObject(m_hInteropDevice, &m_hInteropObject);
 		}
 	}
@@ -1983,7 +2051,7 @@ bool spoutGLDXinterop::DrawGLDXtexture(float max_x, float max_y, float aspect, b
 
 			SaveOpenGLstate(m_TextureInfo.width, m_TextureInfo.height);
 			glEnable(GL_TEXTURE_2D);
-			glBindTexture(GL_TEXTURE_2D, m_glTexture); // bind shared texture
+			spoutGLState::BindTexture(GL_TEXTURE_2D, m_glTexture); // bind shared texture
 			glColor4f(1.f, 1.f, 1.f, 1.f);
 			// Tried to convert to vertex array, but Processing crash
 			glBegin(GL_QUADS);
@@ -2000,7 +2068,7 @@ bool spoutGLDXinterop::DrawGLDXtexture(float max_x, float max_y, float aspect, b
 				glTexCoord2f(max_x, 0.0);	glVertex2f( aspect,-1.0); // lower right
 			}
 			glEnd();
-			glBindTexture(GL_TEXTURE_2D, 0);
+			spoutGLState::UnbindTexture(GL_TEXTURE_2D);
 			glDisable(GL_TEXTURE_2D);
 			RestoreOpenGLstate();
 
@@ -2141,7 +2209,8 @@ void spoutGLDXinterop::FlushWait()
 bool spoutGLDXinterop::LoadTexturePixels(GLuint TextureID, GLuint TextureTarget, 
 										 unsigned int width, unsigned int height, 
 										 const unsigned char *data, 
-										 GLenum glFormat, bool bInvert)
+										 GLenum glFormat, bool bInvert,
+										 GLenum glType)
 {
 	void *pboMemory = NULL;
 	int channels = 4; // RGBA or RGB
@@ -2163,14 +2232,15 @@ bool spoutGLDXinterop::LoadTexturePixels(GLuint TextureID, GLuint TextureTarget,
 	NextPboIndex = (PboIndex + 1) % 2;
 
 	// Bind the texture and PBO
-	glBindTexture(TextureTarget, TextureID);
-	glBindBufferEXT(GL_PIXEL_UNPACK_BUFFER, m_pbo[PboIndex]);
+	spoutGLState::BindTexture(TextureTarget, TextureID);
+	spoutGLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo[PboIndex]);
 
 	// Copy pixels from PBO to the texture - use offset instead of pointer.
-	glTexSubImage2D(TextureTarget, 0, 0, 0, width, height, glFormat, GL_UNSIGNED_BYTE, 0);
+	// A packed type such as GL_UNSIGNED_INT_2_10_10_10_REV has 4 bytes per pixel as well.
+	glTexSubImage2D(TextureTarget, 0, 0, 0, width, height, glFormat, glType, 0);
 
 	// Bind PBO to update the texture
-	glBindBufferEXT(GL_PIXEL_UNPACK_BUFFER, m_pbo[NextPboIndex]);
+	spoutGLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, m_pbo[NextPboIndex]);
 
 	// Call glBufferData() with a NULL pointer to clear the PBO data and avoid a stall.
 	glBufferDataEXT(GL_PIXEL_UNPACK_BUFFER, width*height*channels, 0, GL_STREAM_DRAW);
@@ -2184,12 +2254,12 @@ bool spoutGLDXinterop::LoadTexturePixels(GLuint TextureID, GLuint TextureTarget,
 		glUnmapBufferEXT(GL_PIXEL_UNPACK_BUFFER); // release the mapped buffer
 	}
 	else {
-		glBindBufferEXT(GL_PIXEL_UNPACK_BUFFER, 0);
+		spoutGLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 		return false;
 	}
 
 	// Release PBOs
-	glBindBufferEXT(GL_PIXEL_UNPACK_BUFFER, 0);
+	spoutGLState::BindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
 	return true;
 
@@ -2203,7 +2273,8 @@ bool spoutGLDXinterop::LoadTexturePixels(GLuint TextureID, GLuint TextureTarget,
 bool spoutGLDXinterop::UnloadTexturePixels(GLuint TextureID, GLuint TextureTarget, 
 										   unsigned int width, unsigned int height, 
 										   unsigned char *data, GLenum glFormat, 
-										   bool bInvert, GLuint HostFBO)
+										   bool bInvert, GLuint HostFBO,
+										   GLenum glType)
 {
 	void *pboMemory = NULL;
 	int channels = 4; // RGBA or RGB
@@ -2227,23 +2298,23 @@ bool spoutGLDXinterop::UnloadTexturePixels(GLuint TextureID, GLuint TextureTarge
 	NextPboIndex = (PboIndex + 1) % 2;
 
 	// Attach the texture to an FBO
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_fbo);
+	spoutGLState::BindFramebuffer(m_fbo);
 	glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, TextureTarget, TextureID, 0);
 
 	// Set the target framebuffer to read
 	glReadBuffer(GL_COLOR_ATTACHMENT0_EXT);
 
 	// Bind the PBO
-	glBindBufferEXT(GL_PIXEL_PACK_BUFFER, m_pbo[PboIndex]);
+	spoutGLState::BindBuffer(GL_PIXEL_PACK_BUFFER, m_pbo[PboIndex]);
 
 	// Null existing data to avoid a stall
 	glBufferDataEXT(GL_PIXEL_PACK_BUFFER, width*height*channels, 0, GL_STREAM_READ);
 
 	// Read pixels from framebuffer to PBO - glReadPixels() should return immediately.
-	glReadPixels(0, 0, width, height, glFormat, GL_UNSIGNED_BYTE, (GLvoid *)0);
+	glReadPixels(0, 0, width, height, glFormat, glType, (GLvoid *)0);
 
 	// Map the PBO to process its data by CPU
-	glBindBufferEXT(GL_PIXEL_PACK_BUFFER, m_pbo[NextPboIndex]);
+	spoutGLState::BindBuffer(GL_PIXEL_PACK_BUFFER, m_pbo[NextPboIndex]);
 
 	// TODO : For some reason, glMapBuffer returns NULL when called the first time
 	// when used with Processing. Not resolved - but it only happens once.
@@ -2255,16 +2326,16 @@ bool spoutGLDXinterop::UnloadTexturePixels(GLuint TextureID, GLuint TextureTarge
 	}
 	else {
 		GLerror(); // soak up the error for Processing
-		glBindBufferEXT(GL_PIXEL_PACK_BUFFER, 0);
-		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+		spoutGLState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		spoutGLState::RestoreFramebuffer(HostFBO);
 		return false;
 	}
 	
 	// Back to conventional pixel operation
-	glBindBufferEXT(GL_PIXEL_PACK_BUFFER, 0);
+	spoutGLState::BindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 	
 	// Restore the previous fbo binding
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+	spoutGLState::RestoreFramebuffer(HostFBO);
 
 
 	return true;
@@ -2346,11 +2417,11 @@ bool spoutGLDXinterop::WriteDX11texture (GLuint TextureID, GLuint TextureTarget,
 		else {
 			if(bInvert) {
 				// Create or resize a local OpenGL texture
-				CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight);
+				CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight, m_TexFormat);
 				// Copy the user texture to the local texture - necessary for inversion
 				CopyTexture(TextureID, TextureTarget, m_TexID, GL_TEXTURE_2D, width, height, bInvert, HostFBO);
 				// Bind our local fbo - current fbo has to be passed in
-				glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_fbo); 
+				spoutGLState::BindFramebuffer(m_fbo); 
 				// Attach the local rgba texture to the color buffer in our frame buffer
 				glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, m_TexID, 0);
 				GLenum status = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT);
@@ -2362,11 +2433,11 @@ bool spoutGLDXinterop::WriteDX11texture (GLuint TextureID, GLuint TextureTarget,
 					PrintFBOstatus(status);
 				}
 				// restore the previous fbo - default is 0
-				glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+				spoutGLState::RestoreFramebuffer(HostFBO);
 			}
 			else {
 				// No invert so use the user texture
-				glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_fbo); 
+				spoutGLState::BindFramebuffer(m_fbo); 
 				// Attach the user rgba texture to the color buffer in our frame buffer
 				glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, TextureTarget, TextureID, 0);
 				GLenum status = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT);
@@ -2378,7 +2449,7 @@ bool spoutGLDXinterop::WriteDX11texture (GLuint TextureID, GLuint TextureTarget,
 					PrintFBOstatus(status);
 				}
 				// restore the previous fbo - default is 0
-				glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+				spoutGLState::RestoreFramebuffer(HostFBO);
 			}
 		}
 		g_pImmediateContext->Unmap(g_pStagingTexture, 0);
@@ -2434,19 +2505,19 @@ bool spoutGLDXinterop::ReadDX11texture (GLuint TextureID,
 				else {
 					if(bInvert) {
 						// Create or resize a local OpenGL texture
-						CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight);
+						CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight, m_TexFormat);
 						// Copy the DX11 pixels to it
-						glBindTexture(GL_TEXTURE_2D, m_TexID);
+						spoutGLState::BindTexture(GL_TEXTURE_2D, m_TexID);
 						glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_BGRA_EXT, GL_UNSIGNED_BYTE, dataPointer);
-						glBindTexture(GL_TEXTURE_2D, 0);
+						spoutGLState::UnbindTexture(GL_TEXTURE_2D);
 						// Copy the local texture to the user texture and invert as necessary
 						CopyTexture(m_TexID, GL_TEXTURE_2D, TextureID, TextureTarget, width, height, bInvert, HostFBO);
 					}
 					else {
 						// Copy the DX11 pixels to the user texture
-						glBindTexture(TextureTarget, TextureID);
+						spoutGLState::BindTexture(TextureTarget, TextureID);
 						glTexSubImage2D(TextureTarget, 0, 0, 0, width, height, GL_BGRA_EXT, GL_UNSIGNED_BYTE, dataPointer);
-						glBindTexture(TextureTarget, 0);
+						spoutGLState::UnbindTexture(TextureTarget);
 					}
 				}
 			}
@@ -2600,7 +2671,7 @@ bool spoutGLDXinterop::DrawDX11texture(float max_x, float max_y, float aspect, b
 		return false;
 
 	// Create or resize a local OpenGL texture
-	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight);
+	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight, m_TexFormat);
 
 	// Read the shared texture data into the staging texture so it can be accessed
 	if(ReadTexture(&g_pStagingTexture)) {
@@ -2614,14 +2685,14 @@ bool spoutGLDXinterop::DrawDX11texture(float max_x, float max_y, float aspect, b
 			if(dataPointer) {
 
 				// Copy the DX11 pixels to it
-				glBindTexture(GL_TEXTURE_2D, m_TexID);
+				spoutGLState::BindTexture(GL_TEXTURE_2D, m_TexID);
 				glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_BGRA_EXT, GL_UNSIGNED_BYTE, dataPointer);
-				glBindTexture(GL_TEXTURE_2D, 0);
+				spoutGLState::UnbindTexture(GL_TEXTURE_2D);
 
 				// Draw the local texture and invert as necessary
 				SaveOpenGLstate(width, height);
 				glEnable(GL_TEXTURE_2D);
-				glBindTexture(GL_TEXTURE_2D, m_TexID); // bind texture
+				spoutGLState::BindTexture(GL_TEXTURE_2D, m_TexID); // bind texture
 				glColor4f(1.f, 1.f, 1.f, 1.f);
 				glBegin(GL_QUADS);
 				if(bInvert) {
@@ -2638,7 +2709,7 @@ bool spoutGLDXinterop::DrawDX11texture(float max_x, float max_y, float aspect, b
 					glTexCoord2f(max_x, max_y);	glVertex2f( aspect,-1.0); // lower right
 				}
 				glEnd();
-				glBindTexture(GL_TEXTURE_2D, 0); // unbind shared texture
+				spoutGLState::UnbindTexture(GL_TEXTURE_2D); // unbind shared texture
 				glDisable(GL_TEXTURE_2D);
 				RestoreOpenGLstate();
 			}
@@ -2670,13 +2741,13 @@ bool spoutGLDXinterop::DrawToDX11texture(GLuint TextureID, GLuint TextureTarget,
 		return false;
 
 	// Create or resize a local OpenGL texture
-	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight);
+	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight, m_TexFormat);
 
 	// Create an fbo if not already
 	if(m_fbo == 0) glGenFramebuffersEXT(1, &m_fbo); 
 
 	// Draw the shared texture into the user texture via an fbo
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_fbo);
+	spoutGLState::BindFramebuffer(m_fbo);
 
 	// Destination is the fbo with local texture attached
 	glFramebufferTexture2DEXT(GL_READ_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, m_TexID, 0);
@@ -2688,7 +2759,7 @@ bool spoutGLDXinterop::DrawToDX11texture(GLuint TextureID, GLuint TextureTarget,
 		// Draw the input texture
 		glColor4f(1.f, 1.f, 1.f, 1.f);
 		glEnable(TextureTarget);
-		glBindTexture(TextureTarget, TextureID);
+		spoutGLState::BindTexture(TextureTarget, TextureID);
 
 		GLfloat tc[4][2] = {0};
 
@@ -2720,18 +2791,18 @@ bool spoutGLDXinterop::DrawToDX11texture(GLuint TextureID, GLuint TextureTarget,
 		glDisableClientState(GL_VERTEX_ARRAY);
 		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 
-		glBindTexture(TextureTarget, 0);
+		spoutGLState::UnbindTexture(TextureTarget);
 		glDisable(TextureTarget);
 
 	}
 	else {
 		PrintFBOstatus(status);
-		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+		spoutGLState::RestoreFramebuffer(HostFBO);
 		return false;
 	}
 
 	// restore the previous fbo - default is 0
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+	spoutGLState::RestoreFramebuffer(HostFBO);
 
 	// Copy the result in the local OpenGL texture to the DX11 shared texture
 	return(WriteDX11texture(m_TexID, GL_TEXTURE_2D, width, height, false, HostFBO));
@@ -2822,7 +2893,7 @@ bool spoutGLDXinterop::WriteDX9texture (GLuint TextureID,
 		return false;
 
 	// Create or resize a local OpenGL texture
-	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight);
+	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight, m_TexFormat);
 
 	// Copy the user texture to the local texture - necessary for inversion
 	CopyTexture(TextureID, TextureTarget, m_TexID, GL_TEXTURE_2D, width, height, bInvert, HostFBO);
@@ -2836,7 +2907,7 @@ bool spoutGLDXinterop::WriteDX9texture (GLuint TextureID,
 		}
 		else { 
 			// Bind our local fbo - current fbo has to be passed in
-			glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_fbo); 
+			spoutGLState::BindFramebuffer(m_fbo); 
 			// Attach the local rgba texture to the color buffer in our frame buffer
 			glFramebufferTexture2DEXT(GL_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, m_TexID, 0);
 			GLenum status = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT);
@@ -2848,7 +2919,7 @@ bool spoutGLDXinterop::WriteDX9texture (GLuint TextureID,
 				PrintFBOstatus(status);
 			}
 			// restore the previous fbo - default is 0
-			glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+			spoutGLState::RestoreFramebuffer(HostFBO);
 		}
 		g_DX9surface->UnlockRect();
 
@@ -2887,7 +2958,7 @@ bool spoutGLDXinterop::ReadDX9texture (GLuint TextureID,
 		return false;
 
 	// Create or resize a local OpenGL texture
-	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight);
+	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight, m_TexFormat);
 
 	if(spoutdx.CheckAccess(m_hAccessMutex)) {
 		// Create a local shared texture surface
@@ -2904,9 +2975,9 @@ bool spoutGLDXinterop::ReadDX9texture (GLuint TextureID,
 						LoadTexturePixels(m_TexID, GL_TEXTURE_2D, width, height, (const unsigned char *)d3dlr.pBits, GL_BGRA_EXT);
 					}
 					else {
-						glBindTexture(GL_TEXTURE_2D, m_TexID);
+						spoutGLState::BindTexture(GL_TEXTURE_2D, m_TexID);
 						glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_BGRA_EXT, GL_UNSIGNED_BYTE, d3dlr.pBits);
-						glBindTexture(GL_TEXTURE_2D, 0);
+						spoutGLState::UnbindTexture(GL_TEXTURE_2D);
 					}
 					// Copy the local texture to the user texture and invert as necessary
 					CopyTexture(m_TexID, GL_TEXTURE_2D, TextureID, TextureTarget, width, height, bInvert, HostFBO);
@@ -3074,7 +3145,7 @@ bool spoutGLDXinterop::DrawDX9texture(float max_x, float max_y, float aspect, bo
 		return false;
 
 	// Create or resize a local OpenGL texture
-	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight);
+	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight, m_TexFormat);
 
 	if(spoutdx.CheckAccess(m_hAccessMutex)) {
 		// Create a local shared texture surface
@@ -3088,15 +3159,15 @@ bool spoutGLDXinterop::DrawDX9texture(float max_x, float max_y, float aspect, bo
 				if(SUCCEEDED(hr)) {
 
 					// Copy the surface pixels to the local OpenGL texture
-					glBindTexture(GL_TEXTURE_2D, m_TexID);
+					spoutGLState::BindTexture(GL_TEXTURE_2D, m_TexID);
 					glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_BGRA_EXT, GL_UNSIGNED_BYTE, d3dlr.pBits);
-					glBindTexture(GL_TEXTURE_2D, 0);
+					spoutGLState::UnbindTexture(GL_TEXTURE_2D);
 					g_DX9surface->UnlockRect();
 
 					// Draw the local texture and invert as necessary
 					SaveOpenGLstate(width, height);
 					glEnable(GL_TEXTURE_2D);
-					glBindTexture(GL_TEXTURE_2D, m_TexID);
+					spoutGLState::BindTexture(GL_TEXTURE_2D, m_TexID);
 					glColor4f(1.f, 1.f, 1.f, 1.f);
 					glBegin(GL_QUADS);
 					if(bInvert) {
@@ -3113,7 +3184,7 @@ bool spoutGLDXinterop::DrawDX9texture(float max_x, float max_y, float aspect, bo
 						glTexCoord2f(max_x, max_y);	glVertex2f( aspect,-1.0); // lower right
 					}
 					glEnd();
-					glBindTexture(GL_TEXTURE_2D, 0);
+					spoutGLState::UnbindTexture(GL_TEXTURE_2D);
 					glDisable(GL_TEXTURE_2D);
 					RestoreOpenGLstate();
 				}
@@ -3152,11 +3223,11 @@ bool spoutGLDXinterop::DrawToDX9texture(GLuint TextureID, GLuint TextureTarget,
 		return false;
 
 	// Create or resize a local OpenGL texture
-	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight);
+	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight, m_TexFormat);
 
 
 	// Draw the input texture into the local texture via an fbo
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_fbo);
+	spoutGLState::BindFramebuffer(m_fbo);
 	// Destination is the fbo with local texture attached
 	glFramebufferTexture2DEXT(GL_READ_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, m_TexID, 0);
 	status = glCheckFramebufferStatusEXT(GL_FRAMEBUFFER_EXT);
@@ -3165,7 +3236,7 @@ bool spoutGLDXinterop::DrawToDX9texture(GLuint TextureID, GLuint TextureTarget,
 		// Draw the input texture
 		glColor4f(1.f, 1.f, 1.f, 1.f);
 		glEnable(TextureTarget);
-		glBindTexture(TextureTarget, TextureID);
+		spoutGLState::BindTexture(TextureTarget, TextureID);
 		GLfloat tc[4][2] = {0};
 		// Invert texture coord to user requirements
 		if(bInvert) {
@@ -3192,18 +3263,18 @@ bool spoutGLDXinterop::DrawToDX9texture(GLuint TextureID, GLuint TextureTarget,
 		glDisableClientState(GL_VERTEX_ARRAY);
 		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 
-		glBindTexture(TextureTarget, 0);
+		spoutGLState::UnbindTexture(TextureTarget);
 		glDisable(TextureTarget);
 
 	}
 	else {
 		PrintFBOstatus(status);
-		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+		spoutGLState::RestoreFramebuffer(HostFBO);
 		return false;
 	}
 
 	// restore the previous fbo - default is 0
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+	spoutGLState::RestoreFramebuffer(HostFBO);
 
 	// Copy the result in the local OpenGL texture to the shared DX9 texture
 	return(WriteDX9texture (m_TexID, GL_TEXTURE_2D, width, height, false, HostFBO));
@@ -3253,6 +3324,8 @@ HRESULT spoutGLDXinterop::LockInteropObject(HANDLE hDevice, HANDLE *hObject)
 		return E_HANDLE;
 	}
 
+	SPOUT_TRACE("LockInteropObject");
+
 	// lock dx object
 	if(wglDXLockObjectsNV(hDevice, 1, hObject) == TRUE) {
 		return S_OK;
@@ -3419,9 +3492,19 @@ bool spoutGLDXinterop::GetMemoryShareMode()
 	if(spoutdx.ReadDwordFromRegistry(&dwMem, "Software\\Leading Edge\\Spout", "MemoryShare")) {
 		m_bUseMemory = (dwMem == 1);
 	}	
+	if(m_bForceMemory) m_bUseMemory = true;
 	return m_bUseMemory;
 }
 
+// Memoryshare for this object only, other Spout applications are not affected.
+// Takes effect when the sender or receiver is created.
+void spoutGLDXinterop::ForceMemoryShare(bool bForce)
+{
+	m_bForceMemory = bForce;
+	if(!bForce) m_bUseMemory = false; // back to the registry setting
+	GetMemoryShareMode();
+}
+
 
 // User set by the SpoutDXmode utility
 bool spoutGLDXinterop::SetMemoryShareMode(bool bMem)
@@ -3433,6 +3516,17 @@ bool spoutGLDXinterop::SetMemoryShareMode(bool bMem)
 	return false;
 }
 
+// Set by a memoryshare sender or receiver from the sender information
+void spoutGLDXinterop::SetMemoryFormat(DWORD dwFormat)
+{
+	m_MemoryFormat = dwFormat;
+}
+
+DWORD spoutGLDXinterop::GetMemoryFormat()
+{
+	return m_MemoryFormat;
+}
+
 //
 // Return sharing mode set by user or by an application
 // Reads the registry - avoid repeated use every frame.
@@ -3634,7 +3728,7 @@ void spoutGLDXinterop::PrintFBOstatus(GLenum status)
 
 //
 // Write user texture pixel data to shared memory
-// rgba textures only
+// rgba textures only, packed to 10 bit by OpenGL for an RGB10A2 sender
 //
 bool spoutGLDXinterop::WriteMemory (GLuint TexID, 
 									GLuint TextureTarget, 
@@ -3649,8 +3743,10 @@ bool spoutGLDXinterop::WriteMemory (GLuint TexID,
 		return false;
 	}
 
-	// Create or resize a local OpenGL texture
-	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight);
+	// Create or resize a local OpenGL texture in the precision of the memory
+	GLenum internalFormat, glType;
+	GetMemoryPixelFormat(internalFormat, glType);
+	CheckOpenGLTexture(m_TexID, internalFormat, width, height, m_TexWidth, m_TexHeight, m_TexFormat);
 
 	// Copy the user texture to the local rgba texture and invert as necessary
 	// There is not much speed gain bypassing the intermediate texture
@@ -3660,13 +3756,13 @@ bool spoutGLDXinterop::WriteMemory (GLuint TexID,
 	// Read the local opengl texture into the rgba memory map buffer
 	// Use PBO if supported
 	if(IsPBOavailable()) {
-		UnloadTexturePixels(m_TexID, GL_TEXTURE_2D, width, height, pBuffer, GL_RGBA, false, HostFBO);
+		UnloadTexturePixels(m_TexID, GL_TEXTURE_2D, width, height, pBuffer, GL_RGBA, false, HostFBO, glType);
 	}
 	else {
 		// printf("glGetTexImage\n");
-		glBindTexture(GL_TEXTURE_2D, m_TexID);
-		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid *)pBuffer);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		spoutGLState::BindTexture(GL_TEXTURE_2D, m_TexID);
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, glType, (GLvoid *)pBuffer);
+		spoutGLState::UnbindTexture(GL_TEXTURE_2D);
 	}
 
 	memoryshare.UnlockSenderMemory();
@@ -3676,7 +3772,7 @@ bool spoutGLDXinterop::WriteMemory (GLuint TexID,
 
 //
 // Read shared memory to texture pixel data
-// rgba textures only
+// rgba textures only, unpacked by OpenGL from 10 bit
 //
 bool spoutGLDXinterop::ReadMemory(GLuint TexID, 
 								  GLuint TextureTarget,
@@ -3688,17 +3784,19 @@ bool spoutGLDXinterop::ReadMemory(GLuint TexID,
 	unsigned char *pBuffer = memoryshare.LockSenderMemory();
 	if(!pBuffer) return false;
 
-	// Create or resize a local OpenGL texture
-	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight);
+	// Create or resize a local OpenGL texture in the precision of the memory
+	GLenum internalFormat, glType;
+	GetMemoryPixelFormat(internalFormat, glType);
+	CheckOpenGLTexture(m_TexID, internalFormat, width, height, m_TexWidth, m_TexHeight, m_TexFormat);
 	
 	// Copy the rgba memory map pixels to the local rgba opengl texture
 	if(IsPBOavailable()) {
-		LoadTexturePixels(m_TexID, GL_TEXTURE_2D, width, height, (const unsigned char *)pBuffer, GL_RGBA);
+		LoadTexturePixels(m_TexID, GL_TEXTURE_2D, width, height, (const unsigned char *)pBuffer, GL_RGBA, false, glType);
 	}
 	else {
-		glBindTexture(GL_TEXTURE_2D, m_TexID);
-		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid *)pBuffer);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		spoutGLState::BindTexture(GL_TEXTURE_2D, m_TexID);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, glType, (GLvoid *)pBuffer);
+		spoutGLState::UnbindTexture(GL_TEXTURE_2D);
 	}
 
 	// Copy the local rgba texture to the user texture and invert as necessary
@@ -3713,6 +3811,7 @@ bool spoutGLDXinterop::ReadMemory(GLuint TexID,
 //
 // Write image pixels to shared memory
 // rgba, bgra, rgb, bgr source buffers supported
+// rgba only for 10 bit memory
 //
 bool spoutGLDXinterop::WriteMemoryPixels(const unsigned char *pixels, unsigned int width, unsigned int height, GLenum glFormat, bool bInvert)
 {
@@ -3722,7 +3821,14 @@ bool spoutGLDXinterop::WriteMemoryPixels(const unsigned char *pixels, unsigned i
 		return false;
 
 	// Write pixels to shared memory
-	if(glFormat == GL_RGBA) {
+	if(spoutFormat::FromDXGIFormat(m_MemoryFormat) == SPOUT_FORMAT_RGB10A2) {
+		if(glFormat != GL_RGBA) {
+			memoryshare.UnlockSenderMemory();
+			return false;
+		}
+		spoutcopy.rgba2rgb10a2((void *)pixels, (void *)pBuffer, width, height, bInvert);
+	}
+	else if(glFormat == GL_RGBA) {
 		spoutcopy.CopyPixels(pixels, pBuffer, width, height, GL_RGBA, bInvert);
 	}
 	else if(glFormat == 0x80E1) { // GL_BGRA_EXT if supported
@@ -3746,6 +3852,7 @@ bool spoutGLDXinterop::WriteMemoryPixels(const unsigned char *pixels, unsigned i
 // Read shared memory to image pixels
 // rgba, bgra, rgb, bgr destination buffers supported
 // Most efficient if the receiving buffer is rgba
+// rgba only for 10 bit memory
 // Invert currently not used
 //
 bool spoutGLDXinterop::ReadMemoryPixels(unsigned char *pixels, unsigned int width, unsigned int height, GLenum glFormat, bool bInvert)
@@ -3756,7 +3863,14 @@ bool spoutGLDXinterop::ReadMemoryPixels(unsigned char *pixels, unsigned int widt
 		return false;
 
 	// Read pixels from shared memory
-	if(glFormat == GL_RGBA) {
+	if(spoutFormat::FromDXGIFormat(m_MemoryFormat) == SPOUT_FORMAT_RGB10A2) {
+		if(glFormat != GL_RGBA) {
+			memoryshare.UnlockSenderMemory();
+			return false;
+		}
+		spoutcopy.rgb10a2rgba((void *)pBuffer, (void *)pixels, width, height, bInvert);
+	}
+	else if(glFormat == GL_RGBA) {
 		spoutcopy.CopyPixels(pBuffer, pixels, width, height, GL_RGBA, bInvert);
 	}
 	else if(glFormat == 0x80E1) { // GL_BGRA_EXT if supported
@@ -3799,8 +3913,10 @@ bool spoutGLDXinterop::DrawToSharedMemory(GLuint TexID, GLuint TextureTarget,
 		return false;
 	}
 
-	// Create or resize a local OpenGL texture
-	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight);
+	// Create or resize a local OpenGL texture in the precision of the memory
+	GLenum internalFormat, glType;
+	GetMemoryPixelFormat(internalFormat, glType);
+	CheckOpenGLTexture(m_TexID, internalFormat, width, height, m_TexWidth, m_TexHeight, m_TexFormat);
 
 	// Create an fbo if not already
 	if(m_fbo == 0) glGenFramebuffersEXT(1, &m_fbo); 
@@ -3808,7 +3924,7 @@ bool spoutGLDXinterop::DrawToSharedMemory(GLuint TexID, GLuint TextureTarget,
 	//
 	// Draw the input texture into the local texture via an fbo
 	//
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_fbo);
+	spoutGLState::BindFramebuffer(m_fbo);
 
 	// Destination is the fbo with local texture attached
 	glFramebufferTexture2DEXT(GL_READ_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, GL_TEXTURE_2D, m_TexID, 0);
@@ -3819,7 +3935,7 @@ bool spoutGLDXinterop::DrawToSharedMemory(GLuint TexID, GLuint TextureTarget,
 		// Draw the input texture
 		glColor4f(1.f, 1.f, 1.f, 1.f);
 		glEnable(TextureTarget);
-		glBindTexture(TextureTarget, TexID);
+		spoutGLState::BindTexture(TextureTarget, TexID);
 
 		GLfloat tc[4][2] = {0};
 
@@ -3851,29 +3967,29 @@ bool spoutGLDXinterop::DrawToSharedMemory(GLuint TexID, GLuint TextureTarget,
 		glDisableClientState(GL_VERTEX_ARRAY);
 		glDisableClientState(GL_TEXTURE_COORD_ARRAY);
 
-		glBindTexture(TextureTarget, 0);
+		spoutGLState::UnbindTexture(TextureTarget);
 		glDisable(TextureTarget);
 
 	}
 	else {
 		PrintFBOstatus(status);
-		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+		spoutGLState::RestoreFramebuffer(HostFBO);
 		memoryshare.UnlockSenderMemory();
 		return false;
 	}
 
 	// restore the previous fbo - default is 0
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+	spoutGLState::RestoreFramebuffer(HostFBO);
 
 	// Now read the local opengl texture into the memory map buffer
 	// Use PBO if supported
 	if(IsPBOavailable()) {
-		UnloadTexturePixels(m_TexID, GL_TEXTURE_2D, width, height, pBuffer, GL_RGBA, false, HostFBO);
+		UnloadTexturePixels(m_TexID, GL_TEXTURE_2D, width, height, pBuffer, GL_RGBA, false, HostFBO, glType);
 	}
 	else {
-		glBindTexture(GL_TEXTURE_2D, m_TexID);
-		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid *)pBuffer);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		spoutGLState::BindTexture(GL_TEXTURE_2D, m_TexID);
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, glType, (GLvoid *)pBuffer);
+		spoutGLState::UnbindTexture(GL_TEXTURE_2D);
 	}
 
 	memoryshare.UnlockSenderMemory();
@@ -3898,23 +4014,25 @@ bool spoutGLDXinterop::DrawSharedMemory(float max_x, float max_y, float aspect,
 	unsigned char *pBuffer = memoryshare.LockSenderMemory();
 	if(!pBuffer) return false;
 
-	// Create or resize a local OpenGL texture
-	CheckOpenGLTexture(m_TexID, GL_RGBA, width, height, m_TexWidth, m_TexHeight);
+	// Create or resize a local OpenGL texture in the precision of the memory
+	GLenum internalFormat, glType;
+	GetMemoryPixelFormat(internalFormat, glType);
+	CheckOpenGLTexture(m_TexID, internalFormat, width, height, m_TexWidth, m_TexHeight, m_TexFormat);
 
 	// if(IsPBOavailable()) {
 		// LoadTexturePixels(m_TexID, GL_TEXTURE_2D, width, height, (const unsigned char *)pBuffer, GL_RGBA);
 	// }
 	// else {
-		glBindTexture(GL_TEXTURE_2D, m_TexID);
-		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, (GLvoid *)pBuffer);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		spoutGLState::BindTexture(GL_TEXTURE_2D, m_TexID);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, GL_RGBA, glType, (GLvoid *)pBuffer);
+		spoutGLState::UnbindTexture(GL_TEXTURE_2D);
 	// }
 
 	// Draw the texture
 	SaveOpenGLstate(width, height);
 	glColor4f(1.f, 1.f, 1.f, 1.f);
 	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, m_TexID);
+	spoutGLState::BindTexture(GL_TEXTURE_2D, m_TexID);
 	glBegin(GL_QUADS);
 	if(bInvert) {
 		glTexCoord2f(0.0,	max_y);	glVertex2f(-aspect,-1.0); // lower left
@@ -3929,7 +4047,7 @@ bool spoutGLDXinterop::DrawSharedMemory(float max_x, float max_y, float aspect,
 		glTexCoord2f(max_x, 0.0);	glVertex2f( aspect,-1.0); // lower right
 	}
 	glEnd();
-	glBindTexture(GL_TEXTURE_2D, 0);
+	spoutGLState::UnbindTexture(GL_TEXTURE_2D);
 	glDisable(GL_TEXTURE_2D);
 	RestoreOpenGLstate();
 
@@ -3939,6 +4057,20 @@ bool spoutGLDXinterop::DrawSharedMemory(float max_x, float max_y, float aspect,
 }
 
 
+// Local texture and pixel type for the memoryshare format
+void spoutGLDXinterop::GetMemoryPixelFormat(GLenum &internalFormat, GLenum &glType)
+{
+	if(spoutFormat::FromDXGIFormat(m_MemoryFormat) == SPOUT_FORMAT_RGB10A2) {
+		internalFormat = GL_RGB10_A2;
+		glType = GL_UNSIGNED_INT_2_10_10_10_REV;
+	}
+	else {
+		internalFormat = GL_RGBA;
+		glType = GL_UNSIGNED_BYTE;
+	}
+}
+
+
 //
 // OpenGL utilities
 //
@@ -3962,7 +4094,7 @@ bool spoutGLDXinterop::CopyTexture(	GLuint SourceID,
 		glGenFramebuffersEXT(1, &m_fbo); 
 
 	// bind the FBO (for both, READ_FRAMEBUFFER_EXT and DRAW_FRAMEBUFFER_EXT)
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, m_fbo);
+	spoutGLState::BindFramebuffer(m_fbo);
 
 	// Attach the Source texture to the color buffer in our frame buffer
 	glFramebufferTexture2DEXT(READ_FRAMEBUFFER_EXT, GL_COLOR_ATTACHMENT0_EXT, SourceTarget, SourceID, 0);
@@ -3997,34 +4129,35 @@ bool spoutGLDXinterop::CopyTexture(	GLuint SourceID,
 		else {
 			// No fbo blit extension
 			// Copy from the fbo (source texture attached) to the dest texture
-			glBindTexture(DestTarget, DestID);
+			spoutGLState::BindTexture(DestTarget, DestID);
 			glCopyTexSubImage2D(DestTarget, 0, 0, 0, 0, 0, width, height);
-			glBindTexture(DestTarget, 0);
+			spoutGLState::UnbindTexture(DestTarget);
 		}
 	}
 	else {
 		PrintFBOstatus(status);
-		glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+		spoutGLState::RestoreFramebuffer(HostFBO);
 		return false;
 	}
 
 	// restore the previous fbo - default is 0
-	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, HostFBO);
+	spoutGLState::RestoreFramebuffer(HostFBO);
 
 	return true;
 
 } // end CopyTexture
 
 
-// If an OpenGL texture has not been created or it is a different size, create a new one
+// If an OpenGL texture has not been created or it is a different size or format, create a new one
 void spoutGLDXinterop::CheckOpenGLTexture(GLuint &texID, GLenum GLformat,
 										  unsigned int newWidth, unsigned int newHeight,
-										  unsigned int &texWidth, unsigned int &texHeight)
+										  unsigned int &texWidth, unsigned int &texHeight, GLenum &texFormat)
 {
-	if(texID == 0 || newWidth != texWidth || newHeight != texHeight) {
+	if(texID == 0 || newWidth != texWidth || newHeight != texHeight || GLformat != texFormat) {
 		InitTexture(texID, GLformat, newWidth, newHeight);
 		texWidth = newWidth;
 		texHeight = newHeight;
+		texFormat = GLformat;
 	}
 }
 
@@ -4032,16 +4165,20 @@ void spoutGLDXinterop::CheckOpenGLTexture(GLuint &texID, GLenum GLformat,
 // Initialize local OpenGL texture
 void spoutGLDXinterop::InitTexture(GLuint &texID, GLenum GLformat, unsigned int width, unsigned int height)
 {
-	if(texID != 0) glDeleteTextures(1, &texID);	
+	if(texID != 0) {
+		glDeleteTextures(1, &texID);
+		spoutGLState::Invalidate(); // it may have been bound
+	}
 	glGenTextures(1, &texID);
 
-	glBindTexture(GL_TEXTURE_2D, texID);
-	glTexImage2D(GL_TEXTURE_2D, 0, GLformat, width, height, 0, GLformat, GL_UNSIGNED_BYTE, NULL); 
+	spoutGLState::BindTexture(GL_TEXTURE_2D, texID);
+	// GLformat is the internal format, e.g. GL_RGBA or GL_RGB10_A2 for 10 bit memoryshare
+	glTexImage2D(GL_TEXTURE_2D, 0, GLformat, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL); 
 	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
 	glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glBindTexture(GL_TEXTURE_2D, 0);
+	spoutGLState::UnbindTexture(GL_TEXTURE_2D);
 
 }
 
@@ -4116,6 +4253,9 @@ void spoutGLDXinterop::RestoreOpenGLstate()
 	glPopClientAttrib();			
 	glPopAttrib();
 
+	// The texture bindings are back to what they were when pushed
+	spoutGLState::Invalidate();
+
 }
 
 
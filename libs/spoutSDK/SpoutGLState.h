@@ -0,0 +1,90 @@
+/*
+
+	spoutGLState.h
+
+	Shadow of the OpenGL bindings changed by the interop functions.
+
+	A frame scope opened with Begin(HostFBO) lets the interop skip binds of
+	objects that are already bound, and defer the restores of the host
+	framebuffer and of the texture bindings to End(). Consecutive copies
+	through the local fbo, e.g. CopyTexture followed by UnloadTexturePixels,
+	then bind it once and the host state is put back once per frame.
+
+	The shadow is kept per thread, like the current OpenGL context. Within
+	a scope, OpenGL calls made outside this class must leave the bindings
+	as they found them, or be preceded by Restore() when they need the host
+	state, e.g. drawing into the host fbo. Outside a scope every call goes
+	straight to OpenGL, so applications that don't open one see no change.
+
+	The issued and skipped counts let a test check the binds made with a
+	recording OpenGL.
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#pragma once
+
+#ifndef __spoutGLState__
+#define __spoutGLState__
+
+#include "SpoutCommon.h"
+
+class SPOUT_DLLEXP spoutGLState {
+
+	public:
+
+		// Scopes can nest, the outermost one restores the host state
+		static void Begin(unsigned int HostFBO);
+		static void End();
+		static bool InFrame();
+
+		// Bind the host fbo and unbind the textures and pixel buffers now
+		static void Restore();
+
+		// Forget the shadowed bindings, after deleting bound objects
+		static void Invalidate();
+
+		static void BindFramebuffer(unsigned int fbo);
+		static void RestoreFramebuffer(unsigned int HostFBO); // deferred in a frame scope
+		static void BindTexture(unsigned int target, unsigned int texture);
+		static void UnbindTexture(unsigned int target); // deferred in a frame scope
+		static void BindBuffer(unsigned int target, unsigned int buffer);
+
+		// Binds passed to OpenGL and skipped, for the calling thread
+		static void GetCounts(unsigned int &issued, unsigned int &skipped);
+		static void ResetCounts();
+
+};
+
+// Frame scope for the enclosing block
+class spoutGLStateScope {
+	public:
+		spoutGLStateScope(unsigned int HostFBO) { spoutGLState::Begin(HostFBO); }
+		~spoutGLStateScope() { spoutGLState::End(); }
+};
+
+#endif
@@ -68,6 +68,10 @@
 // If load of PBO extensions conflicts, disable them here - OK for Jitter
 #define USE_PBO_EXTENSIONS
 
+// set this to run on a recording OpenGL in host memory, for tests and
+// benchmarks without a GPU (see spoutMockGL.h)
+// #define USE_MOCK_GL
+
 #include <windows.h>
 #include <stdio.h> // for debug print
 #ifdef USE_GLEW
@@ -126,6 +130,23 @@
 
 #define GL_CLAMP_TO_EDGE				0x812F
 
+// Pixel formats, see spoutFormat.h
+#ifndef GL_RGB10_A2
+#define GL_RGB10_A2						0x8059
+#endif
+
+#ifndef GL_RGBA16F
+#define GL_RGBA16F						0x881A
+#endif
+
+#ifndef GL_HALF_FLOAT
+#define GL_HALF_FLOAT					0x140B
+#endif
+
+#ifndef GL_UNSIGNED_INT_2_10_10_10_REV
+#define GL_UNSIGNED_INT_2_10_10_10_REV	0x8368
+#endif
+
 #ifndef USE_GLEW
 
 // ----------------------------
@@ -313,4 +334,8 @@ bool loadSwapExtensions();
 bool loadPBOextensions();
 // bool isExtensionSupported(const char *extension);
 
+#ifdef USE_MOCK_GL
+#include "SpoutMockGL.h"
+#endif
+
 #endif
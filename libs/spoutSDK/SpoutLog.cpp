@@ -0,0 +1,308 @@
+/*
+
+	spoutLog.cpp
+
+	Asynchronous, rate limited logging.
+	See spoutLog.h
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "SpoutLog.h"
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+// Interval at which the writer thread empties the queue
+#define LOG_DRAIN_MSEC 10
+
+// Bounded multiple producer queue, each cell carries a sequence number
+// telling whether it is free for the producer at a position or ready
+// for the consumer
+struct spoutLogCell {
+	std::atomic<unsigned int> sequence;
+	int level;
+	char text[SPOUT_LOG_MESSAGE_SIZE];
+};
+
+struct spoutLogQueue {
+
+	spoutLogCell cells[SPOUT_LOG_QUEUE_SIZE];
+	std::atomic<unsigned int> enqueuePos;
+	unsigned int dequeuePos; // writer thread only
+
+	spoutLogQueue() {
+		for(unsigned int i = 0; i < SPOUT_LOG_QUEUE_SIZE; i++)
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+		enqueuePos = 0;
+		dequeuePos = 0;
+	}
+
+	bool Push(int level, const char *text) {
+		unsigned int pos = enqueuePos.load(std::memory_order_relaxed);
+		spoutLogCell *cell;
+		for(;;) {
+			cell = &cells[pos % SPOUT_LOG_QUEUE_SIZE];
+			int diff = (int)(cell->sequence.load(std::memory_order_acquire) - pos);
+			if(diff == 0) {
+				if(enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+					break;
+			}
+			else if(diff < 0) {
+				return false; // full
+			}
+			else {
+				pos = enqueuePos.load(std::memory_order_relaxed);
+			}
+		}
+		cell->level = level;
+		strncpy_s(cell->text, SPOUT_LOG_MESSAGE_SIZE, text, _TRUNCATE);
+		cell->sequence.store(pos + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool Pop(int &level, char *text) {
+		spoutLogCell *cell = &cells[dequeuePos % SPOUT_LOG_QUEUE_SIZE];
+		if((int)(cell->sequence.load(std::memory_order_acquire) - (dequeuePos + 1)) < 0)
+			return false; // empty
+		level = cell->level;
+		memcpy(text, cell->text, SPOUT_LOG_MESSAGE_SIZE);
+		cell->sequence.store(dequeuePos + SPOUT_LOG_QUEUE_SIZE, std::memory_order_release);
+		dequeuePos++;
+		return true;
+	}
+
+};
+
+struct spoutLogState {
+
+	spoutLogQueue queue;
+	std::atomic<unsigned int> dropped;
+	unsigned int droppedReported;
+
+	// Writer thread
+	std::mutex startMutex;
+	int users;
+	std::thread writer;
+	std::atomic<bool> bRunning;
+	std::atomic<bool> bExit;
+
+	// Outputs, used by one thread at a time
+	std::mutex outputMutex;
+	bool bConsole;
+	bool bDebugger;
+	FILE *file;
+
+	spoutLogState() {
+		dropped = 0;
+		droppedReported = 0;
+		users = 0;
+		bRunning = false;
+		bExit = false;
+		bConsole = true;
+		bDebugger = true;
+		file = NULL;
+	}
+
+	~spoutLogState() {
+		// Stop was not called, the thread may be gone already at exit
+		if(writer.joinable()) writer.detach();
+		if(file) fclose(file);
+	}
+
+};
+
+static spoutLogState& GetState()
+{
+	static spoutLogState state;
+	return state;
+}
+
+static const char* LevelPrefix(int level)
+{
+	switch(level) {
+		case SPOUT_LOG_LEVEL_WARNING : return "Warning : ";
+		case SPOUT_LOG_LEVEL_ERROR : return "Error : ";
+		default : return "";
+	}
+}
+
+// Caller holds the output mutex
+static void Output(spoutLogState &state, int level, const char *text)
+{
+	char line[SPOUT_LOG_MESSAGE_SIZE + 16];
+	sprintf_s(line, sizeof(line), "%s%s\n", LevelPrefix(level), text);
+
+	if(state.bConsole) fputs(line, stdout);
+	if(state.bDebugger) OutputDebugStringA(line);
+	if(state.file) {
+		fputs(line, state.file);
+		fflush(state.file);
+	}
+}
+
+static void Drain(spoutLogState &state)
+{
+	std::lock_guard<std::mutex> lock(state.outputMutex);
+
+	int level;
+	char text[SPOUT_LOG_MESSAGE_SIZE];
+	while(state.queue.Pop(level, text))
+		Output(state, level, text);
+
+	unsigned int dropped = state.dropped.load(std::memory_order_relaxed);
+	if(dropped != state.droppedReported) {
+		sprintf_s(text, sizeof(text), "spoutLog : %u messages dropped", dropped - state.droppedReported);
+		Output(state, SPOUT_LOG_LEVEL_WARNING, text);
+		state.droppedReported = dropped;
+	}
+}
+
+static void WriterThread()
+{
+	spoutLogState &state = GetState();
+
+	while(!state.bExit) {
+		Drain(state);
+		std::this_thread::sleep_for(std::chrono::milliseconds(LOG_DRAIN_MSEC));
+	}
+
+	Drain(state);
+}
+
+
+void spoutLog::Start()
+{
+	spoutLogState &state = GetState();
+	std::lock_guard<std::mutex> lock(state.startMutex);
+
+	if(state.users++ == 0) {
+		state.bExit = false;
+		state.writer = std::thread(WriterThread);
+		state.bRunning = true;
+	}
+}
+
+void spoutLog::Stop()
+{
+	spoutLogState &state = GetState();
+	std::lock_guard<std::mutex> lock(state.startMutex);
+
+	if(state.users == 0) return;
+
+	if(--state.users == 0) {
+		state.bRunning = false;
+		state.bExit = true;
+		state.writer.join();
+
+		// Messages pushed while the thread was finishing
+		Drain(state);
+	}
+}
+
+void spoutLog::SetConsole(bool bConsole)
+{
+	spoutLogState &state = GetState();
+	std::lock_guard<std::mutex> lock(state.outputMutex);
+	state.bConsole = bConsole;
+}
+
+void spoutLog::SetDebugger(bool bDebugger)
+{
+	spoutLogState &state = GetState();
+	std::lock_guard<std::mutex> lock(state.outputMutex);
+	state.bDebugger = bDebugger;
+}
+
+bool spoutLog::SetFile(const char *path)
+{
+	spoutLogState &state = GetState();
+	std::lock_guard<std::mutex> lock(state.outputMutex);
+
+	if(state.file) {
+		fclose(state.file);
+		state.file = NULL;
+	}
+
+	if(path == NULL)
+		return true;
+
+	return fopen_s(&state.file, path, "a") == 0 && state.file != NULL;
+}
+
+void spoutLog::Write(spoutLogSite *site, int level, const char *format, ...)
+{
+	spoutLogState &state = GetState();
+
+	// Rate limit per call site. Concurrent callers may let a message
+	// more or less through, which doesn't matter here.
+	unsigned long long now = GetTickCount64();
+	if(now - site->windowStart.load(std::memory_order_relaxed) >= SPOUT_LOG_WINDOW_MS) {
+		site->windowStart.store(now, std::memory_order_relaxed);
+		site->count.store(0, std::memory_order_relaxed);
+	}
+	if(site->count.fetch_add(1, std::memory_order_relaxed) >= SPOUT_LOG_BURST) {
+		site->suppressed.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	char text[SPOUT_LOG_MESSAGE_SIZE];
+	va_list args;
+	va_start(args, format);
+	vsnprintf_s(text, sizeof(text), _TRUNCATE, format, args);
+	va_end(args);
+
+	// Trailing line feeds are added by the output
+	size_t length = strlen(text);
+	while(length > 0 && text[length - 1] == '\n')
+		text[--length] = 0;
+
+	unsigned int suppressed = site->suppressed.exchange(0, std::memory_order_relaxed);
+	// Truncated rather than sprintf_s, whose invalid parameter handler
+	// would end the host process when the message fills the buffer
+	if(suppressed > 0)
+		_snprintf_s(text + length, sizeof(text) - length, _TRUNCATE, " (%u similar suppressed)", suppressed);
+
+	if(state.bRunning) {
+		if(!state.queue.Push(level, text))
+			state.dropped.fetch_add(1, std::memory_order_relaxed);
+	}
+	else {
+		std::lock_guard<std::mutex> lock(state.outputMutex);
+		Output(state, level, text);
+	}
+}
+
+unsigned int spoutLog::GetDropped()
+{
+	return GetState().dropped.load(std::memory_order_relaxed);
+}
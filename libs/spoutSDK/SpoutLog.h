@@ -0,0 +1,129 @@
+/*
+
+	spoutLog.h
+
+	Asynchronous, rate limited logging.
+
+	SPOUT_LOG_NOTICE("format", ...) and the other level macros format
+	the message on the calling thread and push it to a lock free queue,
+	a background thread writes it to the console, the debugger output
+	and optionally a file. The calling thread never waits for output.
+
+	- Levels below SPOUT_LOG_LEVEL are compiled out
+	- Each call site lets SPOUT_LOG_BURST messages through per
+	  SPOUT_LOG_WINDOW_MS, the next message that passes tells how
+	  many were suppressed
+	- Messages are dropped and counted if the queue is full
+
+	The writer thread runs between Start and Stop, which are reference
+	counted. Messages logged without it are written by the calling
+	thread. Stop writes what is left in the queue.
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#pragma once
+
+#ifndef __spoutLog__
+#define __spoutLog__
+
+#include "SpoutCommon.h"
+#include <atomic>
+
+#define SPOUT_LOG_LEVEL_VERBOSE 0
+#define SPOUT_LOG_LEVEL_NOTICE  1
+#define SPOUT_LOG_LEVEL_WARNING 2
+#define SPOUT_LOG_LEVEL_ERROR   3
+#define SPOUT_LOG_LEVEL_NONE    4
+
+// Lowest level compiled in
+#ifndef SPOUT_LOG_LEVEL
+#define SPOUT_LOG_LEVEL SPOUT_LOG_LEVEL_NOTICE
+#endif
+
+// Messages let through per call site and time window
+#define SPOUT_LOG_BURST 5
+#define SPOUT_LOG_WINDOW_MS 1000
+
+// Queue length and longest message
+#define SPOUT_LOG_QUEUE_SIZE 256
+#define SPOUT_LOG_MESSAGE_SIZE 256
+
+// Rate limit state of a call site
+struct spoutLogSite {
+	std::atomic<unsigned long long> windowStart;
+	std::atomic<unsigned int> count;
+	std::atomic<unsigned int> suppressed;
+};
+
+class SPOUT_DLLEXP spoutLog {
+
+	public:
+
+		static void Start();
+		static void Stop();
+
+		// Outputs, console and debugger are on by default
+		static void SetConsole(bool bConsole);
+		static void SetDebugger(bool bDebugger);
+		static bool SetFile(const char *path); // appended to, NULL to close
+
+		static void Write(spoutLogSite *site, int level, const char *format, ...);
+
+		// Messages lost because the queue was full
+		static unsigned int GetDropped();
+
+};
+
+#define SPOUT_LOG_WRITE(level, ...) \
+	do { static spoutLogSite spoutLogSite_; spoutLog::Write(&spoutLogSite_, level, __VA_ARGS__); } while(0)
+
+#if SPOUT_LOG_LEVEL <= SPOUT_LOG_LEVEL_VERBOSE
+#define SPOUT_LOG_VERBOSE(...) SPOUT_LOG_WRITE(SPOUT_LOG_LEVEL_VERBOSE, __VA_ARGS__)
+#else
+#define SPOUT_LOG_VERBOSE(...) ((void)0)
+#endif
+
+#if SPOUT_LOG_LEVEL <= SPOUT_LOG_LEVEL_NOTICE
+#define SPOUT_LOG_NOTICE(...) SPOUT_LOG_WRITE(SPOUT_LOG_LEVEL_NOTICE, __VA_ARGS__)
+#else
+#define SPOUT_LOG_NOTICE(...) ((void)0)
+#endif
+
+#if SPOUT_LOG_LEVEL <= SPOUT_LOG_LEVEL_WARNING
+#define SPOUT_LOG_WARNING(...) SPOUT_LOG_WRITE(SPOUT_LOG_LEVEL_WARNING, __VA_ARGS__)
+#else
+#define SPOUT_LOG_WARNING(...) ((void)0)
+#endif
+
+#if SPOUT_LOG_LEVEL <= SPOUT_LOG_LEVEL_ERROR
+#define SPOUT_LOG_ERROR(...) SPOUT_LOG_WRITE(SPOUT_LOG_LEVEL_ERROR, __VA_ARGS__)
+#else
+#define SPOUT_LOG_ERROR(...) ((void)0)
+#endif
+
+#endif
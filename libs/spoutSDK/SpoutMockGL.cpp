@@ -0,0 +1,821 @@
+/*
+
+	spoutMockGL.cpp
+
+	Recording OpenGL for testing and benchmarking without a GPU.
+	See spoutMockGL.h
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "SpoutMockGL.h"
+
+#ifdef USE_MOCK_GL
+
+#include "SpoutLog.h"
+#include "SpoutCopy.h"
+
+#include <map>
+#include <string>
+#include <vector>
+#include <string.h>
+
+#ifndef GL_BGRA_EXT
+#define GL_BGRA_EXT 0x80E1
+#endif
+#ifndef GL_BGR_EXT
+#define GL_BGR_EXT 0x80E0
+#endif
+
+struct spoutMockTexture {
+	unsigned int width, height;
+	std::vector<unsigned char> pixels; // RGBA, 8 bits per channel whatever the internal format
+};
+
+struct spoutMockFramebuffer {
+	GLuint attachments[2]; // color attachments 0 and 1
+	GLenum readBuffer, drawBuffer;
+};
+
+struct spoutMockBuffer {
+	std::vector<unsigned char> data;
+	bool mapped;
+	unsigned int readFrame;		// frame of the last read back into it + 1, 0 if none pending
+	unsigned int uploadFrame;	// frame of the last upload from it + 1
+};
+
+struct spoutMockContext {
+	std::map<GLuint, spoutMockTexture> textures;
+	std::map<GLuint, spoutMockFramebuffer> framebuffers;
+	std::map<GLuint, spoutMockBuffer> buffers;
+	GLuint nextName;
+
+	GLuint texture2D;
+	GLuint framebuffer;
+	GLuint packBuffer, unpackBuffer;
+	GLint packAlignment, unpackAlignment;
+	GLint viewport[4];
+	int swapInterval;
+
+	spoutMockGLLatency latency;
+	spoutMockGLStats stats;
+	std::map<std::string, unsigned int> calls;
+};
+
+static spoutMockContext g_MockGL;
+static bool g_bMockGLinitialized = false;
+
+static spoutMockContext &Context()
+{
+	if(!g_bMockGLinitialized) {
+		g_bMockGLinitialized = true;
+		spoutMockGL::Reset();
+		// A discrete GPU on PCIe 3, roughly
+		spoutMockGLLatency latency = { 0.05, 6000.0, 3000.0, 100000.0, 250.0 };
+		spoutMockGL::SetLatency(latency);
+	}
+	return g_MockGL;
+}
+
+static void Call(const char *name)
+{
+	spoutMockContext &gl = Context();
+	gl.calls[name]++;
+	gl.stats.calls++;
+	gl.stats.simulatedUs += gl.latency.callUs;
+}
+
+static void Upload(size_t bytes)
+{
+	spoutMockContext &gl = Context();
+	gl.stats.bytesUploaded += bytes;
+	gl.stats.simulatedUs += (double)bytes / gl.latency.uploadMBps;
+}
+
+static void Download(size_t bytes)
+{
+	spoutMockContext &gl = Context();
+	gl.stats.bytesDownloaded += bytes;
+	gl.stats.simulatedUs += (double)bytes / gl.latency.downloadMBps;
+}
+
+static void Copy(size_t bytes)
+{
+	spoutMockContext &gl = Context();
+	gl.stats.bytesCopied += bytes;
+	gl.stats.simulatedUs += (double)bytes / gl.latency.copyMBps;
+}
+
+static void Stall()
+{
+	spoutMockContext &gl = Context();
+	gl.stats.stalls++;
+	gl.stats.simulatedUs += gl.latency.stallUs;
+}
+
+//
+// Pixel transfers
+//
+
+static unsigned int Channels(GLenum format)
+{
+	return (format == GL_RGB || format == GL_BGR_EXT) ? 3 : 4;
+}
+
+// Packed 10 bit and half float transfers are rgba only
+static unsigned int PixelSize(GLenum format, GLenum type)
+{
+	if(type == GL_UNSIGNED_INT_2_10_10_10_REV)
+		return 4;
+	if(type == GL_HALF_FLOAT)
+		return 8;
+	return Channels(format);
+}
+
+static size_t RowPitch(unsigned int width, GLenum format, GLenum type, GLint alignment)
+{
+	size_t pitch = (size_t)width*PixelSize(format, type);
+	if(alignment > 1)
+		pitch = (pitch + alignment - 1) / alignment * alignment;
+	return pitch;
+}
+
+// One row between client pixels of the given format and RGBA
+static void ToRGBA(const unsigned char *src, GLenum format, GLenum type, unsigned char *dst, unsigned int width)
+{
+	static spoutCopy copy;
+	if(type == GL_UNSIGNED_INT_2_10_10_10_REV) {
+		copy.rgb10a2rgba((void *)src, (void *)dst, width, 1);
+		return;
+	}
+	if(type == GL_HALF_FLOAT) {
+		copy.half2rgba((void *)src, (void *)dst, width, 1);
+		return;
+	}
+
+	bool bgr = format == GL_BGRA_EXT || format == GL_BGR_EXT;
+	unsigned int channels = Channels(format);
+	for(unsigned int i = 0; i < width; i++, src += channels, dst += 4) {
+		dst[0] = bgr ? src[2] : src[0];
+		dst[1] = src[1];
+		dst[2] = bgr ? src[0] : src[2];
+		dst[3] = channels == 4 ? src[3] : 255;
+	}
+}
+
+static void FromRGBA(const unsigned char *src, GLenum format, GLenum type, unsigned char *dst, unsigned int width)
+{
+	static spoutCopy copy;
+	if(type == GL_UNSIGNED_INT_2_10_10_10_REV) {
+		copy.rgba2rgb10a2((void *)src, (void *)dst, width, 1);
+		return;
+	}
+	if(type == GL_HALF_FLOAT) {
+		copy.rgba2half((void *)src, (void *)dst, width, 1);
+		return;
+	}
+
+	bool bgr = format == GL_BGRA_EXT || format == GL_BGR_EXT;
+	unsigned int channels = Channels(format);
+	for(unsigned int i = 0; i < width; i++, src += 4, dst += channels) {
+		dst[0] = bgr ? src[2] : src[0];
+		dst[1] = src[1];
+		dst[2] = bgr ? src[0] : src[2];
+		if(channels == 4) dst[3] = src[3];
+	}
+}
+
+static spoutMockTexture *Texture(GLuint name)
+{
+	std::map<GLuint, spoutMockTexture>::iterator itr = Context().textures.find(name);
+	return itr != Context().textures.end() ? &itr->second : NULL;
+}
+
+static spoutMockBuffer *Buffer(GLuint name)
+{
+	std::map<GLuint, spoutMockBuffer>::iterator itr = Context().buffers.find(name);
+	return itr != Context().buffers.end() ? &itr->second : NULL;
+}
+
+// Texture attached to the read or draw buffer of the bound framebuffer
+static spoutMockTexture *Attachment(bool bRead)
+{
+	spoutMockContext &gl = Context();
+	std::map<GLuint, spoutMockFramebuffer>::iterator itr = gl.framebuffers.find(gl.framebuffer);
+	if(itr == gl.framebuffers.end())
+		return NULL;
+	GLenum buffer = bRead ? itr->second.readBuffer : itr->second.drawBuffer;
+	if(buffer != GL_COLOR_ATTACHMENT0_EXT && buffer != GL_COLOR_ATTACHMENT1_EXT)
+		return NULL;
+	return Texture(itr->second.attachments[buffer - GL_COLOR_ATTACHMENT0_EXT]);
+}
+
+// Client memory, or the bound pixel buffer with the pointer as offset
+static unsigned char *PixelData(GLuint buffer, const GLvoid *pixels, size_t size)
+{
+	if(buffer == 0)
+		return (unsigned char *)pixels;
+	spoutMockBuffer *pBuffer = Buffer(buffer);
+	size_t offset = (size_t)pixels;
+	if(!pBuffer || pBuffer->mapped || offset + size > pBuffer->data.size())
+		return NULL;
+	return &pBuffer->data[offset];
+}
+
+// Rectangle of a texture into client pixels
+static void ReadRect(const spoutMockTexture &texture, int x, int y, unsigned int width, unsigned int height, GLenum format, GLenum type, unsigned char *dst, size_t pitch)
+{
+	for(unsigned int row = 0; row < height; row++) {
+		int ty = y + (int)row;
+		if(ty < 0 || ty >= (int)texture.height) continue;
+		for(unsigned int column = 0; column < width; column++) {
+			int tx = x + (int)column;
+			if(tx < 0 || tx >= (int)texture.width) continue;
+			FromRGBA(&texture.pixels[((size_t)ty*texture.width + tx)*4], format, type, dst + row*pitch + column*PixelSize(format, type), 1);
+		}
+	}
+}
+
+// Client pixels, or the bound unpack buffer, into a rectangle of a texture
+static void WriteRect(spoutMockTexture &texture, int x, int y, unsigned int width, unsigned int height, GLenum format, GLenum type, const GLvoid *pixels)
+{
+	spoutMockContext &gl = Context();
+	size_t pitch = RowPitch(width, format, type, gl.unpackAlignment);
+	const unsigned char *src = PixelData(gl.unpackBuffer, pixels, pitch*height);
+	if(!src || x < 0 || x >= (int)texture.width)
+		return;
+
+	unsigned int columns = width;
+	if(x + columns > texture.width)
+		columns = texture.width - x;
+
+	for(unsigned int row = 0; row < height; row++) {
+		int ty = y + (int)row;
+		if(ty < 0 || ty >= (int)texture.height) continue;
+		ToRGBA(src + row*pitch, format, type, &texture.pixels[((size_t)ty*texture.width + x)*4], columns);
+	}
+
+	Upload((size_t)width*height*PixelSize(format, type));
+	if(gl.unpackBuffer)
+		Buffer(gl.unpackBuffer)->uploadFrame = gl.stats.frames + 1;
+}
+
+//
+// Control
+//
+
+unsigned int spoutMockGL::Install()
+{
+	Context();
+
+	glBindFramebufferEXT			= BindFramebuffer;
+	glCheckFramebufferStatusEXT		= CheckFramebufferStatus;
+	glDeleteFramebuffersEXT			= DeleteFramebuffers;
+	glFramebufferTexture2DEXT		= FramebufferTexture2D;
+	glGenFramebuffersEXT			= GenFramebuffers;
+	glBlitFramebufferEXT			= BlitFramebuffer;
+	wglSwapIntervalEXT				= SwapInterval;
+	wglGetSwapIntervalEXT			= GetSwapInterval;
+	glGenBuffersEXT					= GenBuffers;
+	glDeleteBuffersEXT				= DeleteBuffers;
+	glBindBufferEXT					= BindBuffer;
+	glBufferDataEXT					= BufferData;
+	glMapBufferEXT					= MapBuffer;
+	glUnmapBufferEXT				= UnmapBuffer;
+
+	// No GL/DX interop
+	return GLEXT_SUPPORT_FBO | GLEXT_SUPPORT_FBO_BLIT | GLEXT_SUPPORT_SWAP | GLEXT_SUPPORT_PBO | GLEXT_SUPPORT_BGRA;
+}
+
+void spoutMockGL::Reset()
+{
+	Context();
+	spoutMockContext &gl = g_MockGL;
+	gl.textures.clear();
+	gl.framebuffers.clear();
+	gl.buffers.clear();
+	gl.nextName = 1;
+	gl.texture2D = 0;
+	gl.framebuffer = 0;
+	gl.packBuffer = gl.unpackBuffer = 0;
+	gl.packAlignment = gl.unpackAlignment = 4;
+	memset(gl.viewport, 0, sizeof(gl.viewport));
+	gl.swapInterval = 0;
+	ResetCounts();
+}
+
+void spoutMockGL::ResetCounts()
+{
+	Context();
+	memset(&g_MockGL.stats, 0, sizeof(g_MockGL.stats));
+	g_MockGL.calls.clear();
+}
+
+void spoutMockGL::SetLatency(const spoutMockGLLatency &latency)
+{
+	Context();
+	g_MockGL.latency = latency;
+}
+
+void spoutMockGL::GetLatency(spoutMockGLLatency &latency)
+{
+	latency = Context().latency;
+}
+
+void spoutMockGL::EndFrame()
+{
+	Context().stats.frames++;
+}
+
+void spoutMockGL::GetStats(spoutMockGLStats &stats)
+{
+	stats = Context().stats;
+}
+
+unsigned int spoutMockGL::GetCalls(const char *name)
+{
+	std::map<std::string, unsigned int>::iterator itr = Context().calls.find(name);
+	return itr != Context().calls.end() ? itr->second : 0;
+}
+
+void spoutMockGL::Print()
+{
+	spoutMockContext &gl = Context();
+	double frames = gl.stats.frames > 0 ? (double)gl.stats.frames : 1.0;
+
+	SPOUT_LOG_NOTICE("spoutMockGL : %u frames, %.1f calls, %.1f draws, %.2f stalls, %.0f bytes up, %.0f down, %.0f copied, %.1f us per frame",
+		gl.stats.frames, gl.stats.calls/frames, gl.stats.draws/frames, gl.stats.stalls/frames,
+		gl.stats.bytesUploaded/frames, gl.stats.bytesDownloaded/frames, gl.stats.bytesCopied/frames, gl.stats.simulatedUs/frames);
+
+	for(std::map<std::string, unsigned int>::iterator itr = gl.calls.begin(); itr != gl.calls.end(); itr++)
+		SPOUT_LOG_NOTICE("    %-28s %.1f", itr->first.c_str(), itr->second/frames);
+}
+
+bool spoutMockGL::GetTexturePixels(GLuint texture, unsigned int &width, unsigned int &height, const unsigned char **pixels)
+{
+	spoutMockTexture *pTexture = Texture(texture);
+	if(!pTexture)
+		return false;
+	width = pTexture->width;
+	height = pTexture->height;
+	*pixels = pTexture->pixels.empty() ? NULL : &pTexture->pixels[0];
+	return true;
+}
+
+//
+// Textures
+//
+
+void APIENTRY spoutMockGL::GenTextures(GLsizei n, GLuint *textures)
+{
+	Call("glGenTextures");
+	for(GLsizei i = 0; i < n; i++) {
+		textures[i] = Context().nextName++;
+		Context().textures[textures[i]].width = 0;
+		Context().textures[textures[i]].height = 0;
+	}
+}
+
+void APIENTRY spoutMockGL::DeleteTextures(GLsizei n, const GLuint *textures)
+{
+	Call("glDeleteTextures");
+	spoutMockContext &gl = Context();
+	for(GLsizei i = 0; i < n; i++) {
+		gl.textures.erase(textures[i]);
+		if(gl.texture2D == textures[i])
+			gl.texture2D = 0;
+	}
+}
+
+void APIENTRY spoutMockGL::BindTexture(GLenum target, GLuint texture)
+{
+	Call("glBindTexture");
+	if(target == GL_TEXTURE_2D)
+		Context().texture2D = texture;
+}
+
+void APIENTRY spoutMockGL::TexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels)
+{
+	Call("glTexImage2D");
+	spoutMockTexture *pTexture = Texture(Context().texture2D);
+	if(!pTexture || target != GL_TEXTURE_2D || level != 0)
+		return;
+
+	pTexture->width = width;
+	pTexture->height = height;
+	pTexture->pixels.assign((size_t)width*height*4, 0);
+
+	// Storage and upload in one go
+	if(pixels || Context().unpackBuffer)
+		WriteRect(*pTexture, 0, 0, width, height, format, type, pixels);
+}
+
+void APIENTRY spoutMockGL::TexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels)
+{
+	Call("glTexSubImage2D");
+	spoutMockTexture *pTexture = Texture(Context().texture2D);
+	if(!pTexture || target != GL_TEXTURE_2D || level != 0)
+		return;
+
+	WriteRect(*pTexture, xoffset, yoffset, width, height, format, type, pixels);
+}
+
+void APIENTRY spoutMockGL::GetTexImage(GLenum target, GLint level, GLenum format, GLenum type, GLvoid *pixels)
+{
+	Call("glGetTexImage");
+	spoutMockContext &gl = Context();
+	spoutMockTexture *pTexture = Texture(gl.texture2D);
+	if(!pTexture || target != GL_TEXTURE_2D || level != 0)
+		return;
+
+	size_t pitch = RowPitch(pTexture->width, format, type, gl.packAlignment);
+	unsigned char *dst = PixelData(gl.packBuffer, pixels, pitch*pTexture->height);
+	if(!dst)
+		return;
+
+	ReadRect(*pTexture, 0, 0, pTexture->width, pTexture->height, format, type, dst, pitch);
+
+	Download((size_t)pTexture->width*pTexture->height*PixelSize(format, type));
+	if(gl.packBuffer)
+		Buffer(gl.packBuffer)->readFrame = gl.stats.frames + 1;
+	else
+		Stall();
+}
+
+void APIENTRY spoutMockGL::CopyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	Call("glCopyTexSubImage2D");
+	spoutMockTexture *pSource = Attachment(true);
+	spoutMockTexture *pDest = Texture(Context().texture2D);
+	if(!pSource || !pDest || target != GL_TEXTURE_2D || level != 0)
+		return;
+
+	for(GLsizei row = 0; row < height; row++) {
+		int sy = y + row, dy = yoffset + row;
+		if(sy < 0 || sy >= (int)pSource->height || dy < 0 || dy >= (int)pDest->height) continue;
+		for(GLsizei column = 0; column < width; column++) {
+			int sx = x + column, dx = xoffset + column;
+			if(sx < 0 || sx >= (int)pSource->width || dx < 0 || dx >= (int)pDest->width) continue;
+			memcpy(&pDest->pixels[((size_t)dy*pDest->width + dx)*4], &pSource->pixels[((size_t)sy*pSource->width + sx)*4], 4);
+		}
+	}
+
+	Copy((size_t)width*height*4);
+}
+
+void APIENTRY spoutMockGL::TexParameteri(GLenum target, GLenum pname, GLint param)
+{
+	Call("glTexParameteri");
+}
+
+void APIENTRY spoutMockGL::TexParameterf(GLenum target, GLenum pname, GLfloat param)
+{
+	Call("glTexParameterf");
+}
+
+void APIENTRY spoutMockGL::PixelStorei(GLenum pname, GLint param)
+{
+	Call("glPixelStorei");
+	if(pname == GL_PACK_ALIGNMENT) Context().packAlignment = param;
+	if(pname == GL_UNPACK_ALIGNMENT) Context().unpackAlignment = param;
+}
+
+//
+// Framebuffers
+//
+
+void APIENTRY spoutMockGL::GenFramebuffers(GLsizei n, GLuint *framebuffers)
+{
+	Call("glGenFramebuffersEXT");
+	for(GLsizei i = 0; i < n; i++) {
+		framebuffers[i] = Context().nextName++;
+		spoutMockFramebuffer &fbo = Context().framebuffers[framebuffers[i]];
+		fbo.attachments[0] = fbo.attachments[1] = 0;
+		fbo.readBuffer = fbo.drawBuffer = GL_COLOR_ATTACHMENT0_EXT;
+	}
+}
+
+void APIENTRY spoutMockGL::DeleteFramebuffers(GLsizei n, const GLuint *framebuffers)
+{
+	Call("glDeleteFramebuffersEXT");
+	spoutMockContext &gl = Context();
+	for(GLsizei i = 0; i < n; i++) {
+		gl.framebuffers.erase(framebuffers[i]);
+		if(gl.framebuffer == framebuffers[i])
+			gl.framebuffer = 0;
+	}
+}
+
+void APIENTRY spoutMockGL::BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+	Call("glBindFramebufferEXT");
+	Context().framebuffer = framebuffer;
+}
+
+void APIENTRY spoutMockGL::FramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level)
+{
+	Call("glFramebufferTexture2DEXT");
+	spoutMockContext &gl = Context();
+	std::map<GLuint, spoutMockFramebuffer>::iterator itr = gl.framebuffers.find(gl.framebuffer);
+	if(itr != gl.framebuffers.end() && (attachment == GL_COLOR_ATTACHMENT0_EXT || attachment == GL_COLOR_ATTACHMENT1_EXT))
+		itr->second.attachments[attachment - GL_COLOR_ATTACHMENT0_EXT] = texture;
+}
+
+GLenum APIENTRY spoutMockGL::CheckFramebufferStatus(GLenum target)
+{
+	Call("glCheckFramebufferStatusEXT");
+	spoutMockContext &gl = Context();
+	std::map<GLuint, spoutMockFramebuffer>::iterator itr = gl.framebuffers.find(gl.framebuffer);
+	if(itr == gl.framebuffers.end())
+		return GL_FRAMEBUFFER_UNDEFINED_EXT;
+	if(!Texture(itr->second.attachments[0]) && !Texture(itr->second.attachments[1]))
+		return GL_FRAMEBUFFER_INCOMPLETE_MISSING_ATTACHMENT_EXT;
+	return GL_FRAMEBUFFER_COMPLETE_EXT;
+}
+
+void APIENTRY spoutMockGL::BlitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter)
+{
+	Call("glBlitFramebufferEXT");
+	spoutMockTexture *pSource = Attachment(true);
+	spoutMockTexture *pDest = Attachment(false);
+	if(!pSource || !pDest || srcX1 == srcX0 || srcY1 == srcY0)
+		return;
+
+	// Nearest sampling of the source rectangle for each destination pixel,
+	// reversed coordinates flip
+	int width = dstX1 > dstX0 ? dstX1 - dstX0 : dstX0 - dstX1;
+	int height = dstY1 > dstY0 ? dstY1 - dstY0 : dstY0 - dstY1;
+	for(int row = 0; row < height; row++) {
+		int dy = (dstY1 > dstY0 ? dstY0 + row : dstY0 - 1 - row);
+		int sy = srcY0 + (int)(((double)row + 0.5)*(srcY1 - srcY0)/height);
+		if(dy < 0 || dy >= (int)pDest->height || sy < 0 || sy >= (int)pSource->height) continue;
+		for(int column = 0; column < width; column++) {
+			int dx = (dstX1 > dstX0 ? dstX0 + column : dstX0 - 1 - column);
+			int sx = srcX0 + (int)(((double)column + 0.5)*(srcX1 - srcX0)/width);
+			if(dx < 0 || dx >= (int)pDest->width || sx < 0 || sx >= (int)pSource->width) continue;
+			memcpy(&pDest->pixels[((size_t)dy*pDest->width + dx)*4], &pSource->pixels[((size_t)sy*pSource->width + sx)*4], 4);
+		}
+	}
+
+	Copy((size_t)width*height*4);
+}
+
+void APIENTRY spoutMockGL::ReadBuffer(GLenum mode)
+{
+	Call("glReadBuffer");
+	spoutMockContext &gl = Context();
+	std::map<GLuint, spoutMockFramebuffer>::iterator itr = gl.framebuffers.find(gl.framebuffer);
+	if(itr != gl.framebuffers.end())
+		itr->second.readBuffer = mode;
+}
+
+void APIENTRY spoutMockGL::DrawBuffer(GLenum mode)
+{
+	Call("glDrawBuffer");
+	spoutMockContext &gl = Context();
+	std::map<GLuint, spoutMockFramebuffer>::iterator itr = gl.framebuffers.find(gl.framebuffer);
+	if(itr != gl.framebuffers.end())
+		itr->second.drawBuffer = mode;
+}
+
+void APIENTRY spoutMockGL::ReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid *pixels)
+{
+	Call("glReadPixels");
+	spoutMockContext &gl = Context();
+	spoutMockTexture *pSource = Attachment(true);
+	if(!pSource)
+		return;
+
+	size_t pitch = RowPitch(width, format, type, gl.packAlignment);
+	unsigned char *dst = PixelData(gl.packBuffer, pixels, pitch*height);
+	if(!dst)
+		return;
+
+	ReadRect(*pSource, x, y, width, height, format, type, dst, pitch);
+
+	Download((size_t)width*height*PixelSize(format, type));
+	if(gl.packBuffer)
+		Buffer(gl.packBuffer)->readFrame = gl.stats.frames + 1;
+	else
+		Stall();
+}
+
+//
+// Pixel buffers
+//
+
+void APIENTRY spoutMockGL::GenBuffers(GLsizei n, const GLuint *buffers)
+{
+	Call("glGenBuffers");
+	for(GLsizei i = 0; i < n; i++) {
+		GLuint name = Context().nextName++;
+		((GLuint *)buffers)[i] = name; // const in the loader prototype
+		spoutMockBuffer &buffer = Context().buffers[name];
+		buffer.mapped = false;
+		buffer.readFrame = buffer.uploadFrame = 0;
+	}
+}
+
+void APIENTRY spoutMockGL::DeleteBuffers(GLsizei n, const GLuint *buffers)
+{
+	Call("glDeleteBuffers");
+	spoutMockContext &gl = Context();
+	for(GLsizei i = 0; i < n; i++) {
+		gl.buffers.erase(buffers[i]);
+		if(gl.packBuffer == buffers[i]) gl.packBuffer = 0;
+		if(gl.unpackBuffer == buffers[i]) gl.unpackBuffer = 0;
+	}
+}
+
+void APIENTRY spoutMockGL::BindBuffer(GLenum target, const GLuint buffer)
+{
+	Call("glBindBuffer");
+	if(target == GL_PIXEL_PACK_BUFFER) Context().packBuffer = buffer;
+	if(target == GL_PIXEL_UNPACK_BUFFER) Context().unpackBuffer = buffer;
+}
+
+static spoutMockBuffer *BoundBuffer(GLenum target)
+{
+	if(target == GL_PIXEL_PACK_BUFFER) return Buffer(Context().packBuffer);
+	if(target == GL_PIXEL_UNPACK_BUFFER) return Buffer(Context().unpackBuffer);
+	return NULL;
+}
+
+void APIENTRY spoutMockGL::BufferData(GLenum target, GLsizeiptr size, const GLvoid *data, GLenum usage)
+{
+	Call("glBufferData");
+	spoutMockBuffer *pBuffer = BoundBuffer(target);
+	if(!pBuffer)
+		return;
+
+	// New storage, whatever the GPU still does with the old one
+	pBuffer->data.assign((size_t)size, 0);
+	pBuffer->readFrame = pBuffer->uploadFrame = 0;
+	if(data) {
+		memcpy(&pBuffer->data[0], data, (size_t)size);
+		Upload((size_t)size);
+	}
+}
+
+void * APIENTRY spoutMockGL::MapBuffer(GLenum target, GLenum access)
+{
+	Call("glMapBuffer");
+	spoutMockContext &gl = Context();
+	spoutMockBuffer *pBuffer = BoundBuffer(target);
+	if(!pBuffer || pBuffer->mapped || pBuffer->data.empty())
+		return NULL;
+
+	// Waits for a read back or an upload issued in this frame
+	if(pBuffer->readFrame == gl.stats.frames + 1 || pBuffer->uploadFrame == gl.stats.frames + 1)
+		Stall();
+	pBuffer->readFrame = 0;
+
+	pBuffer->mapped = true;
+	return &pBuffer->data[0];
+}
+
+void APIENTRY spoutMockGL::UnmapBuffer(GLenum target)
+{
+	Call("glUnmapBuffer");
+	spoutMockBuffer *pBuffer = BoundBuffer(target);
+	if(pBuffer)
+		pBuffer->mapped = false;
+}
+
+//
+// Queries
+//
+
+GLenum APIENTRY spoutMockGL::GetError()
+{
+	Call("glGetError");
+	return GL_NO_ERROR;
+}
+
+void APIENTRY spoutMockGL::GetIntegerv(GLenum pname, GLint *params)
+{
+	Call("glGetIntegerv");
+	spoutMockContext &gl = Context();
+	switch(pname) {
+		case GL_VIEWPORT:
+			memcpy(params, gl.viewport, sizeof(gl.viewport));
+			break;
+		case GL_FRAMEBUFFER_BINDING_EXT:
+			*params = (GLint)gl.framebuffer;
+			break;
+		case GL_TEXTURE_BINDING_2D:
+			*params = (GLint)gl.texture2D;
+			break;
+		case GL_PIXEL_PACK_BUFFER_BINDING:
+			*params = (GLint)gl.packBuffer;
+			break;
+		case GL_PIXEL_UNPACK_BUFFER_BINDING:
+			*params = (GLint)gl.unpackBuffer;
+			break;
+		default:
+			*params = 0;
+			break;
+	}
+}
+
+void APIENTRY spoutMockGL::GetFloatv(GLenum pname, GLfloat *params)
+{
+	Call("glGetFloatv");
+	if(pname == GL_VIEWPORT) {
+		for(int i = 0; i < 4; i++)
+			params[i] = (GLfloat)Context().viewport[i];
+	}
+	else {
+		*params = 0.0f;
+	}
+}
+
+//
+// Drawing and fixed function state
+//
+
+void APIENTRY spoutMockGL::DrawArrays(GLenum mode, GLint first, GLsizei count)
+{
+	Call("glDrawArrays");
+	Context().stats.draws++;
+}
+
+void APIENTRY spoutMockGL::Begin(GLenum mode)
+{
+	Call("glBegin");
+}
+
+void APIENTRY spoutMockGL::End()
+{
+	Call("glEnd");
+	Context().stats.draws++;
+}
+
+void APIENTRY spoutMockGL::Vertex2f(GLfloat x, GLfloat y) { Call("glVertex2f"); }
+void APIENTRY spoutMockGL::TexCoord2f(GLfloat s, GLfloat t) { Call("glTexCoord2f"); }
+void APIENTRY spoutMockGL::Color4f(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) { Call("glColor4f"); }
+void APIENTRY spoutMockGL::Enable(GLenum cap) { Call("glEnable"); }
+void APIENTRY spoutMockGL::Disable(GLenum cap) { Call("glDisable"); }
+void APIENTRY spoutMockGL::EnableClientState(GLenum array) { Call("glEnableClientState"); }
+void APIENTRY spoutMockGL::DisableClientState(GLenum array) { Call("glDisableClientState"); }
+void APIENTRY spoutMockGL::VertexPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer) { Call("glVertexPointer"); }
+void APIENTRY spoutMockGL::TexCoordPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer) { Call("glTexCoordPointer"); }
+void APIENTRY spoutMockGL::MatrixMode(GLenum mode) { Call("glMatrixMode"); }
+void APIENTRY spoutMockGL::PushMatrix() { Call("glPushMatrix"); }
+void APIENTRY spoutMockGL::PopMatrix() { Call("glPopMatrix"); }
+void APIENTRY spoutMockGL::LoadIdentity() { Call("glLoadIdentity"); }
+void APIENTRY spoutMockGL::Ortho(GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble zNear, GLdouble zFar) { Call("glOrtho"); }
+void APIENTRY spoutMockGL::PushAttrib(GLbitfield mask) { Call("glPushAttrib"); }
+void APIENTRY spoutMockGL::PopAttrib() { Call("glPopAttrib"); }
+void APIENTRY spoutMockGL::PushClientAttrib(GLbitfield mask) { Call("glPushClientAttrib"); }
+void APIENTRY spoutMockGL::PopClientAttrib() { Call("glPopClientAttrib"); }
+
+void APIENTRY spoutMockGL::Viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+	Call("glViewport");
+	GLint viewport[4] = { x, y, width, height };
+	memcpy(Context().viewport, viewport, sizeof(viewport));
+}
+
+//
+// wgl swap control
+//
+
+BOOL WINAPI spoutMockGL::SwapInterval(int interval)
+{
+	Call("wglSwapIntervalEXT");
+	Context().swapInterval = interval;
+	return TRUE;
+}
+
+int WINAPI spoutMockGL::GetSwapInterval()
+{
+	Call("wglGetSwapIntervalEXT");
+	return Context().swapInterval;
+}
+
+#endif // USE_MOCK_GL
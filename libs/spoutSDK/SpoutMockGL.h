@@ -0,0 +1,222 @@
+/*
+
+	spoutMockGL.h
+
+	Recording OpenGL for testing and benchmarking the Spout OpenGL paths
+	without a GPU.
+
+	Build with USE_MOCK_GL defined (see spoutGLextensions.h) and the
+	extension loader installs the functions of this class instead of the
+	driver ones. The OpenGL 1.1 functions used by the SDK, which are not
+	loaded, are redirected to it by macros.
+
+	Textures, framebuffers and pixel buffers live in host memory: uploads,
+	read backs, copies, blits and pixel buffer map / unmap move real pixels,
+	so WriteMemory, ReadMemory and the pixel buffer ring can be checked for
+	content as well as for calls. Draw calls are counted, not rasterized.
+	The GL/DX interop extensions are not provided, the SDK runs in memory
+	or CPU share mode.
+
+	Every call is counted by name, with the bytes moved each way. Latency
+	is modelled, not slept: each call, transfer and synchronous read back
+	adds to a simulated time. Mapping a pack buffer filled in the same
+	frame counts as a stall, one filled before the last EndFrame() doesn't.
+
+	One OpenGL "context" for the process, use it from one thread.
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#pragma once
+
+#ifndef __spoutMockGL__
+#define __spoutMockGL__
+
+#ifdef USE_MOCK_GL
+
+#include "SpoutCommon.h"
+#include "SpoutGLextensions.h"
+
+#if defined(USE_GLEW) || !defined(USE_FBO_EXTENSIONS) || !defined(USE_PBO_EXTENSIONS)
+#error USE_MOCK_GL replaces the FBO and PBO extensions loaded by spoutGLextensions
+#endif
+
+// Costs of the simulated driver, in microseconds and MB/s (bytes per microsecond)
+struct spoutMockGLLatency {
+	double callUs;			// every call
+	double uploadMBps;		// client memory or pixel buffer to texture
+	double downloadMBps;	// texture or framebuffer to client memory or pixel buffer
+	double copyMBps;		// texture to texture
+	double stallUs;			// waiting for the GPU on a synchronous read back
+};
+
+struct spoutMockGLStats {
+	unsigned int frames;	// EndFrame calls
+	unsigned int calls;
+	unsigned int draws;
+	unsigned int stalls;
+	unsigned long long bytesUploaded;
+	unsigned long long bytesDownloaded;
+	unsigned long long bytesCopied;
+	double simulatedUs;
+};
+
+class SPOUT_DLLEXP spoutMockGL {
+
+	public:
+
+		// Set the extension function pointers, returns the GLEXT_SUPPORT flags
+		static unsigned int Install();
+
+		// Delete all the objects and clear the counts
+		static void Reset();
+		static void ResetCounts();
+
+		static void SetLatency(const spoutMockGLLatency &latency);
+		static void GetLatency(spoutMockGLLatency &latency);
+
+		// Frame boundary for the stall model and the per frame counts
+		static void EndFrame();
+
+		static void GetStats(spoutMockGLStats &stats);
+		static unsigned int GetCalls(const char *name); // e.g. "glGetTexImage"
+
+		// Log the counts per frame
+		static void Print();
+
+		// Content of a texture, RGBA rows from the bottom
+		static bool GetTexturePixels(GLuint texture, unsigned int &width, unsigned int &height, const unsigned char **pixels);
+
+		// Textures
+		static void APIENTRY GenTextures(GLsizei n, GLuint *textures);
+		static void APIENTRY DeleteTextures(GLsizei n, const GLuint *textures);
+		static void APIENTRY BindTexture(GLenum target, GLuint texture);
+		static void APIENTRY TexImage2D(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels);
+		static void APIENTRY TexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLsizei width, GLsizei height, GLenum format, GLenum type, const GLvoid *pixels);
+		static void APIENTRY GetTexImage(GLenum target, GLint level, GLenum format, GLenum type, GLvoid *pixels);
+		static void APIENTRY CopyTexSubImage2D(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint x, GLint y, GLsizei width, GLsizei height);
+		static void APIENTRY TexParameteri(GLenum target, GLenum pname, GLint param);
+		static void APIENTRY TexParameterf(GLenum target, GLenum pname, GLfloat param);
+		static void APIENTRY PixelStorei(GLenum pname, GLint param);
+
+		// Framebuffers
+		static void APIENTRY GenFramebuffers(GLsizei n, GLuint *framebuffers);
+		static void APIENTRY DeleteFramebuffers(GLsizei n, const GLuint *framebuffers);
+		static void APIENTRY BindFramebuffer(GLenum target, GLuint framebuffer);
+		static void APIENTRY FramebufferTexture2D(GLenum target, GLenum attachment, GLenum textarget, GLuint texture, GLint level);
+		static GLenum APIENTRY CheckFramebufferStatus(GLenum target);
+		static void APIENTRY BlitFramebuffer(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter);
+		static void APIENTRY ReadBuffer(GLenum mode);
+		static void APIENTRY DrawBuffer(GLenum mode);
+		static void APIENTRY ReadPixels(GLint x, GLint y, GLsizei width, GLsizei height, GLenum format, GLenum type, GLvoid *pixels);
+
+		// Pixel buffers
+		static void APIENTRY GenBuffers(GLsizei n, const GLuint *buffers);
+		static void APIENTRY DeleteBuffers(GLsizei n, const GLuint *buffers);
+		static void APIENTRY BindBuffer(GLenum target, const GLuint buffer);
+		static void APIENTRY BufferData(GLenum target, GLsizeiptr size, const GLvoid *data, GLenum usage);
+		static void * APIENTRY MapBuffer(GLenum target, GLenum access);
+		static void APIENTRY UnmapBuffer(GLenum target);
+
+		// Queries
+		static GLenum APIENTRY GetError();
+		static void APIENTRY GetIntegerv(GLenum pname, GLint *params);
+		static void APIENTRY GetFloatv(GLenum pname, GLfloat *params);
+
+		// Drawing and fixed function state, counted only
+		static void APIENTRY DrawArrays(GLenum mode, GLint first, GLsizei count);
+		static void APIENTRY Begin(GLenum mode);
+		static void APIENTRY End();
+		static void APIENTRY Vertex2f(GLfloat x, GLfloat y);
+		static void APIENTRY TexCoord2f(GLfloat s, GLfloat t);
+		static void APIENTRY Color4f(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+		static void APIENTRY Enable(GLenum cap);
+		static void APIENTRY Disable(GLenum cap);
+		static void APIENTRY EnableClientState(GLenum array);
+		static void APIENTRY DisableClientState(GLenum array);
+		static void APIENTRY VertexPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer);
+		static void APIENTRY TexCoordPointer(GLint size, GLenum type, GLsizei stride, const GLvoid *pointer);
+		static void APIENTRY MatrixMode(GLenum mode);
+		static void APIENTRY PushMatrix();
+		static void APIENTRY PopMatrix();
+		static void APIENTRY LoadIdentity();
+		static void APIENTRY Ortho(GLdouble left, GLdouble right, GLdouble bottom, GLdouble top, GLdouble zNear, GLdouble zFar);
+		static void APIENTRY Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+		static void APIENTRY PushAttrib(GLbitfield mask);
+		static void APIENTRY PopAttrib();
+		static void APIENTRY PushClientAttrib(GLbitfield mask);
+		static void APIENTRY PopClientAttrib();
+
+		// wgl swap control
+		static BOOL WINAPI SwapInterval(int interval);
+		static int WINAPI GetSwapInterval();
+
+};
+
+// OpenGL 1.1 functions are linked, not loaded
+#define glGenTextures		spoutMockGL::GenTextures
+#define glDeleteTextures	spoutMockGL::DeleteTextures
+#define glBindTexture		spoutMockGL::BindTexture
+#define glTexImage2D		spoutMockGL::TexImage2D
+#define glTexSubImage2D		spoutMockGL::TexSubImage2D
+#define glGetTexImage		spoutMockGL::GetTexImage
+#define glCopyTexSubImage2D	spoutMockGL::CopyTexSubImage2D
+#define glTexParameteri		spoutMockGL::TexParameteri
+#define glTexParameterf		spoutMockGL::TexParameterf
+#define glPixelStorei		spoutMockGL::PixelStorei
+#define glReadBuffer		spoutMockGL::ReadBuffer
+#define glDrawBuffer		spoutMockGL::DrawBuffer
+#define glReadPixels		spoutMockGL::ReadPixels
+#define glGetError			spoutMockGL::GetError
+#define glGetIntegerv		spoutMockGL::GetIntegerv
+#define glGetFloatv			spoutMockGL::GetFloatv
+#define glDrawArrays		spoutMockGL::DrawArrays
+#define glBegin				spoutMockGL::Begin
+#define glEnd				spoutMockGL::End
+#define glVertex2f			spoutMockGL::Vertex2f
+#define glTexCoord2f		spoutMockGL::TexCoord2f
+#define glColor4f			spoutMockGL::Color4f
+#define glEnable			spoutMockGL::Enable
+#define glDisable			spoutMockGL::Disable
+#define glEnableClientState	spoutMockGL::EnableClientState
+#define glDisableClientState spoutMockGL::DisableClientState
+#define glVertexPointer		spoutMockGL::VertexPointer
+#define glTexCoordPointer	spoutMockGL::TexCoordPointer
+#define glMatrixMode		spoutMockGL::MatrixMode
+#define glPushMatrix		spoutMockGL::PushMatrix
+#define glPopMatrix			spoutMockGL::PopMatrix
+#define glLoadIdentity		spoutMockGL::LoadIdentity
+#define glOrtho				spoutMockGL::Ortho
+#define glViewport			spoutMockGL::Viewport
+#define glPushAttrib		spoutMockGL::PushAttrib
+#define glPopAttrib			spoutMockGL::PopAttrib
+#define glPushClientAttrib	spoutMockGL::PushClientAttrib
+#define glPopClientAttrib	spoutMockGL::PopClientAttrib
+
+#endif // USE_MOCK_GL
+
+#endif
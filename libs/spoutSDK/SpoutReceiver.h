@@ -53,6 +53,8 @@ class SPOUT_DLLEXP SpoutReceiver {
 	int  GetSenderCount();
 	bool GetSenderName(int index, char* Sendername, int MaxSize = 256);
 	bool GetSenderInfo(const char* Sendername, unsigned int &width, unsigned int &height, HANDLE &dxShareHandle, DWORD &dwFormat);
+	DWORD GetSenderFormat(); // DXGI format of the connected sender
+	bool GetSenderFormats(const char* Sendername, DWORD &dwFormats); // formats the sender supports, see spoutFormat.h
 
 	bool GetActiveSender(char* Sendername);
 	bool SetActiveSender(const char* Sendername);
@@ -63,6 +65,7 @@ class SPOUT_DLLEXP SpoutReceiver {
 	bool GetDX9();
 	bool SetMemoryShareMode(bool bMem = true);
 	bool GetMemoryShareMode();
+	void ForceMemoryShare(bool bForce = true); // this receiver only, the registry is not written
 	bool SetCPUmode(bool bCPU = true);
 	bool GetCPUmode();
 	int  GetShareMode();
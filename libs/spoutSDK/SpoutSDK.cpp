@@ -109,6 +109,11 @@
 //					  https://github.com/leadedge/Spout2/issues/24
 //					  temporary changes to allow selection of a sender 
 //					  when a name is provided for CreateReceiver
+//		19.10.26	- CheckReceiver uses the once per frame sender check of the
+//					  spoutSharedContext when one is alive
+//		19.10.26	- memoryshare sender in packed 10 bit for an RGB10A2 format
+//					- Added GetSenderFormat, SetSenderFormats, GetSenderFormats
+//		19.10.26	- Added ForceMemoryShare
 //
 // ================================================================
 /*
@@ -135,6 +140,7 @@
 		OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 #include "SpoutSDK.h"
+#include "SpoutSharedContext.h"
 
 
 Spout::Spout()
@@ -210,6 +216,10 @@ bool Spout::CreateSender(const char* sendername, unsigned int width, unsigned in
 	// Set global sender name - TODO : check when
 	strcpy_s(g_SharedMemoryName, 256, sendername);
 
+	// Receivers in this process must see the new sender straight away
+	spoutSharedContext* pContext = spoutSharedContext::Get();
+	if(pContext) pContext->InvalidateSenders();
+
 	// Initialize as a sender in either texture, cpu or memoryshare mode
 	return(InitSender(g_hWnd, sendername, width, height, dwFormat, bMemory));
 
@@ -257,6 +267,9 @@ bool Spout::UpdateSender(const char *sendername, unsigned int width, unsigned in
 		//
 		interop.senders.GetSenderInfo(g_SharedMemoryName, g_Width, g_Height, g_ShareHandle, g_Format);
 
+		spoutSharedContext* pContext = spoutSharedContext::Get();
+		if(pContext) pContext->InvalidateSenders();
+
 		return true;
 	}
 
@@ -271,6 +284,9 @@ void Spout::ReleaseSender(DWORD dwMsec)
 	if(g_SharedMemoryName[0] > 0)
 		interop.senders.ReleaseSenderName(g_SharedMemoryName); // if not registered it does not matter
 
+	spoutSharedContext* pContext = spoutSharedContext::Get();
+	if(pContext) pContext->InvalidateSenders();
+
 	SpoutCleanUp();
 	bInitialized = false; // TODO - needs tracing
 	bIsSending = false;
@@ -547,7 +563,12 @@ bool Spout::CheckReceiver(char* name, unsigned int &width, unsigned int &height,
 	dwFormat = g_Format;
 
 	// Is the sender there ?
-	if(interop.senders.CheckSender(newname, newWidth, newHeight, hShareHandle, dwFormat)) {
+	// With a shared context the check is made once per host frame for all receivers
+	spoutSharedContext* pContext = spoutSharedContext::Get();
+	bool bSenderFound = pContext
+		? pContext->CheckSender(interop.senders, newname, newWidth, newHeight, hShareHandle, dwFormat)
+		: interop.senders.CheckSender(newname, newWidth, newHeight, hShareHandle, dwFormat);
+	if(bSenderFound) {
 		// The sender exists, but has the width, height, texture format changed from those passed in
 		if(newWidth > 0 && newHeight > 0) {
 			if(newWidth  != width
@@ -691,6 +712,14 @@ bool Spout::SetMemoryShareMode(bool bMem)
 	return (interop.SetMemoryShareMode(bMem));
 }
 
+//---------------------------------------------------------
+void Spout::ForceMemoryShare(bool bForce)
+{
+	interop.ForceMemoryShare(bForce);
+	// Picked up by OpenSpout for the next sender or receiver
+	bMemory = interop.GetMemoryShareMode();
+}
+
 //---------------------------------------------------------
 bool Spout::GetMemoryShareMode()
 {
@@ -992,6 +1021,25 @@ bool Spout::GetSenderInfo(const char* sendername, unsigned int &width, unsigned
 	return interop.senders.GetSenderInfo(sendername, width, height, dxShareHandle, dwFormat);
 }
 
+// Format of the sender the receiver is connected to, as last checked by ReceiveTexture
+DWORD Spout::GetSenderFormat()
+{
+	return g_Format;
+}
+
+// Publish the formats this sender supports, see spoutFormat.h
+bool Spout::SetSenderFormats(DWORD dwFormats)
+{
+	if(!bInitialized || !bIsSending)
+		return false;
+	return interop.senders.SetSenderFormats(g_SharedMemoryName, dwFormats);
+}
+
+bool Spout::GetSenderFormats(const char* sendername, DWORD &dwFormats)
+{
+	return interop.senders.GetSenderFormats(sendername, dwFormats);
+}
+
 
 
 int Spout::GetVerticalSync()
@@ -1216,6 +1264,13 @@ bool Spout::InitSender (HWND hwnd, const char* theSendername,
 		// Now we have created the DirectX device so create an empty texture
 		interop.m_dxShareHandle = NULL; // A sender creates a new texture with a new share handle
 		DWORD dwFormat = 0;
+
+		// The memory holds rgba bytes, or packed 10 bit for a 10 bit format.
+		// The format of the sender information tells the receivers which.
+		DWORD dxFormat = DXGI_FORMAT_B8G8R8A8_UNORM;
+		if(spoutFormat::FromDXGIFormat(theFormat) == SPOUT_FORMAT_RGB10A2)
+			dxFormat = spoutFormat::GetDXGIFormat(SPOUT_FORMAT_RGB10A2);
+
 		if(interop.GetDX9()) {
 			dwFormat = (DWORD)D3DFMT_A8R8G8B8;
 			if(!interop.spoutdx.CreateSharedDX9Texture(interop.m_pDevice,
@@ -1228,10 +1283,10 @@ bool Spout::InitSender (HWND hwnd, const char* theSendername,
 			}
 		}
 		else {
-			dwFormat = (DWORD)DXGI_FORMAT_B8G8R8A8_UNORM;
+			dwFormat = dxFormat;
 			if(!interop.spoutdx.CreateSharedDX11Texture(interop.g_pd3dDevice,
 														theWidth, theHeight, 
-														DXGI_FORMAT_B8G8R8A8_UNORM,
+														(DXGI_FORMAT)dxFormat,
 														&interop.g_pSharedTexture,
 														interop.m_dxShareHandle)) {
 				return false;
@@ -1246,6 +1301,8 @@ bool Spout::InitSender (HWND hwnd, const char* theSendername,
 
 		if(!interop.memoryshare.CreateSenderMemory(sendername, theWidth, theHeight))
 			return false;
+
+		interop.SetMemoryFormat(dwFormat);
 		
 		bDxInitOK = false;
 		bMemory = true;
@@ -1328,6 +1385,8 @@ bool Spout::InitReceiver (HWND hwnd, char* theSendername, unsigned int theWidth,
 		if(!interop.memoryshare.CreateSenderMemory(sendername, width, height))
 			return false;
 
+		interop.SetMemoryFormat(format);
+
 		bDxInitOK = false;
 	}
 
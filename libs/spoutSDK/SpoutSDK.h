@@ -52,6 +52,7 @@
 #include "spoutMemoryShare.h"
 #include "SpoutSenderNames.h"
 #include "SpoutGLDXinterop.h"
+#include "SpoutFormat.h"
 
 // Compile flag only - not currently used
 #if defined(__x86_64__) || defined(_M_X64)
@@ -97,6 +98,9 @@ class SPOUT_DLLEXP Spout {
 	int  GetSenderCount ();
 	bool GetSenderName  (int index, char* sendername, int MaxSize = 256);
 	bool GetSenderInfo  (const char* sendername, unsigned int &width, unsigned int &height, HANDLE &dxShareHandle, DWORD &dwFormat);
+	DWORD GetSenderFormat(); // DXGI format of the connected sender
+	bool SetSenderFormats(DWORD dwFormats); // formats supported by this sender, see spoutFormat.h
+	bool GetSenderFormats(const char* sendername, DWORD &dwFormats);
 	bool GetActiveSender(char* Sendername);
 	bool SetActiveSender(const char* Sendername);
 	
@@ -105,6 +109,7 @@ class SPOUT_DLLEXP Spout {
 	bool GetDX9(); // Return the flag that has been set
 	bool SetMemoryShareMode(bool bMem = true);
 	bool GetMemoryShareMode();
+	void ForceMemoryShare(bool bForce = true); // this object only, the registry is not written
 	bool SetCPUmode(bool bCPU = true);
 	bool GetCPUmode();
 	int  GetShareMode();
@@ -24,6 +24,8 @@
 //		17.09.16	- removed CheckSpout2004() from constructor
 //		13.01.17	- Add SetCPUmode, GetCPUmode, SetBufferMode, GetBufferMode
 //		15.01.17	- Add GetShareMode, SetShareMode
+//		19.10.26	- Add SetSenderFormats
+//		19.10.26	- Add ForceMemoryShare
 //
 // ====================================================================================
 /*
@@ -122,6 +124,20 @@ bool SpoutSender::SetMemoryShareMode(bool bMem)
 }
 
 
+//---------------------------------------------------------
+void SpoutSender::ForceMemoryShare(bool bForce)
+{
+	spout.ForceMemoryShare(bForce);
+}
+
+
+//---------------------------------------------------------
+bool SpoutSender::SetSenderFormats(DWORD dwFormats)
+{
+	return spout.SetSenderFormats(dwFormats);
+}
+
+
 //---------------------------------------------------------
 bool SpoutSender::GetMemoryShareMode()
 {
@@ -12,6 +12,7 @@
 
 	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 	21.08.15 - started class file
+	19.10.26 - messages through spoutLog instead of printf
 
 	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 	Copyright (c) 2014-2015, Lynn Jarvis. All rights reserved.
@@ -39,6 +40,7 @@
 
 */
 #include "spoutSenderMemory.h"
+#include "SpoutLog.h"
 #include <assert.h>
 
 spoutSenderMemory::spoutSenderMemory() {
@@ -60,7 +62,7 @@ bool spoutSenderMemory::GetImageSizeFromSharedMemory(const char* sendername, uns
 
 	char *pBuf = senderMem->Lock();
 	if (!pBuf) {
-		printf("senderMem lock failed\n");
+		SPOUT_LOG_WARNING("senderMem lock failed");
 		return false;
 	}
 
@@ -94,7 +96,7 @@ bool spoutSenderMemory::CreateSenderMemory(const char *sendername, unsigned int
 
 	// Create a name for the map from the sendr name
 	namestring += "_map";
-	printf("CreateSenderMemory : %s (%dx%d) %d\n", namestring.c_str(), width, height, (width*height*4)+8);
+	SPOUT_LOG_NOTICE("CreateSenderMemory : %s (%dx%d) %d", namestring.c_str(), width, height, (width*height*4)+8);
 
 	// Create a new shared memory class object for this sender
 	senderMem = new SpoutSharedMemory();
@@ -103,7 +105,7 @@ bool spoutSenderMemory::CreateSenderMemory(const char *sendername, unsigned int
 	// Allocate enough width, height and RGBA image
 	SpoutCreateResult result = senderMem->Create(namestring.c_str(), (width*height*4)+8 );
 	if(result == SPOUT_CREATE_FAILED) {
-		printf("CreateSenderMemory : failed\n");
+		SPOUT_LOG_ERROR("CreateSenderMemory : failed");
 		delete senderMem;
 		return false;
 	}
@@ -157,7 +159,7 @@ bool spoutSenderMemory::SetSenderMemory(const char* sendername, unsigned int wid
 
 	char *pBuf = senderMem->Lock();
 	if (!pBuf) {
-		printf("SetSenderMemory : buffer not found\n");
+		SPOUT_LOG_WARNING("SetSenderMemory : buffer not found");
 		return false;
 	}
 
@@ -199,7 +201,7 @@ bool spoutSenderMemory::GetSenderMemory(const char* sendername, unsigned int &wi
 
 	char *pBuf = senderMem->Lock();
 	if (!pBuf) {
-		printf("spoutSenderMemory::GetSenderMemory - error 2\n");
+		SPOUT_LOG_WARNING("spoutSenderMemory::GetSenderMemory - error 2");
 		return false;
 	}
 
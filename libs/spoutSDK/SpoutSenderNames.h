@@ -107,6 +107,10 @@ class SPOUT_DLLEXP spoutSenderNames {
 		bool GetSenderInfo (const char* sendername, unsigned int &width, unsigned int &height, HANDLE &dxShareHandle, DWORD &dwFormat);
 		bool SetSenderInfo (const char* sendername, unsigned int width, unsigned int height, HANDLE dxShareHandle, DWORD dwFormat);
 
+		// Formats a sender supports, in the usage field (see spoutFormat.h)
+		bool SetSenderFormats (const char* sendername, DWORD dwFormats);
+		bool GetSenderFormats (const char* sendername, DWORD &dwFormats);
+
 		// Generic sender map info retrieval
 		bool getSharedInfo (const char* SenderName, SharedTextureInfo* info);
 		bool setSharedInfo (const char* SenderName, SharedTextureInfo* info);
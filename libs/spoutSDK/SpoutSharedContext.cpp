@@ -0,0 +1,277 @@
+/*
+
+	spoutSharedContext.cpp
+
+	Process wide state shared by all the Spout objects of a host process.
+	See spoutSharedContext.h
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "SpoutSharedContext.h"
+#include "SpoutDirectX.h"
+#include "SpoutSenderNames.h"
+#include "SpoutGLextensions.h"
+
+#include <assert.h>
+#include <mutex>
+
+static std::mutex g_SharedContextMutex;
+static spoutSharedContext* g_pSharedContext = NULL;
+static int g_SharedContextRefCount = 0;
+static DWORD g_SharedContextThread = 0; // owner, the thread of the first Acquire
+
+spoutSharedContext* spoutSharedContext::Acquire()
+{
+	std::lock_guard<std::mutex> lock(g_SharedContextMutex);
+
+	if(g_SharedContextRefCount == 0) {
+		g_pSharedContext = new spoutSharedContext();
+		g_SharedContextThread = GetCurrentThreadId();
+	}
+	// The maps of the context are not locked
+	assert(g_SharedContextThread == GetCurrentThreadId());
+	g_SharedContextRefCount++;
+
+	return g_pSharedContext;
+}
+
+void spoutSharedContext::Release()
+{
+	std::lock_guard<std::mutex> lock(g_SharedContextMutex);
+
+	if(g_SharedContextRefCount == 0)
+		return;
+
+	g_SharedContextRefCount--;
+	if(g_SharedContextRefCount == 0) {
+		delete g_pSharedContext;
+		g_pSharedContext = NULL;
+		g_SharedContextThread = 0;
+	}
+}
+
+spoutSharedContext* spoutSharedContext::Get()
+{
+	std::lock_guard<std::mutex> lock(g_SharedContextMutex);
+
+	// Objects of other threads do without the context
+	if(g_SharedContextThread != GetCurrentThreadId())
+		return NULL;
+
+	return g_pSharedContext;
+}
+
+
+spoutSharedContext::spoutSharedContext()
+{
+	m_pd3dDevice = NULL;
+	m_frame = 0;
+
+	m_pSenders = new spoutSenderNames;
+	m_bSenderSetValid = false;
+	m_senderSetFrame = 0;
+}
+
+spoutSharedContext::~spoutSharedContext()
+{
+	// Interop devices can only be closed with their OpenGL context current.
+	// As for spoutGLDXinterop::CleanupInterop, the others are left to the driver.
+	HGLRC ctx = wglGetCurrentContext();
+	for (auto itr = m_interopDevices.begin(); itr != m_interopDevices.end(); itr++) {
+		if(itr->first == ctx && itr->second != NULL && wglDXCloseDeviceNV)
+			wglDXCloseDeviceNV(itr->second);
+	}
+	m_interopDevices.clear();
+
+	delete m_pSenders;
+
+	// Every interop object holds its own reference to the device
+	if(m_pd3dDevice != NULL) {
+		m_pd3dDevice->Release();
+		m_pd3dDevice = NULL;
+	}
+}
+
+
+//
+// =========================== DirectX ================================
+//
+
+ID3D11Device* spoutSharedContext::GetDX11device(spoutDirectX &spoutdx)
+{
+	if(m_pd3dDevice == NULL)
+		m_pd3dDevice = spoutdx.CreateDX11device();
+
+	if(m_pd3dDevice != NULL)
+		m_pd3dDevice->AddRef();
+
+	return m_pd3dDevice;
+}
+
+HANDLE spoutSharedContext::GetInteropDevice(ID3D11Device* pDevice)
+{
+	// Only the shared device is managed here
+	if(pDevice == NULL || pDevice != m_pd3dDevice)
+		return NULL;
+
+	HGLRC ctx = wglGetCurrentContext();
+	if(ctx == NULL || !wglDXOpenDeviceNV)
+		return NULL;
+
+	auto itr = m_interopDevices.find(ctx);
+	if(itr != m_interopDevices.end())
+		return itr->second;
+
+	HANDLE hInteropDevice = wglDXOpenDeviceNV(pDevice);
+	if(hInteropDevice != NULL)
+		m_interopDevices[ctx] = hInteropDevice;
+
+	return hInteropDevice;
+}
+
+
+//
+// =========================== Registry ================================
+//
+
+bool spoutSharedContext::ReadDwordSetting(const char *subkey, const char *valuename, DWORD &dwValue, bool &bFound)
+{
+	// Without frame tracking there is nothing to tell when the cache is stale
+	if(m_userFrames.empty())
+		return false;
+
+	std::string key = std::string(subkey) + "\\" + valuename;
+
+	// Read again once per frame, another process may have changed the value
+	auto itr = m_settings.find(key);
+	if(itr == m_settings.end() || itr->second.frame != m_frame)
+		return false;
+
+	bFound = itr->second.bFound;
+	dwValue = itr->second.dwValue;
+
+	return true;
+}
+
+void spoutSharedContext::StoreDwordSetting(const char *subkey, const char *valuename, DWORD dwValue, bool bFound)
+{
+	DwordSetting setting;
+	setting.frame = m_frame;
+	setting.bFound = bFound;
+	setting.dwValue = dwValue;
+
+	m_settings[std::string(subkey) + "\\" + valuename] = setting;
+}
+
+
+//
+// =========================== Frames ================================
+//
+
+void spoutSharedContext::BeginFrame(const void* user)
+{
+	auto itr = m_userFrames.find(user);
+	if(itr != m_userFrames.end() && itr->second == m_frame) {
+		// This user already rendered in the current frame
+		m_frame++;
+	}
+
+	m_userFrames[user] = m_frame;
+
+	UpdateSenderSet();
+}
+
+void spoutSharedContext::EndUser(const void* user)
+{
+	m_userFrames.erase(user);
+}
+
+unsigned int spoutSharedContext::GetFrame()
+{
+	return m_frame;
+}
+
+
+//
+// =========================== Senders ================================
+//
+
+bool spoutSharedContext::CheckSender(spoutSenderNames &senders, const char *sendername, unsigned int &width, unsigned int &height, HANDLE &hSharehandle, DWORD &dwFormat)
+{
+	// Without frame tracking there is nothing to tell when the cache is stale
+	if(m_userFrames.empty())
+		return senders.CheckSender(sendername, width, height, hSharehandle, dwFormat);
+
+	// Senders that are not registered are answered from the set,
+	// without opening their shared memory
+	UpdateSenderSet();
+	if(m_bSenderSetValid && m_senderSet.find(sendername) == m_senderSet.end()) {
+		width = 0;
+		height = 0;
+		return false;
+	}
+
+	auto itr = m_senderChecks.find(sendername);
+	bool bRefresh = (itr == m_senderChecks.end() || itr->second.frame != m_frame);
+	if(itr == m_senderChecks.end())
+		itr = m_senderChecks.insert(std::make_pair(std::string(sendername), SenderCheck())).first;
+
+	SenderCheck &check = itr->second;
+	if(bRefresh) {
+		check.frame = m_frame;
+		check.hSharehandle = hSharehandle;
+		check.dwFormat = dwFormat;
+		check.bFound = senders.CheckSender(sendername, check.width, check.height, check.hSharehandle, check.dwFormat);
+	}
+
+	width = check.width;
+	height = check.height;
+	if(check.bFound) {
+		hSharehandle = check.hSharehandle;
+		dwFormat = check.dwFormat;
+	}
+
+	return check.bFound;
+}
+
+void spoutSharedContext::InvalidateSenders()
+{
+	m_senderChecks.clear();
+	m_bSenderSetValid = false;
+}
+
+// One read of the sender name set per frame
+void spoutSharedContext::UpdateSenderSet()
+{
+	if(m_bSenderSetValid && m_senderSetFrame == m_frame)
+		return;
+
+	m_senderSet.clear();
+	m_bSenderSetValid = m_pSenders->GetSenderNames(&m_senderSet);
+	m_senderSetFrame = m_frame;
+}
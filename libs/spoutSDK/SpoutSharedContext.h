@@ -0,0 +1,170 @@
+/*
+
+	spoutSharedContext.h
+
+	Process wide state shared by all the Spout objects of a host process.
+
+	A host loading many instances of a plugin ends up with one Spout object
+	per sender and per receiver, each opening its own DirectX 11 device and
+	GL/DX interop device and reading the same registry settings and sender
+	information over and over. While a shared context is alive :
+
+	- a single DirectX 11 device is used by every spoutGLDXinterop object
+	- a single GL/DX interop device is opened for each OpenGL context
+	- Spout registry settings are read at most once per host frame
+	- the sender name set is read once per host frame; receivers waiting for
+	  a sender that is not in it are answered from the set, and sender
+	  information is read at most once per frame for each name that is
+
+	Shared textures, PBOs, fbos and sender registrations stay per object.
+
+	The context is reference counted. Hold a spoutSharedContextRef for as long
+	as Spout objects should use it, typically a member declared before the
+	SpoutSender and SpoutReceiver members of a plugin instance.
+	The context is not locked: it belongs to the thread of the first Acquire,
+	the host render thread, and every reference must be taken and used there
+	(asserted in debug builds). Get returns NULL on any other thread, so Spout
+	objects running elsewhere, e.g. on a worker thread, go without it.
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#pragma once
+
+#ifndef __spoutSharedContext__
+#define __spoutSharedContext__
+
+#include "SpoutCommon.h"
+#include <windowsx.h>
+#include <d3d11.h>
+#include <string>
+#include <set>
+#include <unordered_map>
+
+class spoutDirectX;
+class spoutSenderNames;
+
+class SPOUT_DLLEXP spoutSharedContext {
+
+	public:
+
+		// Reference counting, the first Acquire creates the context
+		// and the last Release destroys it
+		static spoutSharedContext* Acquire();
+		static void Release();
+
+		// The context if one is alive and the calling thread owns it, NULL otherwise
+		static spoutSharedContext* Get();
+
+		// Shared DirectX 11 device, created on first use with the adapter
+		// selected in spoutdx. A reference is added for the caller.
+		ID3D11Device* GetDX11device(spoutDirectX &spoutdx);
+
+		// GL/DX interop device for the current OpenGL context and the
+		// shared DirectX 11 device. Owned by the context, do not close it.
+		HANDLE GetInteropDevice(ID3D11Device* pDevice);
+
+		// Registry DWORD values cached for the current frame. Without frame
+		// tracking nothing is cached and ReadDwordSetting always fails.
+		bool ReadDwordSetting(const char *subkey, const char *valuename, DWORD &dwValue, bool &bFound);
+		void StoreDwordSetting(const char *subkey, const char *valuename, DWORD dwValue, bool bFound);
+
+		// Host frame tracking. Each user calls BeginFrame once per frame with a
+		// pointer that identifies it; a new frame starts when a user that
+		// already took part in the current frame calls again.
+		void BeginFrame(const void* user);
+		void EndUser(const void* user);
+		unsigned int GetFrame();
+
+		// Sender check against the sender set of the current frame, at most one
+		// shared memory lookup per registered name and frame.
+		// Same contract as spoutSenderNames::CheckSender.
+		bool CheckSender(spoutSenderNames &senders, const char *sendername, unsigned int &width, unsigned int &height, HANDLE &hSharehandle, DWORD &dwFormat);
+
+		// Forget cached sender information, e.g. after a sender is created,
+		// updated or released by this process
+		void InvalidateSenders();
+
+	protected:
+
+		spoutSharedContext();
+		~spoutSharedContext();
+
+		struct SenderCheck {
+			unsigned int frame;
+			bool bFound;
+			unsigned int width;
+			unsigned int height;
+			HANDLE hSharehandle;
+			DWORD dwFormat;
+		};
+
+		struct DwordSetting {
+			unsigned int frame;
+			bool bFound;
+			DWORD dwValue;
+		};
+
+		ID3D11Device* m_pd3dDevice;
+		std::unordered_map<HGLRC, HANDLE> m_interopDevices;
+		std::unordered_map<std::string, DwordSetting> m_settings;
+		std::unordered_map<std::string, SenderCheck> m_senderChecks;
+
+		// sender name set of the current frame
+		void UpdateSenderSet();
+		spoutSenderNames* m_pSenders;
+		std::set<std::string> m_senderSet;
+		bool m_bSenderSetValid;
+		unsigned int m_senderSetFrame;
+
+		// frame tracking
+		unsigned int m_frame;
+		std::unordered_map<const void*, unsigned int> m_userFrames;
+
+};
+
+// Holds a reference to the shared context for the lifetime of the object
+class SPOUT_DLLEXP spoutSharedContextRef {
+
+	public:
+
+		spoutSharedContextRef() { context = spoutSharedContext::Acquire(); }
+		~spoutSharedContextRef() { spoutSharedContext::Release(); }
+
+		spoutSharedContext* operator->() const { return context; }
+		spoutSharedContext* get() const { return context; }
+
+	private:
+
+		spoutSharedContextRef(const spoutSharedContextRef&);
+		spoutSharedContextRef& operator=(const spoutSharedContextRef&);
+
+		spoutSharedContext* context;
+
+};
+
+#endif
@@ -36,6 +36,8 @@ http://www.codeproject.com/Articles/835818/Ultimate-Shared-Memory-A-flexible-cla
 */
 
 #include "SpoutSharedMemory.h"
+#include "SpoutTrace.h"
+#include "SpoutLog.h"
 #include <assert.h>
 #include <string>
 
@@ -47,6 +49,8 @@ SpoutSharedMemory::SpoutSharedMemory()
 	m_pName = NULL;
 	m_size = 0;
 	m_lockCount = 0;
+	m_pLockStats = NULL;
+	m_lockTime = 0;
 }
 
 SpoutSharedMemory::~SpoutSharedMemory()
@@ -98,7 +102,7 @@ SpoutCreateResult SpoutSharedMemory::Create(const char* name, int size)
 		// 2.004 apps will have created a 10 sender map which will not be increased in size thereafter.
 	}
 	else {
-		if(err != 0) printf("SpoutSharedMemory::Create - Error = %ld (0x%x)\n", err, err);
+		if(err != 0) SPOUT_LOG_WARNING("SpoutSharedMemory::Create - Error = %ld (0x%x)", err, err);
 	}
 
 	m_pBuffer = (char*)MapViewOfFile(m_hMap, FILE_MAP_ALL_ACCESS, 0, 0, 0);
@@ -122,6 +126,7 @@ SpoutCreateResult SpoutSharedMemory::Create(const char* name, int size)
 	// Set the name and size
 	m_pName = _strdup(name);
 	m_size = size;
+	m_pLockStats = spoutLockStats::Find(name);
 
 	return alreadyExists ? SPOUT_ALREADY_EXISTS : SPOUT_CREATE_SUCCESS;
 
@@ -162,6 +167,7 @@ bool SpoutSharedMemory::Open(const char* name)
 
 	m_pName = _strdup(name);
 	m_size = 0;
+	m_pLockStats = spoutLockStats::Find(name);
 
 	return true;
 
@@ -189,6 +195,8 @@ void SpoutSharedMemory::Close()
 		m_pName = NULL;
 	}
 
+	m_pLockStats = NULL;
+
 }
 
 
@@ -215,7 +223,21 @@ char* SpoutSharedMemory::Lock()
 		return m_pBuffer;
 	}
 
-	DWORD waitResult = WaitForSingleObject(m_hMutex, 67);
+	// Try without waiting first to tell contended locks apart
+	bool contended = false;
+	long long waitStart = spoutLockStats::Now();
+	DWORD waitResult;
+	{
+		SPOUT_TRACE("SharedMemory::Lock");
+		waitResult = WaitForSingleObject(m_hMutex, 0);
+		if (waitResult == WAIT_TIMEOUT) {
+			contended = true;
+			waitResult = WaitForSingleObject(m_hMutex, 67);
+		}
+	}
+	m_lockTime = spoutLockStats::Now();
+	spoutLockStats::RecordWait(m_pLockStats, contended, waitResult, m_lockTime - waitStart);
+
 	if (waitResult != WAIT_OBJECT_0) {
 		return NULL;
 	}
@@ -235,6 +257,7 @@ void SpoutSharedMemory::Unlock()
 	assert(m_lockCount >= 0);
 
 	if (m_lockCount == 0) {
+		spoutLockStats::RecordHold(m_pLockStats, spoutLockStats::Now() - m_lockTime);
 		ReleaseMutex(m_hMutex);
 	}
 }
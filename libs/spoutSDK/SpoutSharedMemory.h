@@ -36,6 +36,7 @@
 #define __SpoutSharedMemory_
 
 #include "SpoutCommon.h"
+#include "SpoutLockStats.h"
 #include <windowsx.h>
 #include <d3d9.h>
 #include <wingdi.h>
@@ -75,6 +76,9 @@ private:
 
 	int m_lockCount;
 
+	spoutLockEntry* m_pLockStats; // contention counters of this name
+	long long m_lockTime; // when the mutex was taken, for the hold time
+
 	const char*	m_pName;
 	int m_size;
 
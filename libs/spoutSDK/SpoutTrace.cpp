@@ -0,0 +1,181 @@
+/*
+
+	spoutTrace.cpp
+
+	Timeline events for Chrome trace / Perfetto.
+	See spoutTrace.h
+
+	- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+		Copyright (c) 2017, Davide Mania - software@cogitamus.it
+		All rights reserved.
+
+		Redistribution and use in source and binary forms, with or without
+		modification, are permitted provided that the following conditions are met:
+		* Redistributions of source code must retain the above copyright
+		notice, this list of conditions and the following disclaimer.
+		* Redistributions in binary form must reproduce the above copyright
+		notice, this list of conditions and the following disclaimer in the
+		documentation and/or other materials provided with the distribution.
+		* Neither the name of the developer nor the
+		names of its contributors may be used to endorse or promote products
+		derived from this software without specific prior written permission.
+
+		THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA "AS IS" AND ANY
+		EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+		WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+		DISCLAIMED. IN NO EVENT SHALL DAVIDE MANIA BE LIABLE FOR ANY
+		DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+		(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+		LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+		(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+		SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+*/
+#include "SpoutTrace.h"
+
+#include <windows.h>
+#include <stdio.h>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Events kept for each thread
+#define TRACE_BUFFER_SIZE 16384
+
+struct spoutTraceEvent {
+	const char *name;
+	long long start;
+	long long end;
+};
+
+struct spoutTraceBuffer {
+	DWORD threadId;
+	std::atomic<unsigned int> count; // events ever recorded, only the owner thread writes it
+	std::atomic<unsigned int> start; // first event to write, moved by Clear
+	spoutTraceEvent events[TRACE_BUFFER_SIZE];
+};
+
+// Buffers live as long as the process, events of threads that
+// ended are still worth writing
+struct spoutTraceBuffers {
+	std::mutex mutex;
+	std::vector<spoutTraceBuffer*> buffers;
+	~spoutTraceBuffers() {
+		for(size_t i = 0; i < buffers.size(); i++)
+			delete buffers[i];
+	}
+};
+
+static spoutTraceBuffers g_TraceBuffers;
+static std::atomic<bool> g_bTraceEnabled(false);
+static std::string g_TraceProcessName;
+static thread_local spoutTraceBuffer* t_pTraceBuffer = NULL;
+
+
+void spoutTrace::Enable(bool bEnable)
+{
+	g_bTraceEnabled = bEnable;
+}
+
+bool spoutTrace::IsEnabled()
+{
+	return g_bTraceEnabled.load(std::memory_order_relaxed);
+}
+
+void spoutTrace::SetProcessName(const char *name)
+{
+	std::lock_guard<std::mutex> lock(g_TraceBuffers.mutex);
+	g_TraceProcessName = name ? name : "";
+}
+
+long long spoutTrace::Now()
+{
+	LARGE_INTEGER counter;
+	QueryPerformanceCounter(&counter);
+	return counter.QuadPart;
+}
+
+void spoutTrace::Record(const char *name, long long start, long long end)
+{
+	spoutTraceBuffer* pBuffer = t_pTraceBuffer;
+
+	// First event of this thread
+	if(pBuffer == NULL) {
+		pBuffer = new spoutTraceBuffer;
+		pBuffer->threadId = GetCurrentThreadId();
+		pBuffer->count = 0;
+		pBuffer->start = 0;
+		{
+			std::lock_guard<std::mutex> lock(g_TraceBuffers.mutex);
+			g_TraceBuffers.buffers.push_back(pBuffer);
+		}
+		t_pTraceBuffer = pBuffer;
+	}
+
+	unsigned int count = pBuffer->count.load(std::memory_order_relaxed);
+	// The slot is not written before the count that makes Write drop it
+	std::atomic_thread_fence(std::memory_order_release);
+	spoutTraceEvent &event = pBuffer->events[count % TRACE_BUFFER_SIZE];
+	event.name = name;
+	event.start = start;
+	event.end = end;
+	pBuffer->count.store(count + 1, std::memory_order_release);
+}
+
+bool spoutTrace::Write(const char *path)
+{
+	FILE *file = NULL;
+	if(fopen_s(&file, path, "w") != 0 || file == NULL)
+		return false;
+
+	LARGE_INTEGER frequency;
+	QueryPerformanceFrequency(&frequency);
+	double usecPerTick = 1000000.0 / (double)frequency.QuadPart;
+
+	DWORD pid = GetCurrentProcessId();
+
+	std::lock_guard<std::mutex> lock(g_TraceBuffers.mutex);
+
+	fprintf(file, "{\"traceEvents\":[\n");
+	fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%lu,\"tid\":0,\"args\":{\"name\":\"%s\"}}",
+		pid, g_TraceProcessName.empty() ? "Spout" : g_TraceProcessName.c_str());
+
+	for(size_t i = 0; i < g_TraceBuffers.buffers.size(); i++) {
+		spoutTraceBuffer* pBuffer = g_TraceBuffers.buffers[i];
+
+		unsigned int count = pBuffer->count.load(std::memory_order_acquire);
+		unsigned int start = pBuffer->start.load(std::memory_order_relaxed);
+		unsigned int first = count - start > TRACE_BUFFER_SIZE ? count - TRACE_BUFFER_SIZE : start;
+
+		for(unsigned int n = first; n < count; n++) {
+			// The owner keeps recording: once count reaches n + TRACE_BUFFER_SIZE
+			// it may be writing over this slot, so the copy is only kept if
+			// count is still below that after it was taken
+			spoutTraceEvent event = pBuffer->events[n % TRACE_BUFFER_SIZE];
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if(pBuffer->count.load(std::memory_order_relaxed) - n >= TRACE_BUFFER_SIZE)
+				continue;
+			fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":%lu,\"tid\":%lu,\"ts\":%.3f,\"dur\":%.3f}",
+				event.name, pid, pBuffer->threadId,
+				(double)event.start * usecPerTick, (double)(event.end - event.start) * usecPerTick);
+		}
+	}
+
+	fprintf(file, "\n],\"displayTimeUnit\":\"ms\"}\n");
+	fclose(file);
+
+	return true;
+}
+
+void spoutTrace::Clear()
+{
+	std::lock_guard<std::mutex> lock(g_TraceBuffers.mutex);
+
+	// The recording thread owns count, only the start of the events to write moves
+	for(size_t i = 0; i < g_TraceBuffers.buffers.size(); i++) {
+		spoutTraceBuffer* pBuffer = g_TraceBuffers.buffers[i];
+		pBuffer->start.store(pBuffer->count.load(std::memory_order_acquire), std::memory_order_relaxed);
+	}
+}
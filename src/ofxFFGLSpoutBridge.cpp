@@ -29,6 +29,52 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ofxFFGLSpoutBridge.h"
 
+// Longest the draw thread waits for the worker's first frame before
+// drawing into the fallback fbo
+#define PIPELINE_WAIT_MS 100
+
+//******************************************************************
+//******************************************************************
+
+ofxFFGLSpoutBridge::ofxFFGLSpoutBridge()
+{
+	initialized = false;
+	receiveMode = RECEIVE_TO_FBO;
+	opaqueSource = false;
+	hostPresent = true;
+	hostSenders = NULL;
+	internalFormat = 0;
+	memoryShare = false;
+	receivedFormat = senderFormat = 0;
+
+	// Spout SDK messages written by the log thread
+	spoutLog::Start();
+
+	pool = &ownPool;
+	bufferFbo = NULL;
+	spoutTexture = NULL;
+
+	worker = NULL;
+	appSlot = -1;
+	lastFrameFbo = NULL;
+	for (int i = 0; i < ofxFFGLSpoutBridgeWorker::SLOTS; i++)
+	{
+		slotFbos[i] = NULL;
+		slotFormats[i] = 0;
+	}
+}
+
+ofxFFGLSpoutBridge::~ofxFFGLSpoutBridge()
+{
+	setPipelined(false);
+
+	// Back to a shared pool, which outlives the bridge
+	releaseSpoutTexture();
+	pool->releaseFbo(bufferFbo);
+
+	spoutLog::Stop();
+}
+
 //******************************************************************
 // Init bridge.
 // 
@@ -49,15 +95,14 @@ void ofxFFGLSpoutBridge::initialize(string bridgeName, int width, int height, bo
 {
 	ofDisableArbTex(); // Needed to pass textures to Spout. Without this you only get black. To be investigated...
 
+	// The worker is started again with the new names
+	bool wasPipelined = isPipelined();
+	setPipelined(false);
+
 	frameWidth = width;
 	frameHeight = height;
 
-	if (bufferFbo.isAllocated())
-	{
-		bufferFbo.clear();
-	}
-
-	bufferFbo.allocate(width, height, GL_RGBA);
+	allocateFbo(width, height);
 
 	spoutSenderIsInitialized = spoutReceiverIsInitialized = false;
 
@@ -70,12 +115,18 @@ void ofxFFGLSpoutBridge::initialize(string bridgeName, int width, int height, bo
 
 	strcpy(spoutSenderName, (bridgeName + "ToHost").c_str());
 	strcpy(spoutReceiveFromName, (bridgeName + "FromHost").c_str());
+	receiverConnection.SetSenderName(spoutReceiveFromName);
 
 	initialized = true;
+
+	if (wasPipelined)
+	{
+		setPipelined(true);
+	}
 }
 
 //******************************************************************
-// Receive texture from Spout and draw it to internal fbo
+// Receive texture from Spout into the internal fbo
 // for further processing
 //******************************************************************
 
@@ -86,6 +137,14 @@ void ofxFFGLSpoutBridge::receive()
 		return;
 	}
 
+	SPOUT_TRACE("ofxFFGLSpoutBridge::receive");
+
+	if (isPipelined())
+	{
+		receivePipelined();
+		return;
+	}
+
 	initSpout(); // Init must be tried every frame, the bridge with host can go up or down anytime
 
 	if (spoutReceiverIsInitialized)
@@ -97,43 +156,184 @@ void ofxFFGLSpoutBridge::receive()
 		//
 		// Important - pass the host FBO to restore the binding
 
-		unsigned int id = spoutTexture.getTextureData().textureID;
+		// In RECEIVE_TO_FBO mode Spout copies the frame, alpha included, over the
+		// fbo colour attachment: no clear and no extra draw pass are needed
+		ofTexture& target = (receiveMode == RECEIVE_TO_FBO) ? bufferFbo->getTexture() : *spoutTexture;
+		unsigned int id = target.getTextureData().textureID;
 
 		if (spoutReceiver.ReceiveTexture(spoutReceiveFromName, receiverWidth, receiverHeight, id, GL_TEXTURE_2D, flipReceivedTexture, 0))
 		{
-			if (receiverHeight != frameHeight || receiverWidth != frameWidth)
+			if (receiverHeight != frameHeight || receiverWidth != frameWidth || spoutReceiver.GetSenderFormat() != receivedFormat)
 			{
-				// Let's adapt our fbo to received frame size
+				// Let's adapt our fbo to received frame size and format.
+				// Nothing was copied on a change, receive again into the new storage.
 				frameWidth = receiverWidth;
 				frameHeight = receiverHeight;
+				receivedFormat = spoutReceiver.GetSenderFormat();
+
+				allocateFbo(frameWidth, frameHeight);
 
-				bufferFbo.clear();
-				bufferFbo.allocate(frameWidth, frameHeight, GL_RGBA);
+				if (receiveMode == RECEIVE_AND_DRAW)
+				{
+					allocateSpoutTexture(frameWidth, frameHeight);
+				}
+
+				id = ((receiveMode == RECEIVE_TO_FBO) ? bufferFbo->getTexture() : *spoutTexture).getTextureData().textureID;
+				spoutReceiver.ReceiveTexture(spoutReceiveFromName, receiverWidth, receiverHeight, id, GL_TEXTURE_2D, flipReceivedTexture, 0);
 			}
 
-			// draw the shared texture we received to fbo
-			bufferFbo.begin();
-			ofBackground(0, 0, 0, 0); // needed even if we draw a new frame every time because part of it could be transparent
-			spoutTexture.draw(0, 0, frameWidth, frameHeight);
-			bufferFbo.end();
+			if (receiveMode == RECEIVE_AND_DRAW)
+			{
+				// draw the shared texture we received to fbo
+				bufferFbo->begin();
+				if (!opaqueSource)
+				{
+					ofBackground(0, 0, 0, 0); // needed even if we draw a new frame every time because part of it could be transparent
+				}
+				spoutTexture->draw(0, 0, frameWidth, frameHeight);
+				bufferFbo->end();
+			}
 		}
 		else
 		{
 			// The sender has closed
 			spoutReceiver.ReleaseReceiver();
 			spoutReceiverIsInitialized = false;
+			receiverConnection.Disconnected();
+			releaseSpoutTexture();
 
 			ofLogNotice() << "[ofxFFGLSpoutBridge] Release existing receiver (" << spoutReceiveFromName << ")";
 		}
 	}
 	else // we didn't get a texture so let's clear our buffer
 	{
-		bufferFbo.begin();
-		ofBackground(0, 0, 0, 0);
-		bufferFbo.end();
+		clearFbo();
 	}
 }
 
+//******************************************************************
+// Select how received frames get into the fbo.
+// RECEIVE_AND_DRAW goes through the current ofStyle (blending etc.)
+// at the cost of a full frame draw pass.
+//******************************************************************
+
+void ofxFFGLSpoutBridge::setReceiveMode(ReceiveMode mode)
+{
+	if (mode == receiveMode)
+	{
+		return;
+	}
+
+	receiveMode = mode;
+
+	if (receiveMode == RECEIVE_AND_DRAW && spoutReceiverIsInitialized)
+	{
+		allocateSpoutTexture(receiverWidth, receiverHeight);
+	}
+	else if (receiveMode == RECEIVE_TO_FBO)
+	{
+		releaseSpoutTexture();
+	}
+}
+
+//******************************************************************
+// Select the precision of the fbo, see the header. The fbo and the
+// sender are created again in the new format.
+//******************************************************************
+
+void ofxFFGLSpoutBridge::setInternalFormat(int format)
+{
+	if (format == internalFormat)
+	{
+		return;
+	}
+
+	internalFormat = format;
+
+	if (!initialized)
+	{
+		return;
+	}
+
+	// The worker takes the format when started
+	if (isPipelined())
+	{
+		setPipelined(false);
+		setPipelined(true);
+		return;
+	}
+
+	allocateFbo(frameWidth, frameHeight);
+	if (receiveMode == RECEIVE_AND_DRAW && spoutReceiverIsInitialized)
+	{
+		allocateSpoutTexture(receiverWidth, receiverHeight);
+	}
+
+	spoutSender.ReleaseSender();
+	spoutSenderIsInitialized = false; // initSpout creates it again
+}
+
+//******************************************************************
+// Force the receiver to memoryshare or back to the system setting.
+// The receiver is created again in the new mode.
+//******************************************************************
+
+void ofxFFGLSpoutBridge::setMemoryShare(bool memory)
+{
+	if (memory == memoryShare)
+	{
+		return;
+	}
+
+	memoryShare = memory;
+
+	// The worker takes the mode when started
+	if (isPipelined())
+	{
+		setPipelined(false);
+		setPipelined(true);
+		return;
+	}
+
+	spoutReceiver.ReleaseReceiver();
+	spoutReceiver.ForceMemoryShare(memoryShare);
+	spoutReceiverIsInitialized = false; // initSpout creates it again
+	receiverConnection.Disconnected(); // without waiting for a backoff
+	releaseSpoutTexture();
+}
+
+//******************************************************************
+// Fbo and texture helpers. Storage is swapped through the pool, so a
+// size seen recently is reused instead of reallocated.
+//******************************************************************
+
+void ofxFFGLSpoutBridge::allocateFbo(int width, int height)
+{
+	pool->releaseFbo(bufferFbo);
+	bufferFbo = pool->acquireFbo(width, height, getInternalFormat());
+
+	clearFbo(); // pooled content is whatever was left in it
+}
+
+void ofxFFGLSpoutBridge::clearFbo()
+{
+	bufferFbo->begin();
+	ofBackground(0, 0, 0, 0);
+	bufferFbo->end();
+}
+
+void ofxFFGLSpoutBridge::allocateSpoutTexture(int width, int height)
+{
+	pool->releaseTexture(spoutTexture);
+	spoutTexture = pool->acquireTexture(width, height, getInternalFormat());
+}
+
+void ofxFFGLSpoutBridge::releaseSpoutTexture()
+{
+	pool->releaseTexture(spoutTexture);
+	spoutTexture = NULL;
+}
+
 //******************************************************************
 // Send current texture from fbo to host application via Spout
 //******************************************************************
@@ -145,13 +345,56 @@ void ofxFFGLSpoutBridge::send()
 		return;
 	}
 
+	SPOUT_TRACE("ofxFFGLSpoutBridge::send");
+
+	if (isPipelined())
+	{
+		sendPipelined();
+		return;
+	}
+
 	if (spoutSenderIsInitialized)
 	{
-		unsigned int id = bufferFbo.getTexture().getTextureData().textureID;
+		unsigned int id = bufferFbo->getTexture().getTextureData().textureID;
 		spoutSender.SendTexture(id, GL_TEXTURE_2D, frameWidth, frameHeight, flipTextureToSend);
 	}
 }
 
+//******************************************************************
+// Trace recording and lock statistics
+//******************************************************************
+
+void ofxFFGLSpoutBridge::startTrace()
+{
+	spoutTrace::Clear();
+	spoutTrace::SetProcessName("ofxFFGLSpoutBridge");
+	spoutTrace::Enable(true);
+}
+
+bool ofxFFGLSpoutBridge::writeTrace(string path)
+{
+	if (!spoutTrace::Write(path.c_str()))
+	{
+		ofLogError() << "[ofxFFGLSpoutBridge] Error: could not write trace to " << path;
+		return false;
+	}
+
+	ofLogNotice() << "[ofxFFGLSpoutBridge] Trace written to " << path;
+	return true;
+}
+
+bool ofxFFGLSpoutBridge::writeLockStats(string path)
+{
+	if (!spoutLockStats::Write(path.c_str()))
+	{
+		ofLogError() << "[ofxFFGLSpoutBridge] Error: could not write lock statistics to " << path;
+		return false;
+	}
+
+	ofLogNotice() << "[ofxFFGLSpoutBridge] Lock statistics written to " << path;
+	return true;
+}
+
 //******************************************************************
 // If Spout links are not active try to initialize them 
 //******************************************************************
@@ -165,14 +408,20 @@ void ofxFFGLSpoutBridge::initSpout()
 	if (!spoutSenderIsInitialized) // create a sender if not initialized yet
 	{
 		// Create a new sender
-		spoutSenderIsInitialized = spoutSender.CreateSender(spoutSenderName, frameWidth, frameHeight);
+		DWORD localFormats = 0;
+		senderFormat = negotiateSenderFormat(localFormats);
+		spoutSenderIsInitialized = spoutSender.CreateSender(spoutSenderName, frameWidth, frameHeight, senderFormat);
 		if (!spoutSenderIsInitialized)
 		{
 			ofLogError() << "[ofxFFGLSpoutBridge] Error: could not create Spout sender";
 		}
 		else
 		{
-			ofLogNotice() << "[ofxFFGLSpoutBridge] Created new Spout sender (" << spoutSenderName << ")";
+			// Lets the host negotiate in turn
+			spoutSender.SetSenderFormats(localFormats);
+
+			ofLogNotice() << "[ofxFFGLSpoutBridge] Created new Spout sender (" << spoutSenderName << ") in "
+				<< spoutFormat::GetName(spoutFormat::FromDXGIFormat(senderFormat));
 		}
 
 		return; // give it one frame to initialize
@@ -182,28 +431,320 @@ void ofxFFGLSpoutBridge::initSpout()
 	// Manage Spout receiver initialization
 	//*********************************************************
 
-	if (!spoutReceiverIsInitialized) // create a sender if not initialized yet
+	if (!spoutReceiverIsInitialized && hostPresent) // create a receiver if not initialized yet
 	{
 		// Create a new receiver
 		// CreateReceiver will return true only if it finds a sender running.
 		// If a sender name is specified and does not exist it will return false.
-		// This also sets the global width and height
+		// This also sets the global width and height.
+		// Attempts are spaced out while the host is away.
+
+		// A hub has read the sender names already
+		bool shouldConnect = (hostSenders != NULL) ? receiverConnection.ShouldConnect(*hostSenders) : receiverConnection.ShouldConnect();
+		if (!shouldConnect)
+		{
+			return;
+		}
 
 		receiverWidth = frameWidth;
 		receiverHeight = frameHeight;
 
-		if (spoutReceiver.CreateReceiver(spoutReceiveFromName, receiverWidth, receiverHeight, false))
+		if (!spoutReceiver.CreateReceiver(spoutReceiveFromName, receiverWidth, receiverHeight, false))
+		{
+			receiverConnection.Failed();
+		}
+		else
 		{
-			spoutTexture.allocate(receiverWidth, receiverHeight, GL_RGBA);
+			receiverConnection.Connected();
+
+			// More precision from the host is kept in the fbo
+			int previousFormat = getInternalFormat();
+			receivedFormat = spoutReceiver.GetSenderFormat();
+			if (getInternalFormat() != previousFormat)
+			{
+				allocateFbo(frameWidth, frameHeight);
+			}
+
+			if (receiveMode == RECEIVE_AND_DRAW)
+			{
+				allocateSpoutTexture(receiverWidth, receiverHeight);
+			}
 
 			spoutReceiverIsInitialized = true;
 
-			ofLogNotice() << "[ofxFFGLSpoutBridge] Spout receiver initialized (" << spoutReceiveFromName << ")";
+			ofLogNotice() << "[ofxFFGLSpoutBridge] Spout receiver initialized (" << spoutReceiveFromName << ") after "
+				<< receiverConnection.GetAttempts() << " attempts, " << receiverConnection.GetLastConnectTime() << " ms, in "
+				<< spoutFormat::GetName(spoutFormat::FromDXGIFormat(receivedFormat));
+
+			// The sender format was chosen without the host, it is created
+			// again on the next frame if the host takes another one
+			DWORD localFormats = 0;
+			if (negotiateSenderFormat(localFormats) != senderFormat)
+			{
+				spoutSender.ReleaseSender();
+				spoutSenderIsInitialized = false;
+			}
 		}
 
 		return; // give it one frame to initialize
 	}
 }
 
+//******************************************************************
+// Sender format for the frames of the fbo, see
+// ofxFFGLSpoutBridgeWorker::negotiateSenderFormat
+//******************************************************************
+
+DWORD ofxFFGLSpoutBridge::negotiateSenderFormat(DWORD& localFormats)
+{
+	return ofxFFGLSpoutBridgeWorker::negotiateSenderFormat(&spoutSender, &spoutReceiver, spoutReceiveFromName, getInternalFormat(), localFormats);
+}
+
+//******************************************************************
+// Start or stop the worker thread.
+// Frames then go through slots, fbos allocated here and filled or
+// sent by the worker, see ofxFFGLSpoutBridgeWorker.h
+//******************************************************************
+
+bool ofxFFGLSpoutBridge::setPipelined(bool pipelined)
+{
+	if (pipelined == isPipelined())
+	{
+		return true;
+	}
+
+	if (!pipelined)
+	{
+		worker->stop();
+		delete worker;
+		worker = NULL;
+
+		pool->releaseFbo(lastFrameFbo);
+		lastFrameFbo = NULL;
+		appSlot = -1;
+		for (int i = 0; i < ofxFFGLSpoutBridgeWorker::SLOTS; i++)
+		{
+			pool->releaseFbo(slotFbos[i]);
+			slotFbos[i] = NULL;
+		}
+
+		// The slots followed the host size and format, the fbo did not.
+		// The draw thread path only reallocates on a change it sees itself
+		ofTexture& texture = bufferFbo->getTexture();
+		if (texture.getWidth() != frameWidth || texture.getHeight() != frameHeight ||
+			texture.getTextureData().glInternalFormat != getInternalFormat())
+		{
+			allocateFbo(frameWidth, frameHeight);
+		}
+
+		// receive() creates the links again on the draw thread
+		ofLogNotice() << "[ofxFFGLSpoutBridge] Pipelined mode stopped";
+		return true;
+	}
+
+	if (!initialized)
+	{
+		return false;
+	}
+
+	// The worker takes over the Spout links
+	spoutReceiver.ReleaseReceiver();
+	spoutSender.ReleaseSender();
+	spoutSenderIsInitialized = spoutReceiverIsInitialized = false;
+
+	worker = new ofxFFGLSpoutBridgeWorker(spoutSenderName, spoutReceiveFromName, flipReceivedTexture, flipTextureToSend, internalFormat, memoryShare);
+	if (!worker->start())
+	{
+		delete worker;
+		worker = NULL;
+		return false;
+	}
+
+	appSlot = -1;
+	for (int i = 0; i < ofxFFGLSpoutBridgeWorker::SLOTS; i++)
+	{
+		slotFormats[i] = receivedFormat;
+		slotFbos[i] = pool->acquireFbo(frameWidth, frameHeight, getInternalFormat());
+		returnSlot(i, false);
+	}
+
+	ofLogNotice() << "[ofxFFGLSpoutBridge] Pipelined mode started";
+	return true;
+}
+
+//******************************************************************
+// Take the most recent frame from the worker, older ones are given
+// back to be filled again.
+//
+// With nothing new the last frame is drawn again, from a copy made
+// when it was taken since the app draws over the slot and sends it.
+// A worker held up in Spout does not hold up the app and the picture
+// never steps back. Only when there is no frame at all, at start, the
+// draw thread waits for one.
+//******************************************************************
+
+void ofxFFGLSpoutBridge::receivePipelined()
+{
+	ofxFFGLSpoutBridgeWorker::Message latest;
+	latest.slot = -1;
+
+	worker->setHostPresent(hostPresent);
+
+	takeReady(latest);
+
+	uint64_t start = ofGetElapsedTimeMillis();
+
+	while (latest.slot < 0 && appSlot < 0 && lastFrameFbo == NULL)
+	{
+		// Blocks on the worker event, no spinning
+		uint64_t elapsed = ofGetElapsedTimeMillis() - start;
+		if (elapsed >= PIPELINE_WAIT_MS || !worker->waitReady((DWORD)(PIPELINE_WAIT_MS - elapsed)))
+		{
+			break;
+		}
+
+		takeReady(latest);
+	}
+
+	if (latest.slot < 0)
+	{
+		if (appSlot < 0)
+		{
+			repeatLastFrame(); // nothing is sent this frame
+		}
+		return;
+	}
+
+	// The app did not send the previous frame
+	if (appSlot >= 0)
+	{
+		returnSlot(appSlot, false);
+	}
+
+	// Commands using the texture wait for the worker copy
+	glWaitSync(latest.fence, 0, GL_TIMEOUT_IGNORED);
+	glDeleteSync(latest.fence);
+
+	appSlot = latest.slot;
+	frameWidth = latest.width;
+	frameHeight = latest.height;
+
+	keepLastFrame(*slotFbos[appSlot]);
+}
+
+//******************************************************************
+// Pop the messages of the worker, true if a new frame came. Frames
+// it superseded go back without being drawn.
+//******************************************************************
+
+bool ofxFFGLSpoutBridge::takeReady(ofxFFGLSpoutBridgeWorker::Message& latest)
+{
+	ofxFFGLSpoutBridgeWorker::Message message;
+	bool taken = false;
+
+	while (worker->popReady(message))
+	{
+		if (message.type == ofxFFGLSpoutBridgeWorker::FRAME_RESIZE)
+		{
+			// The host changed size or format, fbos are reallocated as they come back
+			receivedFormat = message.format;
+			slotFormats[message.slot] = message.format;
+			pool->releaseFbo(slotFbos[message.slot]);
+			slotFbos[message.slot] = pool->acquireFbo(message.width, message.height, getInternalFormat());
+			returnSlot(message.slot, false);
+			continue;
+		}
+
+		if (latest.slot >= 0)
+		{
+			glDeleteSync(latest.fence);
+			returnSlot(latest.slot, false);
+		}
+
+		latest = message;
+		taken = true;
+	}
+
+	return taken;
+}
+
+//******************************************************************
+// The copy of the last frame, one blit per frame taken, and its
+// redraw into the fallback fbo while the worker has nothing new
+//******************************************************************
+
+static void blitFbo(ofFbo& from, ofFbo& to)
+{
+	int width = (int)from.getWidth();
+	int height = (int)from.getHeight();
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, from.getId());
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, to.getId());
+	glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+static bool sameAllocation(ofFbo& a, ofFbo& b)
+{
+	return a.getWidth() == b.getWidth() && a.getHeight() == b.getHeight() &&
+		a.getTexture().getTextureData().glInternalFormat == b.getTexture().getTextureData().glInternalFormat;
+}
+
+void ofxFFGLSpoutBridge::keepLastFrame(ofFbo& frame)
+{
+	if (lastFrameFbo == NULL || !sameAllocation(*lastFrameFbo, frame))
+	{
+		pool->releaseFbo(lastFrameFbo);
+		lastFrameFbo = pool->acquireFbo((int)frame.getWidth(), (int)frame.getHeight(), frame.getTexture().getTextureData().glInternalFormat);
+	}
+
+	blitFbo(frame, *lastFrameFbo);
+}
+
+void ofxFFGLSpoutBridge::repeatLastFrame()
+{
+	if (lastFrameFbo == NULL)
+	{
+		clearFbo(); // worker stuck before the first frame
+		return;
+	}
+
+	if (!sameAllocation(*bufferFbo, *lastFrameFbo))
+	{
+		pool->releaseFbo(bufferFbo);
+		bufferFbo = pool->acquireFbo((int)lastFrameFbo->getWidth(), (int)lastFrameFbo->getHeight(), lastFrameFbo->getTexture().getTextureData().glInternalFormat);
+	}
+
+	blitFbo(*lastFrameFbo, *bufferFbo);
+}
+
+void ofxFFGLSpoutBridge::sendPipelined()
+{
+	if (appSlot < 0)
+	{
+		return;
+	}
+
+	returnSlot(appSlot, true);
+	appSlot = -1;
+}
+
+void ofxFFGLSpoutBridge::returnSlot(int slot, bool send)
+{
+	ofxFFGLSpoutBridgeWorker::Message message;
+	message.slot = slot;
+	message.type = send ? ofxFFGLSpoutBridgeWorker::FRAME_SEND : ofxFFGLSpoutBridgeWorker::FRAME_RETURN;
+	message.textureID = slotFbos[slot]->getTexture().getTextureData().textureID;
+	message.width = (unsigned int)slotFbos[slot]->getWidth();
+	message.height = (unsigned int)slotFbos[slot]->getHeight();
+	message.format = slotFormats[slot];
+
+	// The worker waits for what was drawn into the slot before using it
+	message.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	glFlush();
+
+	worker->pushReturned(message);
+}
+
 //******************************************************************
 //******************************************************************
@@ -31,6 +31,12 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ofMain.h"
 #include "Spout.h"
+#include "SpoutConnectionState.h"
+#include "SpoutTrace.h"
+#include "SpoutLockStats.h"
+#include "SpoutLog.h"
+#include "ofxFFGLSpoutBridgeWorker.h"
+#include "ofxFFGLSpoutBridgePool.h"
 
 //******************************************************************
 // ofxFFGLSpoutBridge
@@ -39,24 +45,76 @@ SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 class ofxFFGLSpoutBridge
 {
+	friend class ofxFFGLSpoutBridgeHub;
+
 public:
-	ofxFFGLSpoutBridge() { initialized = false; };
-	virtual ~ofxFFGLSpoutBridge() {};
+	// How a received frame gets into the fbo
+	enum ReceiveMode
+	{
+		RECEIVE_TO_FBO,		// copied by Spout straight into the fbo colour attachment (default)
+		RECEIVE_AND_DRAW	// received into a texture which is then drawn into the fbo
+	};
+
+	ofxFFGLSpoutBridge();
+	virtual ~ofxFFGLSpoutBridge();
 
 	void initialize(string bridgeName, int width, int height, bool flipReceive = false, bool flipSend = false);
 
 	void receive();
 	void send();
 
-	ofFbo& getFbo() { return bufferFbo; }
+	// Receiver connection metrics, synchronous mode
+	spoutConnectionState& getReceiverConnection() { return receiverConnection; }
+
+	void setReceiveMode(ReceiveMode mode);
+	ReceiveMode getReceiveMode() { return receiveMode; }
+
+	// Frames from the host have no transparent pixels: the fbo is not
+	// cleared before drawing them in RECEIVE_AND_DRAW mode
+	void setOpaqueSource(bool opaque) { opaqueSource = opaque; }
+
+	// OpenGL internal format of the fbo, e.g. GL_RGBA16F for HDR work.
+	// 0 (default) follows the host: 8 bit unless it sends more precision.
+	// Frames go back to the host in the cheapest format both sides can
+	// share that keeps this precision.
+	void setInternalFormat(int internalFormat);
+	int getInternalFormat() { return ofxFFGLSpoutBridgeWorker::frameInternalFormat(internalFormat, receivedFormat); }
+
+	// Receive the host frames by memoryshare whatever the Spout setting
+	// of the system, e.g. from ofxFFGLSpoutBridgeReplay. Only this
+	// bridge is affected, the registry is not written.
+	void setMemoryShare(bool memoryShare);
+	bool getMemoryShare() { return memoryShare; }
+
+	// Pipelined mode: Spout connections, receiving and sending run on a
+	// worker thread with its own OpenGL context. The app draws frame N
+	// while N+1 is received and N-1 is sent, at the cost of one frame of
+	// latency. Call from the draw thread, after initialize.
+	bool setPipelined(bool pipelined);
+	bool isPipelined() { return worker != NULL; }
+
+	// Valid after initialize. The fbo changes when the host frame size
+	// changes and every frame in pipelined mode, get it after receive().
+	ofFbo& getFbo() { return appSlot >= 0 ? *slotFbos[appSlot] : *bufferFbo; }
+
+	// Timeline of receives, sends, Spout locks and copies of all the
+	// bridges of the app, written as Chrome trace JSON. Traces of the
+	// host (SPOUTBRIDGE_TRACE variable) share the same clock.
+	static void startTrace();
+	static bool writeTrace(string path);
+
+	// Wait counts, times and timeouts of the Spout shared memory locks
+	// of the app, per mapping name, as a text file. Always recorded.
+	static bool writeLockStats(string path);
 
 private:
 	int frameWidth, frameHeight;
 
 	SpoutSender spoutSender;
 	SpoutReceiver spoutReceiver;
+	spoutConnectionState receiverConnection; // when to try CreateReceiver again
 
-	ofTexture spoutTexture;
+	ofTexture* spoutTexture; // RECEIVE_AND_DRAW mode only
 	bool flipReceivedTexture, flipTextureToSend;
 
 	char spoutSenderName[256];
@@ -64,9 +122,45 @@ private:
 
 	unsigned int receiverWidth, receiverHeight;
 
+	// Pixel formats, see SpoutFormat.h
+	int internalFormat; // requested, 0 follows the host
+	bool memoryShare; // receiver forced to memoryshare
+	DWORD receivedFormat; // DXGI format of the host sender
+	DWORD senderFormat;
+	DWORD negotiateSenderFormat(DWORD& localFormats);
+
 	bool spoutSenderIsInitialized, spoutReceiverIsInitialized;
 	bool initialized;
+	bool hostPresent; // false when a hub knows there is no sender to connect to
+	const std::set<std::string>* hostSenders; // sender names read by the hub this frame, NULL without a hub
 	void initSpout();
 
-	ofFbo bufferFbo;
+	ReceiveMode receiveMode;
+	bool opaqueSource;
+
+	// Fbos and textures come from the pool of the hub the bridge belongs
+	// to, or from its own
+	ofxFFGLSpoutBridgePool ownPool;
+	ofxFFGLSpoutBridgePool* pool;
+
+	void allocateFbo(int width, int height);
+	void clearFbo();
+	void allocateSpoutTexture(int width, int height);
+	void releaseSpoutTexture();
+
+	// Pipelined mode
+	ofxFFGLSpoutBridgeWorker* worker;
+	ofFbo* slotFbos[ofxFFGLSpoutBridgeWorker::SLOTS];
+	DWORD slotFormats[ofxFFGLSpoutBridgeWorker::SLOTS]; // host format each slot was allocated for
+	int appSlot; // slot the app draws into, -1 if none
+	ofFbo* lastFrameFbo; // copy of the last frame taken, as received, NULL if none
+
+	void receivePipelined();
+	bool takeReady(ofxFFGLSpoutBridgeWorker::Message& latest);
+	void keepLastFrame(ofFbo& frame);
+	void repeatLastFrame();
+	void sendPipelined();
+	void returnSlot(int slot, bool send);
+
+	ofFbo* bufferFbo;
 };
@@ -0,0 +1,92 @@
+//******************************************************************
+/*
+Copyright (c) 2017, Davide Mani - software@cogitamus.it
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+* Neither the name of the developer nor the
+names of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA' "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL DAMIAN STEWART BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//******************************************************************
+
+#include "ofxFFGLSpoutBridgeHub.h"
+
+//******************************************************************
+// Bridge management
+//******************************************************************
+
+ofxFFGLSpoutBridge& ofxFFGLSpoutBridgeHub::addBridge(string bridgeName, int width, int height, bool flipReceive, bool flipSend)
+{
+	std::unique_ptr<ofxFFGLSpoutBridge>& bridge = bridges[bridgeName];
+	if (!bridge)
+	{
+		bridge.reset(new ofxFFGLSpoutBridge());
+		bridge->pool = &pool;
+	}
+
+	bridge->initialize(bridgeName, width, height, flipReceive, flipSend);
+
+	// Connections are decided by receive()
+	bridge->hostPresent = false;
+	bridge->hostSenders = &activeSenders;
+
+	return *bridge;
+}
+
+void ofxFFGLSpoutBridgeHub::removeBridge(string bridgeName)
+{
+	bridges.erase(bridgeName);
+}
+
+ofxFFGLSpoutBridge* ofxFFGLSpoutBridgeHub::getBridge(string bridgeName)
+{
+	auto itr = bridges.find(bridgeName);
+	return itr != bridges.end() ? itr->second.get() : NULL;
+}
+
+//******************************************************************
+// One look at the sender list for all the bridges, then each of them
+// receives. Bridges whose host sender is not listed don't try to
+// connect, the others decide on the same list without reading it
+// again. Connected ones find out themselves when it closes.
+//******************************************************************
+
+void ofxFFGLSpoutBridgeHub::receive()
+{
+	activeSenders.clear();
+	senderNames.GetSenderNames(&activeSenders);
+
+	for (auto itr = bridges.begin(); itr != bridges.end(); itr++)
+	{
+		ofxFFGLSpoutBridge& bridge = *itr->second;
+
+		bridge.hostPresent = activeSenders.find(bridge.spoutReceiveFromName) != activeSenders.end();
+		bridge.receive();
+	}
+}
+
+void ofxFFGLSpoutBridgeHub::send()
+{
+	for (auto itr = bridges.begin(); itr != bridges.end(); itr++)
+	{
+		itr->second->send();
+	}
+}
@@ -0,0 +1,77 @@
+//******************************************************************
+/*
+Copyright (c) 2017, Davide Mani - software@cogitamus.it
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+* Neither the name of the developer nor the
+names of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA' "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL DAMIAN STEWART BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//******************************************************************
+
+#pragma once
+
+#include "ofxFFGLSpoutBridge.h"
+
+#include <map>
+#include <memory>
+#include <set>
+
+//******************************************************************
+// ofxFFGLSpoutBridgeHub
+// Manages several named bridges in one client app, e.g. one for
+// each host layer running the plugin.
+//
+// receive() reads the list of Spout senders once per frame and only
+// lets a bridge try to connect when its FromHost sender is in the
+// list, instead of every disconnected bridge probing Spout on its
+// own every frame. send() then sends all bridges in one pass.
+// Fbos and textures of all the bridges come from one pool.
+//******************************************************************
+
+class ofxFFGLSpoutBridgeHub
+{
+public:
+	ofxFFGLSpoutBridgeHub() {};
+	virtual ~ofxFFGLSpoutBridgeHub() {};
+
+	// Same arguments as ofxFFGLSpoutBridge::initialize. An existing
+	// bridge with this name is initialized again.
+	ofxFFGLSpoutBridge& addBridge(string bridgeName, int width, int height, bool flipReceive = false, bool flipSend = false);
+	void removeBridge(string bridgeName);
+
+	// NULL if there is no bridge with this name
+	ofxFFGLSpoutBridge* getBridge(string bridgeName);
+	size_t getBridgeCount() { return bridges.size(); }
+
+	void receive();
+	void send();
+
+	// Fbos and textures shared by all the bridges
+	ofxFFGLSpoutBridgePool& getPool() { return pool; }
+
+private:
+	ofxFFGLSpoutBridgePool pool; // declared first, bridges give their objects back when destroyed
+	std::map<string, std::unique_ptr<ofxFFGLSpoutBridge>> bridges;
+
+	spoutSenderNames senderNames;
+	std::set<std::string> activeSenders;
+};
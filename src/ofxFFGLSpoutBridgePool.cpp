@@ -0,0 +1,159 @@
+//******************************************************************
+/*
+Copyright (c) 2017, Davide Mani - software@cogitamus.it
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+* Neither the name of the developer nor the
+names of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA' "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL DAMIAN STEWART BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//******************************************************************
+
+#include "ofxFFGLSpoutBridgePool.h"
+
+//******************************************************************
+//******************************************************************
+
+ofxFFGLSpoutBridgePool::ofxFFGLSpoutBridgePool(size_t maxFree)
+{
+	this->maxFree = maxFree;
+}
+
+ofxFFGLSpoutBridgePool::~ofxFFGLSpoutBridgePool()
+{
+	clear();
+
+	for (auto itr = fbos.used.begin(); itr != fbos.used.end(); itr++)
+	{
+		delete itr->first;
+	}
+	fbos.used.clear();
+
+	for (auto itr = textures.used.begin(); itr != textures.used.end(); itr++)
+	{
+		delete itr->first;
+	}
+	textures.used.clear();
+}
+
+//******************************************************************
+// Public interface
+//******************************************************************
+
+ofFbo* ofxFFGLSpoutBridgePool::acquireFbo(int width, int height, int internalFormat)
+{
+	Key key = { width, height, internalFormat };
+	return acquire(fbos, key);
+}
+
+void ofxFFGLSpoutBridgePool::releaseFbo(ofFbo* fbo)
+{
+	release(fbos, fbo);
+}
+
+ofTexture* ofxFFGLSpoutBridgePool::acquireTexture(int width, int height, int internalFormat)
+{
+	Key key = { width, height, internalFormat };
+	return acquire(textures, key);
+}
+
+void ofxFFGLSpoutBridgePool::releaseTexture(ofTexture* texture)
+{
+	release(textures, texture);
+}
+
+void ofxFFGLSpoutBridgePool::setMaxFree(size_t maxFree)
+{
+	this->maxFree = maxFree;
+
+	trim(fbos, maxFree);
+	trim(textures, maxFree);
+}
+
+void ofxFFGLSpoutBridgePool::clear()
+{
+	trim(fbos, 0);
+	trim(textures, 0);
+}
+
+//******************************************************************
+// Same logic for both kinds of objects
+//******************************************************************
+
+template <typename T>
+T* ofxFFGLSpoutBridgePool::acquire(Objects<T>& objects, const Key& key)
+{
+	T* object = NULL;
+
+	for (auto itr = objects.free.begin(); itr != objects.free.end(); itr++)
+	{
+		if (itr->first == key)
+		{
+			object = itr->second;
+			objects.free.erase(itr);
+			break;
+		}
+	}
+
+	if (object == NULL)
+	{
+		object = new T();
+		allocate(object, key);
+	}
+
+	objects.used[object] = key;
+	return object;
+}
+
+template <typename T>
+void ofxFFGLSpoutBridgePool::release(Objects<T>& objects, T* object)
+{
+	auto itr = objects.used.find(object);
+	if (itr == objects.used.end())
+	{
+		return; // NULL or not from this pool
+	}
+
+	objects.free.push_front(std::make_pair(itr->second, object));
+	objects.used.erase(itr);
+
+	trim(objects, maxFree);
+}
+
+template <typename T>
+void ofxFFGLSpoutBridgePool::trim(Objects<T>& objects, size_t count)
+{
+	while (objects.free.size() > count)
+	{
+		delete objects.free.back().second;
+		objects.free.pop_back();
+	}
+}
+
+void ofxFFGLSpoutBridgePool::allocate(ofFbo* fbo, const Key& key)
+{
+	fbo->allocate(key.width, key.height, key.internalFormat);
+}
+
+void ofxFFGLSpoutBridgePool::allocate(ofTexture* texture, const Key& key)
+{
+	texture->allocate(key.width, key.height, key.internalFormat);
+}
@@ -0,0 +1,92 @@
+//******************************************************************
+/*
+Copyright (c) 2017, Davide Mani - software@cogitamus.it
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+* Neither the name of the developer nor the
+names of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA' "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL DAMIAN STEWART BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//******************************************************************
+
+#pragma once
+
+#include "ofMain.h"
+
+#include <list>
+#include <map>
+
+//******************************************************************
+// ofxFFGLSpoutBridgePool
+// Recycles fbos and textures by size and internal format.
+//
+// Released objects keep their GPU storage and are handed out again
+// to the next request of the same size and format, so reconnections
+// and hosts switching between compositions of different sizes don't
+// reallocate every time. At most maxFree objects of each kind are
+// kept aside, the least recently released are destroyed first.
+//
+// Objects stay owned by the pool, destroying the pool destroys them.
+// Use it from the thread owning the OpenGL context.
+//******************************************************************
+
+class ofxFFGLSpoutBridgePool
+{
+public:
+	ofxFFGLSpoutBridgePool(size_t maxFree = 4);
+	virtual ~ofxFFGLSpoutBridgePool();
+
+	ofFbo* acquireFbo(int width, int height, int internalFormat = GL_RGBA);
+	void releaseFbo(ofFbo* fbo);
+
+	ofTexture* acquireTexture(int width, int height, int internalFormat = GL_RGBA);
+	void releaseTexture(ofTexture* texture);
+
+	void setMaxFree(size_t maxFree);
+
+	// Destroy the objects not in use
+	void clear();
+
+private:
+	struct Key
+	{
+		int width, height, internalFormat;
+		bool operator==(const Key& other) const { return width == other.width && height == other.height && internalFormat == other.internalFormat; }
+	};
+
+	template <typename T>
+	struct Objects
+	{
+		std::list<std::pair<Key, T*>> free; // most recently released first
+		std::map<T*, Key> used;
+	};
+
+	template <typename T> T* acquire(Objects<T>& objects, const Key& key);
+	template <typename T> void release(Objects<T>& objects, T* object);
+	template <typename T> void trim(Objects<T>& objects, size_t count);
+
+	static void allocate(ofFbo* fbo, const Key& key);
+	static void allocate(ofTexture* texture, const Key& key);
+
+	Objects<ofFbo> fbos;
+	Objects<ofTexture> textures;
+	size_t maxFree;
+};
@@ -0,0 +1,85 @@
+//******************************************************************
+/*
+Copyright (c) 2017, Davide Mani - software@cogitamus.it
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+* Neither the name of the developer nor the
+names of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA' "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL DAMIAN STEWART BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//******************************************************************
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+//******************************************************************
+// ofxFFGLSpoutBridgeQueue
+// Bounded lock-free queue for exactly one producer thread and one
+// consumer thread. Size must be a power of two, one entry is kept
+// free to tell a full queue from an empty one.
+//******************************************************************
+
+template <typename T, size_t Size>
+class ofxFFGLSpoutBridgeQueue
+{
+	static_assert(Size >= 2 && (Size & (Size - 1)) == 0, "ofxFFGLSpoutBridgeQueue size must be a power of two");
+
+public:
+	ofxFFGLSpoutBridgeQueue() : head(0), tail(0) {};
+
+	// Producer side, false if the queue is full
+	bool push(const T& item)
+	{
+		size_t t = tail.load(std::memory_order_relaxed);
+		size_t next = (t + 1) & (Size - 1);
+
+		if (next == head.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		items[t] = item;
+		tail.store(next, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side, false if the queue is empty
+	bool pop(T& item)
+	{
+		size_t h = head.load(std::memory_order_relaxed);
+
+		if (h == tail.load(std::memory_order_acquire))
+		{
+			return false;
+		}
+
+		item = items[h];
+		head.store((h + 1) & (Size - 1), std::memory_order_release);
+		return true;
+	}
+
+private:
+	T items[Size];
+	std::atomic<size_t> head; // next item to pop, written by the consumer only
+	std::atomic<size_t> tail; // next free entry, written by the producer only
+};
@@ -0,0 +1,282 @@
+//******************************************************************
+/*
+Copyright (c) 2017, Davide Mani - software@cogitamus.it
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+* Neither the name of the developer nor the
+names of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA' "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL DAMIAN STEWART BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//******************************************************************
+
+#include "ofxFFGLSpoutBridgeReplay.h"
+
+#pragma comment(lib, "ws2_32.lib")
+
+//******************************************************************
+//******************************************************************
+
+ofxFFGLSpoutBridgeReplay::ofxFFGLSpoutBridgeReplay()
+{
+	hasNext = false;
+	spoutSender = NULL;
+	senderCreated = false;
+	senderWidth = senderHeight = 0;
+	framePixelsWidth = framePixelsHeight = 0;
+	framePixelsHash = 0;
+
+	WSADATA wsaData;
+	WSAStartup(MAKEWORD(2, 2), &wsaData);
+	oscSocket = INVALID_SOCKET;
+	memset(&oscAddress, 0, sizeof(oscAddress));
+
+	running = maxSpeed = loop = false;
+	startTime = 0;
+	elapsedMs = 0;
+	framesSent = packetsSent = 0;
+}
+
+ofxFFGLSpoutBridgeReplay::~ofxFFGLSpoutBridgeReplay()
+{
+	stop();
+
+	if (oscSocket != INVALID_SOCKET)
+	{
+		closesocket(oscSocket);
+	}
+	WSACleanup();
+}
+
+//******************************************************************
+// Public interface
+//******************************************************************
+
+bool ofxFFGLSpoutBridgeReplay::load(string path, string bridgeName, int oscPort)
+{
+	stop();
+
+	if (!reader.Open(path.c_str()))
+	{
+		ofLogError() << "[ofxFFGLSpoutBridge] Error: could not read capture " << path;
+		return false;
+	}
+
+	// Same name as the plugin sender, so the bridge connects to it
+	senderName = bridgeName + "FromHost";
+
+	if (oscSocket == INVALID_SOCKET)
+	{
+		oscSocket = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	}
+	oscAddress.sin_family = AF_INET;
+	oscAddress.sin_port = htons((u_short)oscPort);
+	oscAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+	ofLogNotice() << "[ofxFFGLSpoutBridge] Loaded capture " << path;
+	return true;
+}
+
+void ofxFFGLSpoutBridgeReplay::start(bool maxSpeed)
+{
+	if (!reader.IsOpen())
+	{
+		return;
+	}
+
+	stop();
+
+	// Memoryshare for this sender only, other Spout applications keep their mode
+	spoutSender = new SpoutSender();
+	spoutSender->ForceMemoryShare(true);
+
+	reader.Rewind();
+	hasNext = readNext();
+
+	this->maxSpeed = maxSpeed;
+	framesSent = packetsSent = 0;
+	startTime = ofGetElapsedTimeMicros();
+	running = true;
+}
+
+void ofxFFGLSpoutBridgeReplay::stop()
+{
+	if (!running)
+	{
+		return;
+	}
+
+	elapsedMs = (ofGetElapsedTimeMicros() - startTime) / 1000.0f;
+	running = false;
+
+	releaseSender();
+	delete spoutSender;
+	spoutSender = NULL;
+
+	ofLogNotice() << "[ofxFFGLSpoutBridge] Replay: " << framesSent << " frames, " << packetsSent << " OSC packets in " << elapsedMs << " ms";
+}
+
+void ofxFFGLSpoutBridgeReplay::update()
+{
+	if (!running)
+	{
+		return;
+	}
+
+	if (!hasNext && loop)
+	{
+		reader.Rewind();
+		hasNext = readNext();
+		startTime = ofGetElapsedTimeMicros();
+	}
+
+	if (!hasNext)
+	{
+		stop();
+		return;
+	}
+
+	if (maxSpeed)
+	{
+		// Everything up to and including the next frame
+		bool frame = false;
+		while (hasNext && !frame)
+		{
+			frame = next.type == SPOUT_CAPTURE_FRAME;
+			play(next);
+			hasNext = readNext();
+		}
+	}
+	else
+	{
+		uint64_t now = ofGetElapsedTimeMicros() - startTime;
+		while (hasNext && next.time <= now)
+		{
+			play(next);
+			hasNext = readNext();
+		}
+	}
+}
+
+//******************************************************************
+// Playback
+//******************************************************************
+
+void ofxFFGLSpoutBridgeReplay::play(const spoutCaptureRecord& record)
+{
+	switch (record.type)
+	{
+	case SPOUT_CAPTURE_FRAME:
+		playFrame(record);
+		break;
+
+	case SPOUT_CAPTURE_SENDER:
+		// Receiver events are the client side, played by the app itself
+		if (record.event == SPOUT_SENDER_CREATED || record.event == SPOUT_SENDER_RESIZED)
+		{
+			resizeSender(record.width, record.height);
+		}
+		else if (record.event == SPOUT_SENDER_RELEASED)
+		{
+			releaseSender();
+		}
+		break;
+
+	case SPOUT_CAPTURE_OSC:
+		if (oscSocket != INVALID_SOCKET)
+		{
+			sendto(oscSocket, (const char*)record.data.data(), (int)record.data.size(), 0, (const sockaddr*)&oscAddress, sizeof(oscAddress));
+			packetsSent++;
+		}
+		break;
+	}
+}
+
+void ofxFFGLSpoutBridgeReplay::playFrame(const spoutCaptureRecord& record)
+{
+	resizeSender(record.width, record.height);
+	if (!senderCreated)
+	{
+		return;
+	}
+
+	const unsigned char* pixels = record.data.data();
+
+	if (record.data.empty())
+	{
+		// No pixels captured: a colour that changes with the content.
+		// Filled again only when the size or hash changes, which at the
+		// headers level (hash 0) is on a resize only
+		if (framePixels.empty() || record.width != framePixelsWidth || record.height != framePixelsHeight || record.hash != framePixelsHash)
+		{
+			framePixels.resize((size_t)record.width * record.height * 4);
+			unsigned char r = (unsigned char)(record.hash), g = (unsigned char)(record.hash >> 8), b = (unsigned char)(record.hash >> 16);
+			for (size_t i = 0; i < framePixels.size(); i += 4)
+			{
+				framePixels[i] = r;
+				framePixels[i + 1] = g;
+				framePixels[i + 2] = b;
+				framePixels[i + 3] = 255;
+			}
+			framePixelsWidth = record.width;
+			framePixelsHeight = record.height;
+			framePixelsHash = record.hash;
+		}
+		pixels = framePixels.data();
+	}
+
+	spoutSender->SendImage(pixels, record.width, record.height, GL_RGBA, false);
+	framesSent++;
+}
+
+void ofxFFGLSpoutBridgeReplay::resizeSender(unsigned int width, unsigned int height)
+{
+	if (senderCreated && width == senderWidth && height == senderHeight)
+	{
+		return;
+	}
+
+	if (!senderCreated)
+	{
+		senderCreated = spoutSender->CreateSender(senderName.c_str(), width, height);
+	}
+	else if (!spoutSender->UpdateSender(senderName.c_str(), width, height))
+	{
+		releaseSender();
+		return;
+	}
+
+	senderWidth = width;
+	senderHeight = height;
+}
+
+void ofxFFGLSpoutBridgeReplay::releaseSender()
+{
+	if (senderCreated)
+	{
+		spoutSender->ReleaseSender();
+		senderCreated = false;
+	}
+}
+
+bool ofxFFGLSpoutBridgeReplay::readNext()
+{
+	return reader.Read(next);
+}
@@ -0,0 +1,103 @@
+//******************************************************************
+/*
+Copyright (c) 2017, Davide Mani - software@cogitamus.it
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+* Neither the name of the developer nor the
+names of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA' "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL DAMIAN STEWART BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//******************************************************************
+
+#pragma once
+
+#include "ofMain.h"
+#include "Spout.h"
+#include "SpoutCapture.h"
+
+#include <winsock2.h>
+
+//******************************************************************
+// ofxFFGLSpoutBridgeReplay
+// Plays back a session captured by the plugin (SPOUTBRIDGE_CAPTURE)
+// in place of the host, to benchmark the client side without a
+// host or a GPU capable of texture sharing.
+//
+// Frames go through a memoryshare sender named like the plugin one,
+// with the recorded pixels or, for captures without pixels, a plain
+// colour derived from the frame hash. Sender events create, resize
+// and release that sender. OSC packets are sent unchanged to the
+// client port. Only the replay sender is in memoryshare, the bridge
+// receiving it is switched with ofxFFGLSpoutBridge::setMemoryShare.
+//
+// At original speed records are played at their captured times, at
+// maximum speed one frame is sent per update() with the records
+// before it.
+//******************************************************************
+
+class ofxFFGLSpoutBridgeReplay
+{
+public:
+	ofxFFGLSpoutBridgeReplay();
+	virtual ~ofxFFGLSpoutBridgeReplay();
+
+	// bridgeName as given to the bridge, oscPort the one the client listens to
+	bool load(string path, string bridgeName, int oscPort);
+
+	void start(bool maxSpeed = false);
+	void stop();
+	void update(); // from the thread owning the OpenGL context
+
+	bool isRunning() { return running; }
+	void setLoop(bool loop) { this->loop = loop; }
+
+	// Since start
+	unsigned int getFramesSent() { return framesSent; }
+	unsigned int getPacketsSent() { return packetsSent; }
+	float getElapsedMs() { return running ? (ofGetElapsedTimeMicros() - startTime) / 1000.0f : elapsedMs; }
+
+private:
+	void play(const spoutCaptureRecord& record);
+	void playFrame(const spoutCaptureRecord& record);
+	void resizeSender(unsigned int width, unsigned int height);
+	void releaseSender();
+	bool readNext();
+
+	spoutCaptureReader reader;
+	spoutCaptureRecord next;
+	bool hasNext;
+
+	string senderName;
+	SpoutSender* spoutSender;
+	bool senderCreated;
+	unsigned int senderWidth, senderHeight;
+	vector<unsigned char> framePixels; // plain colour frame, for captures without pixels
+	unsigned int framePixelsWidth, framePixelsHeight;
+	unsigned long long framePixelsHash; // the colour is taken from it
+
+	SOCKET oscSocket;
+	sockaddr_in oscAddress;
+
+	bool running, maxSpeed, loop;
+	uint64_t startTime; // microseconds, as record times
+	float elapsedMs;
+	unsigned int framesSent, packetsSent;
+};
@@ -0,0 +1,435 @@
+//******************************************************************
+/*
+Copyright (c) 2017, Davide Mani - software@cogitamus.it
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+* Neither the name of the developer nor the
+names of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA' "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL DAMIAN STEWART BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//******************************************************************
+
+#include "ofxFFGLSpoutBridgeWorker.h"
+#include "SpoutTrace.h"
+
+//******************************************************************
+// Names and flip flags as in ofxFFGLSpoutBridge::initialize
+//******************************************************************
+
+ofxFFGLSpoutBridgeWorker::ofxFFGLSpoutBridgeWorker(const char* sender, const char* receiver, bool flipReceive, bool flipSend, int format, bool memory)
+{
+	strcpy(senderName, sender);
+	strcpy(receiverName, receiver);
+	receiverConnection.SetSenderName(receiverName);
+	flipReceivedTexture = flipReceive;
+	flipTextureToSend = flipSend;
+	internalFormat = format;
+	memoryShare = memory;
+
+	dc = NULL;
+	context = NULL;
+
+	spoutSender = NULL;
+	spoutReceiver = NULL;
+	spoutSenderIsInitialized = spoutReceiverIsInitialized = false;
+	receiverWidth = receiverHeight = 0;
+	receiverFormat = senderFormat = 0;
+	clearFbo = 0;
+	hostPresent = true;
+
+	freeCount = 0;
+	readyCount = 0;
+	readyEvent = CreateEvent(NULL, FALSE, FALSE, NULL); // auto reset
+}
+
+ofxFFGLSpoutBridgeWorker::~ofxFFGLSpoutBridgeWorker()
+{
+	stop();
+
+	if (readyEvent != NULL)
+	{
+		CloseHandle(readyEvent);
+	}
+}
+
+//******************************************************************
+// The worker context is created on the draw thread, where the
+// window context is current, and made current on the worker thread.
+// It needs a compatibility profile window context, which is what
+// openFrameworks creates by default.
+//******************************************************************
+
+bool ofxFFGLSpoutBridgeWorker::start()
+{
+	HGLRC drawContext = wglGetCurrentContext();
+	dc = wglGetCurrentDC();
+
+	if (drawContext == NULL || dc == NULL)
+	{
+		ofLogError() << "[ofxFFGLSpoutBridge] Pipelined mode needs a current OpenGL context";
+		return false;
+	}
+
+	context = wglCreateContext(dc);
+	if (context == NULL)
+	{
+		ofLogError() << "[ofxFFGLSpoutBridge] Could not create the worker OpenGL context";
+		return false;
+	}
+
+	if (!wglShareLists(drawContext, context))
+	{
+		ofLogError() << "[ofxFFGLSpoutBridge] Could not share OpenGL objects with the worker context";
+		wglDeleteContext(context);
+		context = NULL;
+		return false;
+	}
+
+	startThread();
+	return true;
+}
+
+void ofxFFGLSpoutBridgeWorker::stop()
+{
+	if (isThreadRunning())
+	{
+		waitForThread(true);
+	}
+
+	if (context != NULL)
+	{
+		wglDeleteContext(context);
+		context = NULL;
+	}
+
+	// Fences of messages nobody will take anymore
+	Message message;
+	while (readyQueue.pop(message) || returnedQueue.pop(message))
+	{
+		if (message.fence != NULL)
+		{
+			glDeleteSync(message.fence);
+		}
+	}
+}
+
+//******************************************************************
+// Draw thread side
+//******************************************************************
+
+bool ofxFFGLSpoutBridgeWorker::popReady(Message& message)
+{
+	if (!readyQueue.pop(message))
+	{
+		return false;
+	}
+
+	if (message.type == FRAME_READY)
+	{
+		readyCount--;
+	}
+
+	return true;
+}
+
+bool ofxFFGLSpoutBridgeWorker::waitReady(DWORD timeoutMs)
+{
+	return readyEvent != NULL && WaitForSingleObject(readyEvent, timeoutMs) == WAIT_OBJECT_0;
+}
+
+//******************************************************************
+// Worker thread
+//******************************************************************
+
+void ofxFFGLSpoutBridgeWorker::threadedFunction()
+{
+	if (!wglMakeCurrent(dc, context))
+	{
+		ofLogError() << "[ofxFFGLSpoutBridge] Could not activate the worker OpenGL context";
+		return;
+	}
+
+	// Spout objects hold OpenGL objects of this context, they
+	// must be created and destroyed with it current
+	spoutSender = new SpoutSender;
+	spoutReceiver = new SpoutReceiver;
+	spoutReceiver->ForceMemoryShare(memoryShare);
+	glGenFramebuffers(1, &clearFbo);
+
+	while (isThreadRunning())
+	{
+		processReturned();
+
+		// Keep AHEAD frames ready, so that the draw thread usually
+		// finds one even when a receive is slow
+		if (freeCount > 0 && readyCount < AHEAD)
+		{
+			produceFrame(freeSlots[--freeCount]);
+		}
+		else
+		{
+			ofSleepMillis(1);
+		}
+	}
+
+	spoutReceiver->ReleaseReceiver();
+	spoutSender->ReleaseSender();
+	delete spoutReceiver;
+	delete spoutSender;
+	spoutReceiver = NULL;
+	spoutSender = NULL;
+	spoutSenderIsInitialized = spoutReceiverIsInitialized = false;
+
+	glDeleteFramebuffers(1, &clearFbo);
+	clearFbo = 0;
+
+	wglMakeCurrent(NULL, NULL);
+}
+
+//******************************************************************
+// Send the slots the draw thread finished with, they become free
+//******************************************************************
+
+void ofxFFGLSpoutBridgeWorker::processReturned()
+{
+	Message message;
+
+	while (returnedQueue.pop(message))
+	{
+		Slot& slot = slots[message.slot];
+		slot.textureID = message.textureID;
+		slot.width = message.width;
+		slot.height = message.height;
+		slot.format = message.format;
+
+		if (message.fence != NULL)
+		{
+			SPOUT_TRACE("ofxFFGLSpoutBridgeWorker::waitSync");
+
+			// Wait for the draw thread commands on this texture
+			glWaitSync(message.fence, 0, GL_TIMEOUT_IGNORED);
+			glDeleteSync(message.fence);
+		}
+
+		if (message.type == FRAME_SEND)
+		{
+			if (!spoutSenderIsInitialized)
+			{
+				DWORD localFormats = 0;
+				senderFormat = negotiateSenderFormat(spoutSender, spoutReceiver, receiverName, frameInternalFormat(internalFormat, slot.format), localFormats);
+				spoutSenderIsInitialized = spoutSender->CreateSender(senderName, slot.width, slot.height, senderFormat);
+				if (!spoutSenderIsInitialized)
+				{
+					ofLogError() << "[ofxFFGLSpoutBridge] Error: could not create Spout sender";
+				}
+				else
+				{
+					// Lets the host negotiate in turn
+					spoutSender->SetSenderFormats(localFormats);
+					ofLogNotice() << "[ofxFFGLSpoutBridge] Created new Spout sender (" << senderName << ") in "
+						<< spoutFormat::GetName(spoutFormat::FromDXGIFormat(senderFormat));
+				}
+			}
+
+			if (spoutSenderIsInitialized)
+			{
+				SPOUT_TRACE("ofxFFGLSpoutBridgeWorker::send");
+				spoutSender->SendTexture(slot.textureID, GL_TEXTURE_2D, slot.width, slot.height, flipTextureToSend);
+			}
+		}
+
+		freeSlots[freeCount++] = message.slot;
+	}
+}
+
+//******************************************************************
+// Fill a free slot with the next frame for the draw thread
+//******************************************************************
+
+void ofxFFGLSpoutBridgeWorker::produceFrame(int index)
+{
+	SPOUT_TRACE("ofxFFGLSpoutBridgeWorker::produceFrame");
+
+	Slot& slot = slots[index];
+
+	connect();
+
+	if (!spoutReceiverIsInitialized)
+	{
+		clearSlot(index);
+		post(index, FRAME_READY, slot.width, slot.height, slot.format);
+		return;
+	}
+
+	unsigned int width = receiverWidth, height = receiverHeight;
+
+	bool received = false;
+	if (width == slot.width && height == slot.height && receiverFormat == slot.format)
+	{
+		received = spoutReceiver->ReceiveTexture(receiverName, width, height, slot.textureID, GL_TEXTURE_2D, flipReceivedTexture, 0);
+	}
+	else
+	{
+		received = true; // size and format checked below
+	}
+
+	if (!received)
+	{
+		// The sender has closed
+		spoutReceiver->ReleaseReceiver();
+		spoutReceiverIsInitialized = false;
+		receiverConnection.Disconnected();
+
+		ofLogNotice() << "[ofxFFGLSpoutBridge] Release existing receiver (" << receiverName << ")";
+
+		clearSlot(index);
+		post(index, FRAME_READY, slot.width, slot.height, slot.format);
+		return;
+	}
+
+	// On a sender size or format change nothing was copied
+	receiverWidth = width;
+	receiverHeight = height;
+	receiverFormat = spoutReceiver->GetSenderFormat();
+
+	if (receiverWidth != slot.width || receiverHeight != slot.height || receiverFormat != slot.format)
+	{
+		post(index, FRAME_RESIZE, receiverWidth, receiverHeight, receiverFormat);
+		return;
+	}
+
+	post(index, FRAME_READY, slot.width, slot.height, slot.format);
+}
+
+//******************************************************************
+// Receiver connection, tried with a backoff until the host shows up
+//******************************************************************
+
+void ofxFFGLSpoutBridgeWorker::connect()
+{
+	if (spoutReceiverIsInitialized || !hostPresent || !receiverConnection.ShouldConnect())
+	{
+		return;
+	}
+
+	unsigned int width = 0, height = 0;
+
+	if (!spoutReceiver->CreateReceiver(receiverName, width, height, false))
+	{
+		receiverConnection.Failed();
+	}
+	else
+	{
+		receiverConnection.Connected();
+		receiverWidth = width;
+		receiverHeight = height;
+		receiverFormat = spoutReceiver->GetSenderFormat();
+		spoutReceiverIsInitialized = true;
+
+		ofLogNotice() << "[ofxFFGLSpoutBridge] Spout receiver initialized (" << receiverName << ") in "
+			<< spoutFormat::GetName(spoutFormat::FromDXGIFormat(receiverFormat));
+
+		// The sender format was chosen without the host, it is created
+		// again with the next frame sent if the host takes another one
+		DWORD localFormats = 0;
+		if (spoutSenderIsInitialized &&
+			negotiateSenderFormat(spoutSender, spoutReceiver, receiverName, frameInternalFormat(internalFormat, receiverFormat), localFormats) != senderFormat)
+		{
+			spoutSender->ReleaseSender();
+			spoutSenderIsInitialized = false;
+		}
+	}
+}
+
+//******************************************************************
+// Helpers
+//******************************************************************
+
+void ofxFFGLSpoutBridgeWorker::clearSlot(int index)
+{
+	glBindFramebuffer(GL_FRAMEBUFFER, clearFbo);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, slots[index].textureID, 0);
+	glClearColor(0, 0, 0, 0);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, 0, 0);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void ofxFFGLSpoutBridgeWorker::post(int slot, MessageType type, unsigned int width, unsigned int height, DWORD format)
+{
+	Message message;
+	message.slot = slot;
+	message.type = type;
+	message.textureID = slots[slot].textureID;
+	message.width = width;
+	message.height = height;
+	message.format = format;
+	message.fence = NULL;
+
+	if (type == FRAME_READY)
+	{
+		// Commands must reach the GPU before the draw thread waits on them
+		message.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		glFlush();
+		readyCount++;
+	}
+
+	readyQueue.push(message); // can't be full, there are fewer slots than entries
+
+	if (readyEvent != NULL)
+	{
+		SetEvent(readyEvent);
+	}
+}
+
+//******************************************************************
+// Pixel formats, see SpoutFormat.h. Frames stay in 8 bit GL_RGBA
+// unless the host sends more precision or the app asks for it.
+// The sender takes the cheapest format the host accepts that keeps
+// the precision of the frames, 8 bit BGRA needs no swizzle.
+//******************************************************************
+
+int ofxFFGLSpoutBridgeWorker::frameInternalFormat(int internalFormat, DWORD hostFormat)
+{
+	if (internalFormat != 0)
+	{
+		return internalFormat;
+	}
+
+	DWORD format = spoutFormat::FromDXGIFormat(hostFormat);
+	return spoutFormat::GetBitsPerChannel(format) > 8 ? (int)spoutFormat::GetGLInternalFormat(format) : GL_RGBA;
+}
+
+DWORD ofxFFGLSpoutBridgeWorker::negotiateSenderFormat(SpoutSender* sender, SpoutReceiver* receiver, const char* hostSenderName, int internalFormat, DWORD& localFormats)
+{
+	// GetShareMode reads the registry, only done when a sender is created
+	localFormats = spoutFormat::GetSupportedFormats(sender->GetShareMode(), sender->GetDX9());
+
+	// None while the host is away
+	DWORD hostFormats = 0;
+	if (!receiver->GetSenderFormats(hostSenderName, hostFormats))
+	{
+		hostFormats = 0;
+	}
+
+	DWORD format = spoutFormat::Negotiate(localFormats, hostFormats, spoutFormat::FromGLInternalFormat(internalFormat));
+	return spoutFormat::GetDXGIFormat(format);
+}
@@ -0,0 +1,153 @@
+//******************************************************************
+/*
+Copyright (c) 2017, Davide Mani - software@cogitamus.it
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+* Redistributions of source code must retain the above copyright
+notice, this list of conditions and the following disclaimer.
+* Redistributions in binary form must reproduce the above copyright
+notice, this list of conditions and the following disclaimer in the
+documentation and/or other materials provided with the distribution.
+* Neither the name of the developer nor the
+names of its contributors may be used to endorse or promote products
+derived from this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY DAVIDE MANIA' "AS IS" AND ANY
+EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL DAMIAN STEWART BE LIABLE FOR ANY
+DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+(INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+//******************************************************************
+
+#pragma once
+
+#include "ofMain.h"
+#include "Spout.h"
+#include "SpoutConnectionState.h"
+#include "SpoutFormat.h"
+#include "ofxFFGLSpoutBridgeQueue.h"
+
+//******************************************************************
+// ofxFFGLSpoutBridgeWorker
+// Spout receiver and sender of a pipelined ofxFFGLSpoutBridge.
+//
+// Runs on its own thread with an OpenGL context sharing objects with
+// the draw thread. Frames travel as slots, textures allocated by the
+// draw thread:
+//
+//  worker  --- FRAME_READY / FRAME_RESIZE --->  draw thread
+//  worker  <-- FRAME_SEND / FRAME_RETURN -----  draw thread
+//
+// A returned slot is sent if asked to, then filled with the next frame
+// from the host (or cleared while the host is not connected) and posted
+// back. A slot not matching the host frame size or pixel format is
+// posted back with FRAME_RESIZE for the draw thread to reallocate it.
+// Each message carries a fence the receiving side waits on before
+// using the texture.
+//
+// The worker keeps AHEAD frames ready. The draw thread draws the newest
+// and, when the worker is held up in Spout, draws the last frame again
+// instead of waiting for it.
+//******************************************************************
+
+class ofxFFGLSpoutBridgeWorker : public ofThread
+{
+public:
+	enum { SLOTS = 4, AHEAD = 2 };
+
+	enum MessageType
+	{
+		FRAME_READY,	// slot holds a new frame
+		FRAME_RESIZE,	// slot must be reallocated at width x height in format
+		FRAME_SEND,		// slot must be sent, then reused
+		FRAME_RETURN	// slot can be reused
+	};
+
+	struct Message
+	{
+		int slot;
+		MessageType type;
+		GLuint textureID;
+		unsigned int width, height;
+		DWORD format; // DXGI format of the host frames the slot is for
+		GLsync fence;
+	};
+
+	// internalFormat: of the frames sent back, 0 to follow the host
+	// memoryShare: receive by memoryshare, see ofxFFGLSpoutBridge::setMemoryShare
+	ofxFFGLSpoutBridgeWorker(const char* senderName, const char* receiverName, bool flipReceive, bool flipSend, int internalFormat = 0, bool memoryShare = false);
+	virtual ~ofxFFGLSpoutBridgeWorker();
+
+	// Create a context sharing objects with the current one and start
+	// the thread. Call from the draw thread.
+	bool start();
+
+	// Stop the thread and destroy its context. Call from the draw thread.
+	void stop();
+
+	// Draw thread side of the queues
+	bool popReady(Message& message);
+	bool waitReady(DWORD timeoutMs); // blocks until a message is posted
+	bool pushReturned(const Message& message) { return returnedQueue.push(message); }
+
+	// false while a hub knows there is no host sender, no connection is tried
+	void setHostPresent(bool present) { hostPresent = present; }
+
+	// Pixel formats, shared with the synchronous bridge. The OpenGL
+	// format of the frames for the requested one (0 follows the host
+	// format), and the sender format negotiated with the host.
+	static int frameInternalFormat(int internalFormat, DWORD hostFormat);
+	static DWORD negotiateSenderFormat(SpoutSender* sender, SpoutReceiver* receiver, const char* hostSenderName, int internalFormat, DWORD& localFormats);
+
+protected:
+	void threadedFunction();
+
+private:
+	void processReturned();
+	void produceFrame(int slot);
+	void connect();
+	void clearSlot(int slot);
+	void post(int slot, MessageType type, unsigned int width, unsigned int height, DWORD format);
+
+	char senderName[256];
+	char receiverName[256];
+	bool flipReceivedTexture, flipTextureToSend;
+	int internalFormat;
+	bool memoryShare;
+
+	HDC dc;
+	HGLRC context;
+
+	// Owned by the worker thread
+	SpoutSender* spoutSender;
+	SpoutReceiver* spoutReceiver;
+	bool spoutSenderIsInitialized, spoutReceiverIsInitialized;
+	spoutConnectionState receiverConnection;
+	std::atomic<bool> hostPresent; // set by the draw thread
+	unsigned int receiverWidth, receiverHeight;
+	DWORD receiverFormat, senderFormat;
+	GLuint clearFbo;
+
+	struct Slot
+	{
+		GLuint textureID;
+		unsigned int width, height;
+		DWORD format;
+	};
+	Slot slots[SLOTS];
+	int freeSlots[SLOTS];
+	int freeCount;
+
+	ofxFFGLSpoutBridgeQueue<Message, 8> readyQueue;		// worker -> draw thread
+	ofxFFGLSpoutBridgeQueue<Message, 8> returnedQueue;	// draw thread -> worker
+	std::atomic<int> readyCount; // frames posted and not popped yet
+	HANDLE readyEvent; // set on every post
+};